@@ -1,6 +1,9 @@
 #include "../proto/trade.h"
+#include "encodedSizePredictor.h"
+#include "tradeVerifier.h"
 
 #include <iostream>
+#include <memory_resource>
 
 int main(int argc, char** argv)
 {
@@ -11,15 +14,27 @@ int main(int argc, char** argv)
     account.Orders.emplace_back(TradeProto::Order(3, "EURUSD", TradeProto::OrderSide::BUY, TradeProto::OrderType::STOP, 1.5, 10));
 
     // Serialize the account to the FlatBuffer stream
-    flatbuffers::FlatBufferBuilder builder;
+    // (the builder starts at the predicted capacity, so it never has to grow)
+    auto predicted = TradeProto::PredictFlatBufferSize(account);
+    flatbuffers::FlatBufferBuilder builder(predicted.capacity);
     builder.Finish(account.Serialize(builder));
 
     // Show original and FlatBuffer serialized sizes
     std::cout << "Original size: " << account.size() << std::endl;
     std::cout << "FlatBuffer size: " << builder.GetSize() << std::endl;
 
+    // Verify the FlatBuffer stream before touching it, as bytes off the wire would need
+    auto error = TradeProto::VerifyAccountBuffer(builder.GetBufferPointer(), builder.GetSize());
+    if (error != TradeProto::VerifyError::None)
+    {
+        std::cerr << "Invalid FlatBuffer: " << TradeProto::VerifyErrorName(error) << std::endl;
+        return 1;
+    }
+
     // Deserialize the account from the FlatBuffer stream
-    TradeProto::Account deserialized;
+    // (the pool backs Name and Orders, re-decoding into the same account reuses their capacity)
+    std::pmr::unsynchronized_pool_resource pool;
+    TradeProto::Account deserialized(&pool);
     deserialized.Deserialize(*Trade::flatbuf::GetAccount(builder.GetBufferPointer()));
 
     // Show account content
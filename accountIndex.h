@@ -0,0 +1,340 @@
+#ifndef ACCOUNT_INDEX_H
+#define ACCOUNT_INDEX_H
+
+/* Sidecar indexes over an Account record archive (recordFile.h), so a point lookup reads
+only the records it needs instead of decoding the whole file.
+
+BuildAccountIndex() scans the archive once and writes one index file holding
+- every account id with the offset of its record, sorted by id (a binary search on an
+  mmapped array: no hashing, no load step, duplicates kept in file order);
+- per order symbol, a posting list of the offsets of the records that have an order in it,
+  ascending, with the symbols themselves sorted.
+FlatBuffer records are read in place (after verification); protobuf and protobuf-c records
+share one wire layout and are scanned for just the id and order symbols without being parsed.
+
+    IndexHeader
+    IdEntry[id_count]          { int32 id, uint32 0, uint64 record offset }
+    SymbolEntry[symbol_count]  { char symbol[16], uint64 first posting, uint64 posting count }
+    uint64 postings[posting_count]
+
+AccountIndex maps that file and answers lookups with RecordRefs pointing into the mapped
+archive, so callers read the matching FlatBuffers with zero copies. The index remembers the
+archive's size, inode and modification time and refuses to open against a file that differs in
+any of them, so an archive rewritten in place or replaced is caught without rereading it.
+FlatBuffer records are verified again before they are read, in case the check still misses a
+change. Call archive.AdviseRandom() when the mapping serves mostly lookups. Symbols are compared
+on their first 15 bytes; longer symbols can produce extra candidates, never missed ones. */
+
+#include "../proto/trade.h"
+#include "recordFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TradeProto {
+
+namespace AccountIndexFormat {
+    constexpr uint32_t kMagic = 0x58494341;  // "ACIX"
+    constexpr uint32_t kVersion = 2;
+    constexpr size_t kSymbolBytes = 16;
+
+    struct IndexHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t archive_size;
+        uint64_t archive_inode;
+        uint64_t archive_mtime_ns;
+        uint64_t id_count;
+        uint64_t symbol_count;
+        uint64_t posting_count;
+    };
+
+    struct IdEntry {
+        int32_t id;
+        uint32_t reserved;
+        uint64_t offset;
+    };
+
+    struct SymbolEntry {
+        char symbol[kSymbolBytes];  // NUL padded
+        uint64_t first;
+        uint64_t count;
+    };
+
+    static_assert(sizeof(IndexHeader) == 56 && sizeof(IdEntry) == 16 && sizeof(SymbolEntry) == 32, "index layout is part of the file format");
+
+    inline void SymbolKey(const char* symbol, size_t length, char (&key)[kSymbolBytes]) {
+        std::memset(key, 0, kSymbolBytes);
+        std::memcpy(key, symbol, std::min(length, kSymbolBytes - 1));
+    }
+}
+
+// Reads the id and order symbols of a protobuf / protobuf-c Account without parsing it.
+// on_symbol(const char*, size_t) is called once per order. False on malformed input
+template <typename F>
+bool ScanAccountWire(const uint8_t* p, size_t size, int32_t& id, F&& on_symbol) {
+    struct Reader {
+        const uint8_t* p;
+        const uint8_t* end;
+        bool Varint(uint64_t& v) {
+            v = 0;
+            for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+                uint8_t b = *p++;
+                v |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) return true;
+            }
+            return false;
+        }
+        // Skips a field of the given wire type; returns the payload of length-delimited ones
+        bool Skip(uint32_t wire_type, const uint8_t*& data, size_t& length) {
+            uint64_t v;
+            switch (wire_type) {
+            case 0: return Varint(v);
+            case 1: if (end - p < 8) return false; p += 8; return true;
+            case 5: if (end - p < 4) return false; p += 4; return true;
+            case 2:
+                if (!Varint(v) || v > static_cast<uint64_t>(end - p)) return false;
+                data = p;
+                length = static_cast<size_t>(v);
+                p += v;
+                return true;
+            default: return false;
+            }
+        }
+    };
+
+    id = 0;
+    Reader account{ p, p + size };
+    while (account.p < account.end) {
+        uint64_t key;
+        if (!account.Varint(key)) return false;
+        uint32_t field = static_cast<uint32_t>(key >> 3), wire_type = static_cast<uint32_t>(key & 7);
+        if (field == 1 && wire_type == 0) {
+            uint64_t v;
+            if (!account.Varint(v)) return false;
+            id = static_cast<int32_t>(v);
+            continue;
+        }
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+        if (!account.Skip(wire_type, data, length)) return false;
+        if (field != 4 || wire_type != 2) continue;
+        Reader order{ data, data + length };  // Order: only symbol (2) is needed
+        while (order.p < order.end) {
+            if (!order.Varint(key)) return false;
+            const uint8_t* s = nullptr;
+            size_t n = 0;
+            if (!order.Skip(static_cast<uint32_t>(key & 7), s, n)) return false;
+            if ((key >> 3) == 2 && (key & 7) == 2) on_symbol(reinterpret_cast<const char*>(s), n);
+        }
+    }
+    return true;
+}
+
+// Scans archive_path once and writes the index to index_path (atomically, via rename).
+// Records that fail verification or scanning are left out of the index
+inline void BuildAccountIndex(const std::string& archive_path, const std::string& index_path) {
+    using namespace AccountIndexFormat;
+    MappedRecordFile archive(archive_path);
+
+    std::vector<IdEntry> ids;
+    std::map<std::string, std::vector<uint64_t>> postings;  // sorted symbols for free
+    std::vector<std::string> symbols;                       // of the current record
+
+    ForEachRecord(archive.data(), archive.size(), [&](const RecordRef& record) {
+        int32_t id = 0;
+        symbols.clear();
+        auto add_symbol = [&](const char* s, size_t n) {
+            char key[kSymbolBytes];
+            SymbolKey(s, n, key);
+            symbols.emplace_back(key, std::strlen(key));
+        };
+        if (record.format == RecordFormat::FlatBuffer) {
+            flatbuffers::Verifier verifier(record.data, record.size);
+            if (!Trade::flatbuf::VerifyAccountBuffer(verifier)) return;
+            const Trade::flatbuf::Account* account = Trade::flatbuf::GetAccount(record.data);
+            id = account->id();
+            if (auto* orders = account->orders())
+                for (flatbuffers::uoffset_t i = 0; i < orders->size(); ++i)
+                    if (auto* symbol = orders->Get(i)->symbol()) add_symbol(symbol->c_str(), symbol->size());
+        } else if (!ScanAccountWire(record.data, record.size, id, add_symbol)) {
+            return;
+        }
+        ids.push_back({ id, 0, record.offset });
+        std::sort(symbols.begin(), symbols.end());
+        symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+        for (const std::string& s : symbols) postings[s].push_back(record.offset);  // offsets arrive ascending
+    });
+
+    std::stable_sort(ids.begin(), ids.end(), [](const IdEntry& a, const IdEntry& b) { return a.id < b.id; });
+
+    std::vector<SymbolEntry> entries;
+    std::vector<uint64_t> all_postings;
+    entries.reserve(postings.size());
+    for (const auto& p : postings) {
+        SymbolEntry e;
+        SymbolKey(p.first.data(), p.first.size(), e.symbol);
+        e.first = all_postings.size();
+        e.count = p.second.size();
+        all_postings.insert(all_postings.end(), p.second.begin(), p.second.end());
+        entries.push_back(e);
+    }
+
+    IndexHeader header{ kMagic, kVersion, archive.size(), archive.inode(), archive.mtime_ns(), ids.size(), entries.size(), all_postings.size() };
+    std::string temp_path = index_path + ".tmp." + std::to_string(::getpid());
+    FILE* out = std::fopen(temp_path.c_str(), "wb");
+    if (!out) throw std::runtime_error("Cannot create index file: " + temp_path);
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              std::fwrite(ids.data(), sizeof(IdEntry), ids.size(), out) == ids.size() &&
+              std::fwrite(entries.data(), sizeof(SymbolEntry), entries.size(), out) == entries.size() &&
+              std::fwrite(all_postings.data(), sizeof(uint64_t), all_postings.size(), out) == all_postings.size();
+    ok = std::fflush(out) == 0 && ::fsync(::fileno(out)) == 0 && ok;
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok || std::rename(temp_path.c_str(), index_path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Cannot write index file: " + index_path);
+    }
+}
+
+// Mapped index plus the archive it describes
+class AccountIndex {
+public:
+    AccountIndex(const std::string& index_path, const MappedRecordFile& archive) : archive_(archive) {
+        using namespace AccountIndexFormat;
+        int fd = ::open(index_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("Cannot open index file: " + index_path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(IndexHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Not an account index: " + index_path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot map index file: " + index_path);
+        data_ = static_cast<const uint8_t*>(p);
+
+        std::memcpy(&header_, data_, sizeof(header_));
+        size_t expected = sizeof(IndexHeader) + header_.id_count * sizeof(IdEntry) + header_.symbol_count * sizeof(SymbolEntry) +
+                          header_.posting_count * sizeof(uint64_t);
+        if (header_.magic != kMagic || header_.version != kVersion || expected != size_) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+            throw std::runtime_error("Not an account index: " + index_path);
+        }
+        if (header_.archive_size != archive_.size() || header_.archive_inode != archive_.inode() ||
+            header_.archive_mtime_ns != archive_.mtime_ns()) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+            throw std::runtime_error("Index " + index_path + " does not match the archive");
+        }
+        ids_ = reinterpret_cast<const IdEntry*>(data_ + sizeof(IndexHeader));
+        symbols_ = reinterpret_cast<const SymbolEntry*>(ids_ + header_.id_count);
+        postings_ = reinterpret_cast<const uint64_t*>(symbols_ + header_.symbol_count);
+    }
+
+    ~AccountIndex() { ::munmap(const_cast<uint8_t*>(data_), size_); }
+
+    AccountIndex(const AccountIndex&) = delete;
+    AccountIndex& operator=(const AccountIndex&) = delete;
+
+    size_t account_count() const { return static_cast<size_t>(header_.id_count); }
+    size_t symbol_count() const { return static_cast<size_t>(header_.symbol_count); }
+
+    // First record of the account, false if the id is not in the archive
+    bool FindAccount(int32_t id, RecordRef& record) const {
+        const IdEntry* end = ids_ + header_.id_count;
+        const IdEntry* it = std::lower_bound(ids_, end, id, [](const IdEntry& e, int32_t v) { return e.id < v; });
+        return it != end && it->id == id && ReadRecordAt(archive_.data(), archive_.size(), it->offset, record);
+    }
+
+    // Every record of the account (an archive can hold several versions), in file order
+    template <typename F>
+    size_t ForEachAccountRecord(int32_t id, F&& fn) const {
+        const IdEntry* end = ids_ + header_.id_count;
+        auto range = std::equal_range(ids_, end, IdEntry{ id, 0, 0 }, [](const IdEntry& a, const IdEntry& b) { return a.id < b.id; });
+        size_t n = 0;
+        RecordRef record;
+        for (const IdEntry* it = range.first; it != range.second; ++it)
+            if (ReadRecordAt(archive_.data(), archive_.size(), it->offset, record)) {
+                fn(record);
+                ++n;
+            }
+        return n;
+    }
+
+    // Every record with at least one order in symbol, in file order
+    template <typename F>
+    size_t ForEachRecordWithSymbol(const std::string& symbol, F&& fn) const {
+        const SymbolEntry* entry = FindSymbol(symbol);
+        if (!entry) return 0;
+        RecordRef record;
+        size_t n = 0;
+        for (uint64_t i = 0; i < entry->count; ++i)
+            if (ReadRecordAt(archive_.data(), archive_.size(), postings_[entry->first + i], record)) {
+                fn(record);
+                ++n;
+            }
+        return n;
+    }
+
+    // The orders in symbol, read in place from FlatBuffer records (other formats are skipped):
+    // fn(const Trade::flatbuf::Account&, const Trade::flatbuf::Order&)
+    template <typename F>
+    size_t ForEachFlatBufferOrder(const std::string& symbol, F&& fn) const {
+        size_t n = 0;
+        ForEachRecordWithSymbol(symbol, [&](const RecordRef& record) {
+            if (record.format != RecordFormat::FlatBuffer) return;
+            flatbuffers::Verifier verifier(record.data, record.size);
+            if (!Trade::flatbuf::VerifyAccountBuffer(verifier)) return;
+            const Trade::flatbuf::Account* account = Trade::flatbuf::GetAccount(record.data);
+            auto* orders = account->orders();
+            if (!orders) return;
+            for (flatbuffers::uoffset_t i = 0; i < orders->size(); ++i) {
+                const Trade::flatbuf::Order* order = orders->Get(i);
+                if (order->symbol() && order->symbol()->size() == symbol.size() &&
+                    std::memcmp(order->symbol()->c_str(), symbol.data(), symbol.size()) == 0) {
+                    fn(*account, *order);
+                    ++n;
+                }
+            }
+        });
+        return n;
+    }
+
+private:
+    using IdEntry = AccountIndexFormat::IdEntry;
+    using SymbolEntry = AccountIndexFormat::SymbolEntry;
+
+    const MappedRecordFile& archive_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    AccountIndexFormat::IndexHeader header_;
+    const IdEntry* ids_ = nullptr;
+    const SymbolEntry* symbols_ = nullptr;
+    const uint64_t* postings_ = nullptr;
+
+    const SymbolEntry* FindSymbol(const std::string& symbol) const {
+        char key[AccountIndexFormat::kSymbolBytes];
+        AccountIndexFormat::SymbolKey(symbol.data(), symbol.size(), key);
+        const SymbolEntry* end = symbols_ + header_.symbol_count;
+        const SymbolEntry* it = std::lower_bound(symbols_, end, key, [](const SymbolEntry& e, const char* k) {
+            return std::memcmp(e.symbol, k, AccountIndexFormat::kSymbolBytes) < 0;
+        });
+        return it != end && std::memcmp(it->symbol, key, AccountIndexFormat::kSymbolBytes) == 0 ? it : nullptr;
+    }
+};
+
+} // namespace TradeProto
+
+#endif // ACCOUNT_INDEX_H
@@ -0,0 +1,531 @@
+#ifndef ACCOUNT_VERSION_STORE_H
+#define ACCOUNT_VERSION_STORE_H
+
+/* In-memory history of TradeProto::Account versions with structural sharing.
+
+Orders are kept in an OrderRope: a persistent B+tree over positions whose leaves hold up to 32
+orders and whose inner nodes hold up to 32 children with their subtree sizes. Every update
+copies only the path from the root to the touched leaf (a leaf plus ~log32(n) small inner
+nodes) and returns a new rope; all other nodes are shared with the previous version through
+shared_ptr. A day of versions therefore costs one full snapshot plus the changed leaves;
+accountVersionStoreExample.cpp measures it against full copies.
+
+AccountVersionStore keeps, per account id, the snapshots in version order:
+- Begin(id) + Edit + Commit(edit, version) is the O(changed) path for streams of order events;
+- Commit(account, version) takes a whole TradeProto::Account (what replay feeds today) and
+  reuses every leaf whose orders are unchanged, even if inserts or erases moved them, so only
+  the leaves around the changes are new;
+- At(id, version) returns the snapshot valid at that version (binary search), Latest(id) the
+  newest one. Snapshots are cheap immutable handles, safe to read from any thread.
+Snapshot::Serialize() writes Trade::flatbuf::Account straight from the shared leaves, so no
+full Orders vector is materialized. The store itself is single-writer. */
+
+#include "../proto/trade.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace TradeProto {
+
+inline bool SameOrder(const Order& a, const Order& b) {
+    return a.Id == b.Id && a.Side == b.Side && a.Type == b.Type && a.Price == b.Price && a.Volume == b.Volume &&
+           std::strncmp(a.Symbol, b.Symbol, sizeof(a.Symbol)) == 0;
+}
+
+class OrderRope {
+public:
+    static constexpr size_t kBranch = 32;
+
+    struct Node {
+        uint32_t count = 0;      // orders in this subtree
+        uint32_t n = 0;          // orders (leaf) or children (inner) used
+        bool leaf = true;
+    };
+
+    struct Leaf : Node {
+        Order orders[kBranch];
+    };
+
+    struct Inner : Node {
+        uint32_t counts[kBranch] = {};
+        std::shared_ptr<const Node> children[kBranch];
+        Inner() { leaf = false; }
+    };
+
+    using NodePtr = std::shared_ptr<const Node>;
+
+    OrderRope() = default;
+
+    size_t size() const { return root_ ? root_->count : 0; }
+    bool empty() const { return size() == 0; }
+
+    const Order& operator[](size_t index) const {
+        const Node* node = root_.get();
+        while (!node->leaf) {
+            auto inner = static_cast<const Inner*>(node);
+            size_t k = Locate(*inner, index);
+            node = inner->children[k].get();
+        }
+        return static_cast<const Leaf*>(node)->orders[index];
+    }
+
+    const Order& at(size_t index) const {
+        if (index >= size()) throw std::out_of_range("OrderRope index out of range");
+        return (*this)[index];
+    }
+
+    OrderRope Set(size_t index, const Order& order) const {
+        if (index >= size()) throw std::out_of_range("OrderRope index out of range");
+        return OrderRope(SetAt(*root_, index, order));
+    }
+
+    OrderRope Insert(size_t index, const Order& order) const {
+        if (index > size()) throw std::out_of_range("OrderRope index out of range");
+        if (!root_) {
+            auto leaf = std::make_shared<Leaf>();
+            leaf->orders[0] = order;
+            leaf->n = leaf->count = 1;
+            return OrderRope(std::move(leaf));
+        }
+        Split split = InsertAt(*root_, index, order);
+        if (!split.right) return OrderRope(std::move(split.left));
+        auto root = std::make_shared<Inner>();                 // the root split: one level more
+        Append(*root, std::move(split.left));
+        Append(*root, std::move(split.right));
+        return OrderRope(std::move(root));
+    }
+
+    OrderRope PushBack(const Order& order) const { return Insert(size(), order); }
+
+    OrderRope Erase(size_t index) const {
+        if (index >= size()) throw std::out_of_range("OrderRope index out of range");
+        NodePtr root = EraseAt(*root_, index);
+        while (root && !root->leaf && root->n == 1)            // drop levels with a single child
+            root = static_cast<const Inner*>(root.get())->children[0];
+        return OrderRope(std::move(root));
+    }
+
+    // A rope holding exactly orders[0, size). Every leaf of this rope whose orders appear
+    // unchanged and contiguous in the new array is reused wherever it now starts (leaves are
+    // found by the id of their first order), so replacing a whole account costs only the leaves
+    // around the orders that changed. Falls back to a packed rebuild when reuse would leave the
+    // rope more than twice as fragmented as a fresh one.
+    OrderRope Assign(const Order* orders, size_t size) const {
+        if (size == this->size()) {
+            size_t same = 0;
+            ForEachLeaf([&](const Order* leaf, size_t count) {
+                for (size_t i = 0; i < count && same < size && SameOrder(leaf[i], orders[same]); ++i) ++same;
+            });
+            if (same == size) return *this;
+        }
+
+        std::vector<const NodePtr*> leaves;
+        CollectLeaves(leaves);
+        std::unordered_map<int, const NodePtr*> by_first_id;
+        by_first_id.reserve(leaves.size());
+        for (const NodePtr* leaf : leaves) by_first_id.emplace(static_cast<const Leaf&>(**leaf).orders[0].Id, leaf);
+
+        std::vector<NodePtr> result;
+        size_t fresh = 0;                                         // start of orders not covered yet
+        auto flush = [&](size_t end) {
+            for (size_t i = fresh; i < end; i += kBranch)
+                result.push_back(MakeLeaf(orders + i, std::min(kBranch, end - i)));
+        };
+        for (size_t j = 0; j < size;) {
+            auto it = by_first_id.find(orders[j].Id);
+            const Leaf* leaf = it == by_first_id.end() ? nullptr : static_cast<const Leaf*>(it->second->get());
+            bool match = leaf && j + leaf->n <= size;
+            for (size_t i = 0; match && i < leaf->n; ++i) match = SameOrder(leaf->orders[i], orders[j + i]);
+            if (!match) {
+                ++j;
+                continue;
+            }
+            flush(j);
+            result.push_back(*it->second);
+            j += leaf->n;
+            fresh = j;
+        }
+        flush(size);
+
+        if (result.size() > 2 * ((size + kBranch - 1) / kBranch) + 2) {   // too many small leaves
+            result.clear();
+            fresh = 0;
+            flush(size);
+        }
+        return FromLeaves(std::move(result));
+    }
+
+    static OrderRope Build(const Order* orders, size_t size) { return OrderRope().Assign(orders, size); }
+
+    // f(const Order*, size_t count) for each leaf, in order
+    template <typename F>
+    void ForEachLeaf(F&& f) const {
+        if (root_) VisitLeaves(*root_, f);
+    }
+
+    template <typename F>
+    void ForEach(F&& f) const {
+        ForEachLeaf([&](const Order* orders, size_t count) {
+            for (size_t i = 0; i < count; ++i) f(orders[i]);
+        });
+    }
+
+    // f(const Node*) for every node, for memory accounting
+    template <typename F>
+    void ForEachNode(F&& f) const {
+        if (root_) VisitNodes(*root_, f);
+    }
+
+private:
+    NodePtr root_;
+
+    explicit OrderRope(NodePtr root) : root_(std::move(root)) {}
+
+    struct Split {
+        NodePtr left;
+        NodePtr right;    // set when the node had to split
+    };
+
+    // Child holding position index, which is rebased into that child
+    static size_t Locate(const Inner& inner, size_t& index) {
+        size_t k = 0;
+        while (k + 1 < inner.n && index >= inner.counts[k]) index -= inner.counts[k++];
+        return k;
+    }
+
+    static void Append(Inner& inner, NodePtr child) {
+        inner.counts[inner.n] = child->count;
+        inner.count += child->count;
+        inner.children[inner.n++] = std::move(child);
+    }
+
+    static NodePtr MakeLeaf(const Order* orders, size_t count) {
+        auto leaf = std::make_shared<Leaf>();
+        std::copy(orders, orders + count, leaf->orders);
+        leaf->n = leaf->count = static_cast<uint32_t>(count);
+        return leaf;
+    }
+
+    static NodePtr SetAt(const Node& node, size_t index, const Order& order) {
+        if (node.leaf) {
+            auto copy = std::make_shared<Leaf>(static_cast<const Leaf&>(node));
+            copy->orders[index] = order;
+            return copy;
+        }
+        auto copy = std::make_shared<Inner>(static_cast<const Inner&>(node));
+        size_t k = Locate(*copy, index);
+        copy->children[k] = SetAt(*copy->children[k], index, order);
+        return copy;
+    }
+
+    static Split InsertAt(const Node& node, size_t index, const Order& order) {
+        if (node.leaf) {
+            auto& leaf = static_cast<const Leaf&>(node);
+            Order merged[kBranch + 1];
+            std::copy(leaf.orders, leaf.orders + index, merged);
+            merged[index] = order;
+            std::copy(leaf.orders + index, leaf.orders + leaf.n, merged + index + 1);
+            size_t total = leaf.n + 1;
+            if (total <= kBranch) return { MakeLeaf(merged, total), nullptr };
+            return { MakeLeaf(merged, total / 2), MakeLeaf(merged + total / 2, total - total / 2) };
+        }
+        auto& inner = static_cast<const Inner&>(node);
+        size_t k = 0;
+        while (k + 1 < inner.n && index > inner.counts[k]) index -= inner.counts[k++];  // appends go left
+        Split child = InsertAt(*inner.children[k], index, order);
+
+        NodePtr children[kBranch + 1];
+        size_t total = 0;
+        for (size_t i = 0; i < inner.n; ++i) {
+            if (i != k) {
+                children[total++] = inner.children[i];
+                continue;
+            }
+            children[total++] = std::move(child.left);
+            if (child.right) children[total++] = std::move(child.right);
+        }
+        if (total <= kBranch) return { MakeInner(children, total), nullptr };
+        return { MakeInner(children, total / 2), MakeInner(children + total / 2, total - total / 2) };
+    }
+
+    static NodePtr MakeInner(NodePtr* children, size_t count) {
+        auto inner = std::make_shared<Inner>();
+        for (size_t i = 0; i < count; ++i) Append(*inner, std::move(children[i]));
+        return inner;
+    }
+
+    // nullptr when the subtree became empty. Small leaves are merged with a neighbour.
+    static NodePtr EraseAt(const Node& node, size_t index) {
+        if (node.leaf) {
+            auto& leaf = static_cast<const Leaf&>(node);
+            if (leaf.n == 1) return nullptr;
+            auto copy = std::make_shared<Leaf>();
+            std::copy(leaf.orders, leaf.orders + index, copy->orders);
+            std::copy(leaf.orders + index + 1, leaf.orders + leaf.n, copy->orders + index);
+            copy->n = copy->count = leaf.n - 1;
+            return copy;
+        }
+        auto& inner = static_cast<const Inner&>(node);
+        size_t k = Locate(inner, index);
+        NodePtr child = EraseAt(*inner.children[k], index);
+
+        NodePtr children[kBranch];
+        size_t total = 0;
+        for (size_t i = 0; i < inner.n; ++i) {
+            NodePtr current = i == k ? std::move(child) : inner.children[i];
+            if (!current) continue;
+            if (total > 0 && current->leaf && children[total - 1]->leaf &&
+                (i == k || i == k + 1) && current->n + children[total - 1]->n <= kBranch / 2) {
+                children[total - 1] = MergeLeaves(*children[total - 1], *current);
+                continue;
+            }
+            children[total++] = std::move(current);
+        }
+        if (total == 0) return nullptr;
+        return MakeInner(children, total);
+    }
+
+    static NodePtr MergeLeaves(const Node& a, const Node& b) {
+        auto& left = static_cast<const Leaf&>(a);
+        auto& right = static_cast<const Leaf&>(b);
+        auto merged = std::make_shared<Leaf>();
+        std::copy(left.orders, left.orders + left.n, merged->orders);
+        std::copy(right.orders, right.orders + right.n, merged->orders + left.n);
+        merged->n = merged->count = left.n + right.n;
+        return merged;
+    }
+
+    // Stacks leaves into full inner levels
+    static OrderRope FromLeaves(std::vector<NodePtr> level) {
+        if (level.empty()) return OrderRope();
+        while (level.size() > 1) {
+            std::vector<NodePtr> parents;
+            parents.reserve((level.size() + kBranch - 1) / kBranch);
+            for (size_t i = 0; i < level.size(); i += kBranch)
+                parents.push_back(MakeInner(level.data() + i, std::min(kBranch, level.size() - i)));
+            level = std::move(parents);
+        }
+        return OrderRope(std::move(level[0]));
+    }
+
+    void CollectLeaves(std::vector<const NodePtr*>& leaves) const {
+        if (root_) CollectLeaves(root_, leaves);
+    }
+
+    static void CollectLeaves(const NodePtr& node, std::vector<const NodePtr*>& leaves) {
+        if (node->leaf) {
+            leaves.push_back(&node);
+            return;
+        }
+        auto& inner = static_cast<const Inner&>(*node);
+        for (size_t i = 0; i < inner.n; ++i) CollectLeaves(inner.children[i], leaves);
+    }
+
+    template <typename F>
+    static void VisitLeaves(const Node& node, F& f) {
+        if (node.leaf) {
+            f(static_cast<const Leaf&>(node).orders, static_cast<size_t>(node.n));
+            return;
+        }
+        auto& inner = static_cast<const Inner&>(node);
+        for (size_t i = 0; i < inner.n; ++i) VisitLeaves(*inner.children[i], f);
+    }
+
+    template <typename F>
+    static void VisitNodes(const Node& node, F& f) {
+        f(&node);
+        if (node.leaf) return;
+        auto& inner = static_cast<const Inner&>(node);
+        for (size_t i = 0; i < inner.n; ++i) VisitNodes(*inner.children[i], f);
+    }
+};
+
+class AccountVersionStore {
+public:
+    using Version = uint64_t;
+
+    // One account at one version; copies share everything
+    class Snapshot {
+    public:
+        int Id() const { return id_; }
+        const std::string& Name() const { return *name_; }
+        const Balance& Wallet() const { return wallet_; }
+        const OrderRope& Orders() const { return orders_; }
+        Version version() const { return version_; }
+
+        // Full TradeProto copy, for code that needs the plain struct
+        void Materialize(Account& account) const {
+            account.Id = id_;
+            account.Name.assign(name_->data(), name_->size());
+            account.Wallet = wallet_;
+            account.Orders.clear();
+            account.Orders.reserve(orders_.size());
+            orders_.ForEach([&](const Order& order) { account.Orders.push_back(order); });
+        }
+
+        // Same table as Account::Serialize, written from the shared leaves
+        flatbuffers::Offset<Trade::flatbuf::Account> Serialize(flatbuffers::FlatBufferBuilder& builder) const {
+            std::vector<flatbuffers::Offset<Trade::flatbuf::Order>> orders;
+            orders.reserve(orders_.size());
+            orders_.ForEach([&](const Order& order) {
+                orders.push_back(Trade::flatbuf::CreateOrderDirect(builder, order.Id, order.Symbol,
+                    static_cast<Trade::flatbuf::OrderSide>(order.Side), static_cast<Trade::flatbuf::OrderType>(order.Type),
+                    order.Price, order.Volume));
+            });
+            auto wallet = Trade::flatbuf::CreateBalanceDirect(builder, wallet_.Currency, wallet_.Amount);
+            return Trade::flatbuf::CreateAccountDirect(builder, id_, name_->c_str(), wallet, &orders);
+        }
+
+    private:
+        friend class AccountVersionStore;
+        int id_ = 0;
+        std::shared_ptr<const std::string> name_ = EmptyName();
+        Balance wallet_;
+        OrderRope orders_;
+        Version version_ = 0;
+    };
+
+    // Changes on top of a snapshot, each O(log n); Commit() publishes them as a new version
+    class Edit {
+    public:
+        const OrderRope& Orders() const { return snapshot_.orders_; }
+
+        Edit& SetName(const std::string& name) {
+            if (name != *snapshot_.name_) snapshot_.name_ = std::make_shared<const std::string>(name);
+            return *this;
+        }
+        Edit& SetWallet(const Balance& wallet) { snapshot_.wallet_ = wallet; return *this; }
+        Edit& SetOrder(size_t index, const Order& order) { snapshot_.orders_ = snapshot_.orders_.Set(index, order); return *this; }
+        Edit& InsertOrder(size_t index, const Order& order) { snapshot_.orders_ = snapshot_.orders_.Insert(index, order); return *this; }
+        Edit& AddOrder(const Order& order) { snapshot_.orders_ = snapshot_.orders_.PushBack(order); return *this; }
+        Edit& RemoveOrder(size_t index) { snapshot_.orders_ = snapshot_.orders_.Erase(index); return *this; }
+
+    private:
+        friend class AccountVersionStore;
+        Snapshot snapshot_;
+    };
+
+    struct MemoryStats {
+        size_t snapshots = 0;
+        size_t leaves = 0;           // distinct leaves / inner nodes over all versions
+        size_t inner_nodes = 0;
+        size_t bytes = 0;            // of those nodes
+        size_t full_copy_bytes = 0;  // what the versions would take as plain Orders vectors
+    };
+
+    // Starts from the latest version of the account, or from an empty account
+    Edit Begin(int account_id) const {
+        Edit edit;
+        auto it = history_.find(account_id);
+        if (it != history_.end() && !it->second.empty()) edit.snapshot_ = it->second.back();
+        edit.snapshot_.id_ = account_id;
+        return edit;
+    }
+
+    // Versions of one account must increase
+    Version Commit(const Edit& edit, Version version) {
+        Snapshot snapshot = edit.snapshot_;
+        snapshot.version_ = version;
+        Push(std::move(snapshot));
+        return version;
+    }
+
+    // A whole account: unchanged leaves of Orders are shared with the latest version
+    Version Commit(const Account& account, Version version) {
+        Edit edit = Begin(account.Id);
+        Snapshot& snapshot = edit.snapshot_;
+        if (*snapshot.name_ != std::string_view(account.Name.data(), account.Name.size()))
+            snapshot.name_ = std::make_shared<const std::string>(account.Name.data(), account.Name.size());
+        snapshot.wallet_ = account.Wallet;
+        snapshot.orders_ = snapshot.orders_.Assign(account.Orders.data(), account.Orders.size());
+        return Commit(edit, version);
+    }
+
+    // The version in effect at `version`: the newest one not after it
+    Snapshot At(int account_id, Version version) const {
+        auto& versions = Versions(account_id);
+        auto it = std::upper_bound(versions.begin(), versions.end(), version,
+                                   [](Version v, const Snapshot& s) { return v < s.version_; });
+        if (it == versions.begin()) throw std::runtime_error("No version of account " + std::to_string(account_id) + " at " + std::to_string(version));
+        return *(it - 1);
+    }
+
+    Snapshot Latest(int account_id) const {
+        auto& versions = Versions(account_id);
+        if (versions.empty()) throw std::runtime_error("No version of account " + std::to_string(account_id));
+        return versions.back();
+    }
+
+    bool Contains(int account_id) const { return history_.count(account_id) != 0; }
+    size_t VersionCount(int account_id) const {
+        auto it = history_.find(account_id);
+        return it == history_.end() ? 0 : it->second.size();
+    }
+
+    // Drops versions older than `version`, keeping the one in effect at it
+    void Trim(Version version) {
+        for (auto& entry : history_) {
+            auto& versions = entry.second;
+            auto it = std::upper_bound(versions.begin(), versions.end(), version,
+                                       [](Version v, const Snapshot& s) { return v < s.version_; });
+            if (it != versions.begin()) versions.erase(versions.begin(), it - 1);
+        }
+    }
+
+    MemoryStats Memory() const {
+        MemoryStats stats;
+        std::unordered_set<const OrderRope::Node*> seen;
+        for (auto& entry : history_) {
+            for (auto& snapshot : entry.second) {
+                ++stats.snapshots;
+                stats.full_copy_bytes += sizeof(Account) + snapshot.Name().size() + snapshot.orders_.size() * sizeof(Order);
+                snapshot.orders_.ForEachNode([&](const OrderRope::Node* node) {
+                    if (!seen.insert(node).second) return;
+                    if (node->leaf) {
+                        ++stats.leaves;
+                        stats.bytes += sizeof(OrderRope::Leaf);
+                    } else {
+                        ++stats.inner_nodes;
+                        stats.bytes += sizeof(OrderRope::Inner);
+                    }
+                });
+                stats.bytes += sizeof(Snapshot);
+            }
+        }
+        return stats;
+    }
+
+private:
+    std::unordered_map<int, std::vector<Snapshot>> history_;
+
+    static const std::shared_ptr<const std::string>& EmptyName() {
+        static const std::shared_ptr<const std::string> empty = std::make_shared<const std::string>();
+        return empty;
+    }
+
+    const std::vector<Snapshot>& Versions(int account_id) const {
+        auto it = history_.find(account_id);
+        if (it == history_.end()) throw std::runtime_error("Unknown account " + std::to_string(account_id));
+        return it->second;
+    }
+
+    void Push(Snapshot snapshot) {
+        auto& versions = history_[snapshot.id_];
+        if (!versions.empty() && snapshot.version_ <= versions.back().version_)
+            throw std::runtime_error("Account " + std::to_string(snapshot.id_) + " version " + std::to_string(snapshot.version_) + " is not newer than the latest");
+        versions.push_back(std::move(snapshot));
+    }
+};
+
+} // namespace TradeProto
+
+#endif // ACCOUNT_VERSION_STORE_H
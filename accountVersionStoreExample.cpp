@@ -0,0 +1,98 @@
+#include "accountVersionStore.h"
+#include "tradeSampleData.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Memory and time of keeping every version of one large account: AccountVersionStore against
+// full copies, fed both through Edits (order events) and through whole-account commits (replay)
+namespace {
+
+using namespace TradeProto::SampleData;
+
+const int kOrders = 5000;
+const int kVersions = 2000;
+
+// Every version changes the volume of 1..4 orders; one in ten also fills one order and adds a new one
+template <typename Change>
+void Stream(Change&& change)
+{
+    std::mt19937_64 rng(7);
+    for (int version = 1; version < kVersions; ++version)
+        change(rng, version);
+}
+
+void Report(const char* name, double ms, const TradeProto::AccountVersionStore::MemoryStats& stats)
+{
+    std::cout << "  " << name << ": " << ms << " ms, " << stats.snapshots << " versions, "
+              << stats.bytes / 1e6 << " MB shared (" << stats.leaves << " leaves, " << stats.inner_nodes << " inner nodes) against "
+              << stats.full_copy_bytes / 1e6 << " MB as full copies" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << kVersions << " versions of a " << kOrders << "-order account" << std::endl;
+
+    TradeProto::AccountVersionStore edits;
+    double edit_ms = Milliseconds([&]() {
+        TradeProto::Account account = MakeAccount(kOrders);
+        edits.Commit(account, 0);
+        int next_id = kOrders + 1;
+        Stream([&](std::mt19937_64& rng, int version) {
+            TradeProto::AccountVersionStore::Edit edit = edits.Begin(1);
+            for (int k = 1 + static_cast<int>(rng() % 4); k > 0; --k)
+            {
+                size_t index = rng() % edit.Orders().size();
+                TradeProto::Order order = edit.Orders()[index];
+                order.Volume = static_cast<double>(1 + rng() % 100) * 1000;
+                edit.SetOrder(index, order);
+            }
+            if (rng() % 10 == 0)
+            {
+                edit.RemoveOrder(rng() % edit.Orders().size());
+                TradeProto::Order order = edit.Orders()[0];
+                order.Id = next_id++;
+                edit.AddOrder(order);
+            }
+            edits.Commit(edit, version);
+        });
+    });
+    Report("edits  ", edit_ms, edits.Memory());
+
+    // The same kind of stream replayed as whole accounts, the store finds the unchanged leaves
+    TradeProto::AccountVersionStore replay;
+    double replay_ms = Milliseconds([&]() {
+        TradeProto::Account account = MakeAccount(kOrders);
+        replay.Commit(account, 0);
+        int next_id = kOrders + 1;
+        Stream([&](std::mt19937_64& rng, int version) {
+            for (int k = 1 + static_cast<int>(rng() % 4); k > 0; --k)
+                account.Orders[rng() % account.Orders.size()].Volume = static_cast<double>(1 + rng() % 100) * 1000;
+            if (rng() % 10 == 0)
+            {
+                account.Orders.erase(account.Orders.begin() + static_cast<long>(rng() % account.Orders.size()));
+                account.Orders.push_back(account.Orders[0]);
+                account.Orders.back().Id = next_id++;
+            }
+            replay.Commit(account, version);
+        });
+    });
+    Report("replay ", replay_ms, replay.Memory());
+
+    // Point-in-time reads
+    std::mt19937_64 rng(11);
+    double volume = 0;
+    double at_ms = Milliseconds([&]() {
+        for (int i = 0; i < 100000; ++i)
+        {
+            TradeProto::AccountVersionStore::Snapshot snapshot = edits.At(1, rng() % kVersions);
+            volume += snapshot.Orders()[rng() % snapshot.Orders().size()].Volume;
+        }
+    });
+    std::cout << "  100000 At() + order reads: " << at_ms << " ms (checksum " << volume << ")" << std::endl;
+
+    return 0;
+}
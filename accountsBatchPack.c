@@ -0,0 +1,353 @@
+#include "accountsBatchPack.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Field tags of accounts.proto, all single byte: (number << 3) | wire type */
+#define TAG_ORDER_ID        0x08
+#define TAG_ORDER_SYMBOL    0x12
+#define TAG_ORDER_SIDE      0x18
+#define TAG_ORDER_TYPE      0x20
+#define TAG_ORDER_PRICE     0x29
+#define TAG_ORDER_VOLUME    0x31
+#define TAG_BALANCE_CURRENCY 0x0a
+#define TAG_BALANCE_AMOUNT  0x11
+#define TAG_ACCOUNT_ID      0x08
+#define TAG_ACCOUNT_NAME    0x12
+#define TAG_ACCOUNT_WALLET  0x1a
+#define TAG_ACCOUNT_ORDERS  0x22
+
+/* --- memory --- */
+
+static void *
+batch_alloc (ProtobufCAllocator *allocator, size_t size)
+{
+  return allocator ? allocator->alloc (allocator->allocator_data, size) : malloc (size);
+}
+
+static void
+batch_free (ProtobufCAllocator *allocator, void *pointer)
+{
+  if (!pointer)
+    return;
+  if (allocator)
+    allocator->free (allocator->allocator_data, pointer);
+  else
+    free (pointer);
+}
+
+/* Grows *array to hold at least count elements of elem_size, keeping used elements.
+   ProtobufCAllocator has no realloc, so this is alloc + copy + free. */
+static int
+batch_reserve (ProtobufCAllocator *allocator, void **array, size_t *alloced,
+               size_t used, size_t count, size_t elem_size, int owned)
+{
+  size_t new_alloced;
+  void *fresh;
+  if (count <= *alloced)
+    return 0;
+  new_alloced = *alloced ? *alloced : 16;
+  while (new_alloced < count)
+    new_alloced *= 2;
+  fresh = batch_alloc (allocator, new_alloced * elem_size);
+  if (!fresh)
+    return -1;
+  if (used)
+    memcpy (fresh, *array, used * elem_size);
+  if (owned)
+    batch_free (allocator, *array);
+  *array = fresh;
+  *alloced = new_alloced;
+  return 0;
+}
+
+/* --- sizes, mirroring protobuf-c's proto3 rules: zero scalars, empty strings and NULL
+       submessages are not written; negative int32 / enum values take 10 bytes --- */
+
+static inline size_t
+uint32_size (uint32_t v)
+{
+  if (v < (1u << 7)) return 1;
+  if (v < (1u << 14)) return 2;
+  if (v < (1u << 21)) return 3;
+  if (v < (1u << 28)) return 4;
+  return 5;
+}
+
+static inline size_t
+int32_field_size (int32_t v)
+{
+  if (v == 0) return 0;
+  return 1 + (v < 0 ? 10 : uint32_size ((uint32_t) v));
+}
+
+static inline size_t
+string_field_size (const char *s)
+{
+  size_t len = s ? strlen (s) : 0;
+  return len ? 1 + uint32_size ((uint32_t) len) + len : 0;
+}
+
+static inline int
+double_is_zero (double d)
+{
+  uint64_t bits;
+  memcpy (&bits, &d, sizeof bits);  /* protobuf-c compares the bits, so -0.0 is written */
+  return bits == 0;
+}
+
+static inline size_t
+double_field_size (double d)
+{
+  return double_is_zero (d) ? 0 : 9;
+}
+
+static inline size_t
+submessage_field_size (size_t size)
+{
+  return 1 + uint32_size ((uint32_t) size) + size;
+}
+
+static size_t
+order_size (const Accounts__Order *order)
+{
+  return int32_field_size (order->id)
+       + string_field_size (order->symbol)
+       + int32_field_size ((int32_t) order->side)
+       + int32_field_size ((int32_t) order->type)
+       + double_field_size (order->price)
+       + double_field_size (order->volume);
+}
+
+static size_t
+balance_size (const Accounts__Balance *balance)
+{
+  return string_field_size (balance->currency) + double_field_size (balance->amount);
+}
+
+/* --- writers, no bounds checks: the plan sized everything --- */
+
+static inline uint8_t *
+write_uint32 (uint8_t *out, uint32_t v)
+{
+  while (v >= 0x80)
+    {
+      *out++ = (uint8_t) (v | 0x80);
+      v >>= 7;
+    }
+  *out++ = (uint8_t) v;
+  return out;
+}
+
+static inline uint8_t *
+write_int32_field (uint8_t *out, uint8_t tag, int32_t v)
+{
+  uint64_t u;
+  if (v == 0)
+    return out;
+  *out++ = tag;
+  if (v > 0)
+    return write_uint32 (out, (uint32_t) v);
+  u = (uint64_t) (int64_t) v;  /* sign extended, always 10 bytes */
+  while (u >= 0x80)
+    {
+      *out++ = (uint8_t) (u | 0x80);
+      u >>= 7;
+    }
+  *out++ = (uint8_t) u;
+  return out;
+}
+
+static inline uint8_t *
+write_string_field (uint8_t *out, uint8_t tag, const char *s)
+{
+  size_t len = s ? strlen (s) : 0;
+  if (!len)
+    return out;
+  *out++ = tag;
+  out = write_uint32 (out, (uint32_t) len);
+  memcpy (out, s, len);
+  return out + len;
+}
+
+static inline uint8_t *
+write_double_field (uint8_t *out, uint8_t tag, double d)
+{
+  uint64_t bits;
+  if (double_is_zero (d))
+    return out;
+  *out++ = tag;
+  memcpy (&bits, &d, sizeof bits);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  bits = __builtin_bswap64 (bits);
+#endif
+  memcpy (out, &bits, sizeof bits);
+  return out + 8;
+}
+
+static uint8_t *
+write_order (uint8_t *out, const Accounts__Order *order)
+{
+  out = write_int32_field (out, TAG_ORDER_ID, order->id);
+  out = write_string_field (out, TAG_ORDER_SYMBOL, order->symbol);
+  out = write_int32_field (out, TAG_ORDER_SIDE, (int32_t) order->side);
+  out = write_int32_field (out, TAG_ORDER_TYPE, (int32_t) order->type);
+  out = write_double_field (out, TAG_ORDER_PRICE, order->price);
+  return write_double_field (out, TAG_ORDER_VOLUME, order->volume);
+}
+
+static uint8_t *
+write_balance (uint8_t *out, const Accounts__Balance *balance)
+{
+  out = write_string_field (out, TAG_BALANCE_CURRENCY, balance->currency);
+  return write_double_field (out, TAG_BALANCE_AMOUNT, balance->amount);
+}
+
+/* --- plan --- */
+
+size_t
+accounts_batch_plan (AccountsBatchPlan *plan,
+                     const Accounts__Account *const *accounts,
+                     size_t n)
+{
+  size_t i, j, n_sizes = 0, offset = 0, *sizes;
+
+  for (i = 0; i < n; i++)
+    n_sizes += (accounts[i]->wallet != NULL) + accounts[i]->n_orders;
+  if (batch_reserve (plan->allocator, (void **) &plan->sizes, &plan->sizes_alloced,
+                     0, n_sizes, sizeof (size_t), 1) != 0
+      || batch_reserve (plan->allocator, (void **) &plan->offsets, &plan->offsets_alloced,
+                        0, n + 1, sizeof (size_t), 1) != 0)
+    return (size_t) -1;
+
+  sizes = plan->sizes;
+  for (i = 0; i < n; i++)
+    {
+      const Accounts__Account *account = accounts[i];
+      size_t size = int32_field_size (account->id) + string_field_size (account->name);
+      plan->offsets[i] = offset;
+      if (account->wallet)
+        {
+          *sizes = balance_size (account->wallet);
+          size += submessage_field_size (*sizes++);
+        }
+      for (j = 0; j < account->n_orders; j++)
+        {
+          *sizes = order_size (account->orders[j]);
+          size += submessage_field_size (*sizes++);
+        }
+      offset += size;
+    }
+  plan->offsets[n] = offset;
+  plan->n_sizes = n_sizes;
+  plan->n_accounts = n;
+  return offset;
+}
+
+void
+accounts_batch_pack_planned (const AccountsBatchPlan *plan,
+                             const Accounts__Account *const *accounts,
+                             uint8_t *out)
+{
+  const size_t *sizes = plan->sizes;
+  size_t i, j;
+
+  for (i = 0; i < plan->n_accounts; i++)
+    {
+      const Accounts__Account *account = accounts[i];
+      out = write_int32_field (out, TAG_ACCOUNT_ID, account->id);
+      out = write_string_field (out, TAG_ACCOUNT_NAME, account->name);
+      if (account->wallet)
+        {
+          *out++ = TAG_ACCOUNT_WALLET;
+          out = write_uint32 (out, (uint32_t) *sizes++);
+          out = write_balance (out, account->wallet);
+        }
+      for (j = 0; j < account->n_orders; j++)
+        {
+          *out++ = TAG_ACCOUNT_ORDERS;
+          out = write_uint32 (out, (uint32_t) *sizes++);
+          out = write_order (out, account->orders[j]);
+        }
+    }
+}
+
+size_t
+accounts_batch_pack (AccountsBatchPlan *plan,
+                     const Accounts__Account *const *accounts,
+                     size_t n,
+                     uint8_t *out,
+                     size_t out_size,
+                     size_t *offsets)
+{
+  size_t total = accounts_batch_plan (plan, accounts, n);
+  if (total == (size_t) -1 || total > out_size)
+    return total;
+  accounts_batch_pack_planned (plan, accounts, out);
+  if (offsets)
+    memcpy (offsets, plan->offsets, (n + 1) * sizeof (size_t));
+  return total;
+}
+
+void
+accounts_batch_plan_clear (AccountsBatchPlan *plan)
+{
+  batch_free (plan->allocator, plan->sizes);
+  batch_free (plan->allocator, plan->offsets);
+  plan->sizes = plan->offsets = NULL;
+  plan->n_sizes = plan->sizes_alloced = 0;
+  plan->n_accounts = plan->offsets_alloced = 0;
+}
+
+/* --- buffer --- */
+
+int
+accounts_batch_buffer_append (AccountsBatchBuffer *buffer,
+                              const Accounts__Account *const *accounts,
+                              size_t n)
+{
+  ProtobufCAllocator *allocator = buffer->plan.allocator;
+  size_t i, base = buffer->len, first = buffer->n_accounts;
+  uint8_t *data = buffer->data;
+  size_t total = accounts_batch_plan (&buffer->plan, accounts, n);
+
+  if (total == (size_t) -1)
+    return -1;
+  if (batch_reserve (allocator, (void **) &buffer->data, &buffer->alloced,
+                     buffer->len, buffer->len + total, 1, buffer->must_free_data) != 0)
+    return -1;
+  if (buffer->data != data)
+    buffer->must_free_data = 1;  /* moved off the scratch memory, if it started there */
+  if (batch_reserve (allocator, (void **) &buffer->offsets, &buffer->offsets_alloced,
+                     first + (first != 0), first + n + 1, sizeof (size_t), 1) != 0)
+    return -1;
+
+  accounts_batch_pack_planned (&buffer->plan, accounts, buffer->data + base);
+  for (i = 0; i <= n; i++)
+    buffer->offsets[first + i] = base + buffer->plan.offsets[i];
+  buffer->n_accounts += n;
+  buffer->len += total;
+  return 0;
+}
+
+void
+accounts_batch_buffer_reset (AccountsBatchBuffer *buffer)
+{
+  buffer->len = 0;
+  buffer->n_accounts = 0;
+}
+
+void
+accounts_batch_buffer_clear (AccountsBatchBuffer *buffer)
+{
+  ProtobufCAllocator *allocator = buffer->plan.allocator;
+  if (buffer->must_free_data)
+    batch_free (allocator, buffer->data);
+  batch_free (allocator, buffer->offsets);
+  accounts_batch_plan_clear (&buffer->plan);
+  buffer->data = NULL;
+  buffer->len = buffer->alloced = 0;
+  buffer->must_free_data = 0;
+  buffer->offsets = NULL;
+  buffer->n_accounts = buffer->offsets_alloced = 0;
+}
@@ -0,0 +1,98 @@
+#ifndef ACCOUNTS_BATCH_PACK_H
+#define ACCOUNTS_BATCH_PACK_H
+
+/* Batch packing of Accounts__Account (accounts.proto) for protobuf-c.
+
+accounts__account__get_packed_size + accounts__account__pack walk every Order twice per
+account (once to size, once to write, and the write sizes each submessage again to emit its
+length prefix) and need a buffer per message. Here one pass over the batch computes every
+Balance / Order size and caches it in an AccountsBatchPlan, then a second pass writes the
+accounts back to back using only the cached sizes, with no bounds checks, into either
+caller memory or a growable AccountsBatchBuffer.
+
+The output of each account is byte-identical to accounts__account__pack. Records are not
+delimited: offsets[i] .. offsets[i + 1] is account i, offsets[n] is the total size.
+
+Plans and buffers keep their memory between batches, so a loop that reuses them does not
+allocate once it has reached its largest batch. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "accounts.pb-c.h"
+
+PROTOBUF_C__BEGIN_DECLS
+
+/* Cached sizes of one batch, reusable across batches */
+typedef struct {
+  ProtobufCAllocator *allocator;  /* NULL: malloc / free */
+  size_t *sizes;                  /* per account: wallet size (if any), then one per order */
+  size_t n_sizes;
+  size_t sizes_alloced;
+  size_t *offsets;                /* n_accounts + 1 entries, starting at 0 */
+  size_t n_accounts;
+  size_t offsets_alloced;
+} AccountsBatchPlan;
+
+#define ACCOUNTS_BATCH_PLAN_INIT(allocator) { (allocator), NULL, 0, 0, NULL, 0, 0 }
+
+/* Growable output, like ProtobufCBufferSimple plus the offsets of every packed account.
+   May start on caller scratch memory, which is never freed. */
+typedef struct {
+  uint8_t *data;
+  size_t len;
+  size_t alloced;
+  protobuf_c_boolean must_free_data;
+  size_t *offsets;                /* n_accounts + 1 entries once anything was appended */
+  size_t n_accounts;
+  size_t offsets_alloced;
+  AccountsBatchPlan plan;
+} AccountsBatchBuffer;
+
+#define ACCOUNTS_BATCH_BUFFER_INIT(scratch, scratch_size, allocator) \
+  { (scratch), 0, (scratch_size), 0, NULL, 0, 0, ACCOUNTS_BATCH_PLAN_INIT(allocator) }
+
+/* Sizes every account of the batch in one pass. Returns plan->offsets[n], the bytes the
+   batch packs to, or (size_t)-1 if the plan could not grow. */
+size_t accounts_batch_plan   (AccountsBatchPlan *plan,
+                              const Accounts__Account *const *accounts,
+                              size_t n);
+
+/* Writes the planned batch to out, which must hold plan->offsets[plan->n_accounts] bytes.
+   accounts must be the batch the plan was made from, unchanged. */
+void   accounts_batch_pack_planned
+                             (const AccountsBatchPlan *plan,
+                              const Accounts__Account *const *accounts,
+                              uint8_t *out);
+
+/* Plan + pack into caller memory. Returns the batch size; nothing is written if it is larger
+   than out_size (like snprintf), or if the plan failed ((size_t)-1). offsets, when not NULL,
+   receives n + 1 entries. */
+size_t accounts_batch_pack   (AccountsBatchPlan *plan,
+                              const Accounts__Account *const *accounts,
+                              size_t n,
+                              uint8_t *out,
+                              size_t out_size,
+                              size_t *offsets);
+
+/* Appends the batch to the buffer, growing it at most once. Returns 0, or -1 if memory ran
+   out (the buffer is left as it was). */
+int    accounts_batch_buffer_append
+                             (AccountsBatchBuffer *buffer,
+                              const Accounts__Account *const *accounts,
+                              size_t n);
+
+/* Empties the buffer but keeps its memory */
+void   accounts_batch_buffer_reset
+                             (AccountsBatchBuffer *buffer);
+
+/* Frees everything the buffer allocated (scratch memory is left alone) */
+void   accounts_batch_buffer_clear
+                             (AccountsBatchBuffer *buffer);
+
+void   accounts_batch_plan_clear
+                             (AccountsBatchPlan *plan);
+
+PROTOBUF_C__END_DECLS
+
+#endif /* ACCOUNTS_BATCH_PACK_H */
@@ -0,0 +1,313 @@
+#include "accountsView.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Wire types of accounts.proto fields */
+#define WIRE_VARINT   0
+#define WIRE_FIXED64  1
+#define WIRE_LENGTH   2
+#define WIRE_FIXED32  5
+
+/* --- reader --- */
+
+typedef struct {
+  const uint8_t *p;
+  const uint8_t *end;
+} Reader;
+
+/* At most 10 bytes, like protobuf-c; 0 on truncated or over-long varints */
+static inline int
+read_varint (Reader *r, uint64_t *value)
+{
+  uint64_t v = 0;
+  unsigned shift;
+  for (shift = 0; shift < 70 && r->p < r->end; shift += 7)
+    {
+      uint8_t b = *r->p++;
+      v |= (uint64_t) (b & 0x7f) << shift;
+      if (!(b & 0x80))
+        {
+          *value = v;
+          return 1;
+        }
+    }
+  return 0;
+}
+
+static inline int
+read_tag (Reader *r, uint32_t *number, uint32_t *wire_type)
+{
+  uint64_t tag;
+  if (r->p < r->end && *r->p < 0x80)  /* every accounts.proto tag is one byte */
+    tag = *r->p++;
+  else if (!read_varint (r, &tag) || tag > UINT32_MAX)
+    return 0;
+  *number = (uint32_t) (tag >> 3);
+  *wire_type = (uint32_t) (tag & 7);
+  return *number != 0;
+}
+
+static inline int
+read_double (Reader *r, double *value)
+{
+  uint64_t bits;
+  if (r->end - r->p < 8)
+    return 0;
+  memcpy (&bits, r->p, sizeof bits);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  bits = __builtin_bswap64 (bits);
+#endif
+  memcpy (value, &bits, sizeof bits);
+  r->p += 8;
+  return 1;
+}
+
+/* A length-delimited field, as a sub-reader over its bytes */
+static inline int
+read_length (Reader *r, Reader *field)
+{
+  uint64_t len;
+  if (!read_varint (r, &len) || len > (uint64_t) (r->end - r->p))
+    return 0;
+  field->p = r->p;
+  field->end = r->p + len;
+  r->p += len;
+  return 1;
+}
+
+static inline int
+read_string (Reader *r, AccountsStringView *view)
+{
+  Reader field;
+  if (!read_length (r, &field))
+    return 0;
+  view->data = (const char *) field.p;
+  view->len = (size_t) (field.end - field.p);
+  return 1;
+}
+
+static int
+skip_field (Reader *r, uint32_t wire_type)
+{
+  uint64_t ignored;
+  Reader field;
+  switch (wire_type)
+    {
+    case WIRE_VARINT:
+      return read_varint (r, &ignored);
+    case WIRE_FIXED64:
+      if (r->end - r->p < 8)
+        return 0;
+      r->p += 8;
+      return 1;
+    case WIRE_LENGTH:
+      return read_length (r, &field);
+    case WIRE_FIXED32:
+      if (r->end - r->p < 4)
+        return 0;
+      r->p += 4;
+      return 1;
+    default:
+      return 0;  /* groups and invalid wire types */
+    }
+}
+
+/* --- messages --- */
+
+static const AccountsStringView empty_string = { "", 0 };
+
+static int
+parse_order (Reader *r, AccountsOrderView *order)
+{
+  uint32_t number, wire_type;
+  uint64_t v;
+  while (r->p < r->end)
+    {
+      if (!read_tag (r, &number, &wire_type))
+        return 0;
+      switch (number)
+        {
+        case 1:
+          if (wire_type != WIRE_VARINT || !read_varint (r, &v))
+            return 0;
+          order->id = (int32_t) (uint32_t) v;
+          break;
+        case 2:
+          if (wire_type != WIRE_LENGTH || !read_string (r, &order->symbol))
+            return 0;
+          break;
+        case 3:
+          if (wire_type != WIRE_VARINT || !read_varint (r, &v))
+            return 0;
+          order->side = (Accounts__OrderSide) (int32_t) (uint32_t) v;
+          break;
+        case 4:
+          if (wire_type != WIRE_VARINT || !read_varint (r, &v))
+            return 0;
+          order->type = (Accounts__OrderType) (int32_t) (uint32_t) v;
+          break;
+        case 5:
+          if (wire_type != WIRE_FIXED64 || !read_double (r, &order->price))
+            return 0;
+          break;
+        case 6:
+          if (wire_type != WIRE_FIXED64 || !read_double (r, &order->volume))
+            return 0;
+          break;
+        default:
+          if (!skip_field (r, wire_type))
+            return 0;
+        }
+    }
+  return 1;
+}
+
+/* Merges into balance, so a repeated wallet field keeps what the later one leaves out */
+static int
+parse_balance (Reader *r, AccountsBalanceView *balance)
+{
+  uint32_t number, wire_type;
+  while (r->p < r->end)
+    {
+      if (!read_tag (r, &number, &wire_type))
+        return 0;
+      switch (number)
+        {
+        case 1:
+          if (wire_type != WIRE_LENGTH || !read_string (r, &balance->currency))
+            return 0;
+          break;
+        case 2:
+          if (wire_type != WIRE_FIXED64 || !read_double (r, &balance->amount))
+            return 0;
+          break;
+        default:
+          if (!skip_field (r, wire_type))
+            return 0;
+        }
+    }
+  return 1;
+}
+
+static void
+free_orders (AccountsAccountView *view)
+{
+  if (!view->orders)
+    return;
+  if (view->allocator)
+    view->allocator->free (view->allocator->allocator_data, view->orders);
+  else
+    free (view->orders);
+}
+
+/* Grows view->orders to hold at least count entries. ProtobufCAllocator has no realloc,
+   so this is alloc + copy + free */
+static int
+reserve_orders (AccountsAccountView *view, size_t count)
+{
+  size_t alloced;
+  AccountsOrderView *fresh;
+  if (count <= view->orders_alloced)
+    return 1;
+  alloced = view->orders_alloced ? view->orders_alloced : 16;
+  while (alloced < count)
+    alloced *= 2;
+  fresh = view->allocator
+        ? view->allocator->alloc (view->allocator->allocator_data, alloced * sizeof *fresh)
+        : malloc (alloced * sizeof *fresh);
+  if (!fresh)
+    return 0;
+  if (view->n_orders)
+    memcpy (fresh, view->orders, view->n_orders * sizeof *fresh);
+  free_orders (view);
+  view->orders = fresh;
+  view->orders_alloced = alloced;
+  return 1;
+}
+
+int
+accounts_account_view_unpack (AccountsAccountView *view,
+                              const uint8_t *data,
+                              size_t len)
+{
+  Reader r, field;
+  uint32_t number, wire_type;
+  uint64_t v;
+
+  view->id = 0;
+  view->name = empty_string;
+  view->has_wallet = 0;
+  view->wallet.currency = empty_string;
+  view->wallet.amount = 0;
+  view->n_orders = 0;
+  if (!len)
+    return ACCOUNTS_VIEW_OK;
+
+  r.p = data;
+  r.end = data + len;
+  while (r.p < r.end)
+    {
+      if (!read_tag (&r, &number, &wire_type))
+        return ACCOUNTS_VIEW_MALFORMED;
+      switch (number)
+        {
+        case 1:
+          if (wire_type != WIRE_VARINT || !read_varint (&r, &v))
+            return ACCOUNTS_VIEW_MALFORMED;
+          view->id = (int32_t) (uint32_t) v;
+          break;
+        case 2:
+          if (wire_type != WIRE_LENGTH || !read_string (&r, &view->name))
+            return ACCOUNTS_VIEW_MALFORMED;
+          break;
+        case 3:
+          if (wire_type != WIRE_LENGTH || !read_length (&r, &field)
+              || !parse_balance (&field, &view->wallet))
+            return ACCOUNTS_VIEW_MALFORMED;
+          view->has_wallet = 1;
+          break;
+        case 4:
+          {
+            AccountsOrderView *order;
+            if (wire_type != WIRE_LENGTH || !read_length (&r, &field))
+              return ACCOUNTS_VIEW_MALFORMED;
+            if (view->n_orders == view->orders_alloced
+                && !reserve_orders (view, view->n_orders + 1))
+              return ACCOUNTS_VIEW_NO_MEMORY;
+            order = &view->orders[view->n_orders];
+            order->id = 0;
+            order->symbol = empty_string;
+            order->side = ACCOUNTS__ORDER_SIDE__BUY;
+            order->type = ACCOUNTS__ORDER_TYPE__MARKET;
+            order->price = 0;
+            order->volume = 0;
+            if (!parse_order (&field, order))
+              return ACCOUNTS_VIEW_MALFORMED;
+            view->n_orders++;
+            break;
+          }
+        default:
+          if (!skip_field (&r, wire_type))
+            return ACCOUNTS_VIEW_MALFORMED;
+        }
+    }
+  return ACCOUNTS_VIEW_OK;
+}
+
+void
+accounts_account_view_clear (AccountsAccountView *view)
+{
+  free_orders (view);
+  view->orders = NULL;
+  view->orders_alloced = 0;
+  view->n_orders = 0;
+}
+
+protobuf_c_boolean
+accounts_string_view_equals (AccountsStringView view,
+                             const char *s)
+{
+  size_t len = strlen (s);
+  return len == view.len && memcmp (view.data, s, len) == 0;
+}
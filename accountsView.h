@@ -0,0 +1,93 @@
+#ifndef ACCOUNTS_VIEW_H
+#define ACCOUNTS_VIEW_H
+
+/* Zero-copy unpack of Accounts__Account (accounts.proto) for short-lived messages.
+
+accounts__account__unpack allocates the Account, its Balance, an Accounts__Order* array and
+every Order separately, and copies each name / symbol / currency into its own NUL-terminated
+string. The views here decode the same wire format without any of that:
+
+  - strings are AccountsStringView, a pointer + length into the caller's input buffer
+    (not NUL-terminated), so the input must outlive the view;
+  - the wallet is stored inline, has_wallet says whether it was present;
+  - orders is one contiguous AccountsOrderView array owned by the view and kept between
+    calls, so an ingest loop that reuses one view stops allocating once it has seen its
+    largest account.
+
+Decoding follows protobuf-c: absent fields keep their proto3 defaults, the last occurrence of
+a scalar wins, repeated wallets are merged field by field, unknown fields are skipped, and
+int32 / enum values are the low 32 bits of their varint. Enum values are not range-checked.
+Truncated input, wrong wire types, field number 0, over-long varints and groups are rejected.
+
+    AccountsAccountView view = ACCOUNTS_ACCOUNT_VIEW_INIT (NULL);
+    while (next_record (&data, &len))
+      if (accounts_account_view_unpack (&view, data, len) == 0)
+        consume (&view);
+    accounts_account_view_clear (&view); */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "accounts.pb-c.h"
+
+PROTOBUF_C__BEGIN_DECLS
+
+/* Bytes inside the input buffer, not NUL-terminated */
+typedef struct {
+  const char *data;
+  size_t len;
+} AccountsStringView;
+
+typedef struct {
+  int32_t id;
+  AccountsStringView symbol;
+  Accounts__OrderSide side;
+  Accounts__OrderType type;
+  double price;
+  double volume;
+} AccountsOrderView;
+
+typedef struct {
+  AccountsStringView currency;
+  double amount;
+} AccountsBalanceView;
+
+typedef struct {
+  int32_t id;
+  AccountsStringView name;
+  protobuf_c_boolean has_wallet;
+  AccountsBalanceView wallet;
+  size_t n_orders;
+  AccountsOrderView *orders;      /* n_orders entries, contiguous */
+  size_t orders_alloced;
+  ProtobufCAllocator *allocator;  /* NULL: malloc / free */
+} AccountsAccountView;
+
+#define ACCOUNTS_ACCOUNT_VIEW_INIT(allocator) \
+  { 0, { "", 0 }, 0, { { "", 0 }, 0 }, 0, NULL, 0, (allocator) }
+
+#define ACCOUNTS_VIEW_OK         0
+#define ACCOUNTS_VIEW_MALFORMED  (-1)
+#define ACCOUNTS_VIEW_NO_MEMORY  (-2)
+
+/* Decodes one packed Account (no length prefix) into view, replacing what it held.
+   Returns ACCOUNTS_VIEW_OK, or an error after which the view's fields are unspecified
+   (it can still be reused or cleared). */
+int    accounts_account_view_unpack
+                             (AccountsAccountView *view,
+                              const uint8_t *data,
+                              size_t len);
+
+/* Frees the orders array */
+void   accounts_account_view_clear
+                             (AccountsAccountView *view);
+
+/* 1 if the view holds exactly the bytes of the C string s */
+protobuf_c_boolean
+       accounts_string_view_equals
+                             (AccountsStringView view,
+                              const char *s);
+
+PROTOBUF_C__END_DECLS
+
+#endif /* ACCOUNTS_VIEW_H */
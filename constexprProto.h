@@ -0,0 +1,487 @@
+#ifndef CONSTEXPR_PROTO_H
+#define CONSTEXPR_PROTO_H
+
+/* Compile-time version of ProtoParser for schemas that are fixed when the binary is built.
+
+    constexpr std::string_view kTradeProto = R"( ... )";
+    constexpr auto kTrade = CONSTEXPR_PROTO_SCHEMA(kTradeProto);
+    static_assert(kTrade.FieldNumber("Account", "orders") == 4);
+
+The source is parsed twice by the compiler: once to count definitions (which fixes the array
+sizes of the result type) and once to fill the tables. The result is a literal type of
+std::arrays of string_views and integers, so it can live in read-only data, be used in
+static_asserts and template arguments, and costs nothing at startup.
+
+Accepts the same grammar as ProtoParser (top-level message/enum blocks, other statements are
+skipped) and additionally checks what protobuf itself would reject: duplicate names, field
+numbers outside 1..2^29-1 or in the reserved 19000-19999 range, duplicate field numbers, and
+field types that are neither scalars nor defined messages/enums. A malformed schema is a
+compile error: evaluation reaches a schema_error:: function named after the problem. Check()
+returns the same diagnosis as a value, for a static_assert with a custom message; it resolves
+into fixed tables (256 messages and enums, 1024 fields and values) and reports a larger schema
+as TooLargeToCheck rather than passing it unchecked. */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace ConstexprProto {
+
+constexpr size_t npos = static_cast<size_t>(-1);
+
+enum class FieldType : uint8_t {
+    Double, Float, Int32, Int64, UInt32, UInt64, SInt32, SInt64,
+    Fixed32, Fixed64, SFixed32, SFixed64, Bool, String, Bytes, Message, Enum
+};
+
+struct FieldInfo {
+    std::string_view type_name;  // as written
+    std::string_view name;
+    int number = 0;
+    bool repeated = false;
+    bool optional = false;
+    FieldType type = FieldType::Int32;
+    size_t type_index = npos;    // into messages or enums for Message / Enum fields
+};
+
+struct MessageInfo {
+    std::string_view name;
+    size_t first_field = 0;      // into fields
+    size_t field_count = 0;
+};
+
+struct EnumValueInfo {
+    std::string_view name;
+    int value = 0;
+};
+
+struct EnumInfo {
+    std::string_view name;
+    size_t first_value = 0;      // into values
+    size_t value_count = 0;
+};
+
+enum class ErrorCode : uint8_t {
+    None,
+    UnreadableCharacter,
+    ExpectedMessageName,
+    ExpectedOpenBrace,
+    UnexpectedEnd,
+    ExpectedFieldType,
+    ExpectedFieldName,
+    ExpectedEquals,
+    ExpectedNumber,
+    ExpectedEnumName,
+    ExpectedValueName,
+    DuplicateMessage,
+    DuplicateEnum,
+    EnumClashesWithMessage,
+    FieldNumberOutOfRange,
+    FieldNumberReserved,
+    DuplicateFieldNumber,
+    DuplicateFieldName,
+    UnknownFieldType,
+    TooLargeToCheck,
+};
+constexpr const char* ErrorMessage(ErrorCode code) {
+    switch (code) {
+    case ErrorCode::None: return "";
+    case ErrorCode::UnreadableCharacter: return "Unreadable character in .proto";
+    case ErrorCode::ExpectedMessageName: return "Expected a message name";
+    case ErrorCode::ExpectedOpenBrace: return "Expected '{' after the message or enum name";
+    case ErrorCode::UnexpectedEnd: return "Unexpected end of input inside a definition";
+    case ErrorCode::ExpectedFieldType: return "Expected a field type";
+    case ErrorCode::ExpectedFieldName: return "Expected a field name";
+    case ErrorCode::ExpectedEquals: return "Expected '=' after a field or value name";
+    case ErrorCode::ExpectedNumber: return "Expected a number below 2^31";
+    case ErrorCode::ExpectedEnumName: return "Expected an enum name";
+    case ErrorCode::ExpectedValueName: return "Expected an enum value name";
+    case ErrorCode::DuplicateMessage: return "Duplicate message name";
+    case ErrorCode::DuplicateEnum: return "Duplicate enum name";
+    case ErrorCode::EnumClashesWithMessage: return "Enum name clashes with a message name";
+    case ErrorCode::FieldNumberOutOfRange: return "Field number out of range 1..536870911";
+    case ErrorCode::FieldNumberReserved: return "Field number in the reserved range 19000-19999";
+    case ErrorCode::DuplicateFieldNumber: return "Duplicate field number";
+    case ErrorCode::DuplicateFieldName: return "Duplicate field name";
+    case ErrorCode::UnknownFieldType: return "Unknown field type";
+    case ErrorCode::TooLargeToCheck: return "Schema exceeds the fixed tables of Check(), use Parse()";
+    }
+    return "";
+}
+
+struct Error {
+    ErrorCode code = ErrorCode::None;
+    int line = 0;        // 1-based, 0 when the problem is not tied to one line
+    constexpr bool ok() const { return code == ErrorCode::None; }
+    constexpr const char* message() const { return ErrorMessage(code); }
+};
+
+// Not constexpr on purpose: reaching one during constant evaluation is the compile error, and
+// the compiler names the function in it. At run time they throw like ProtoParser does.
+namespace schema_error {
+    [[noreturn]] inline void Fail(ErrorCode code, int line) {
+        throw std::runtime_error(std::string(ErrorMessage(code)) + " (line " + std::to_string(line) + ")");
+    }
+    [[noreturn]] inline void unreadable_character(int line) { Fail(ErrorCode::UnreadableCharacter, line); }
+    [[noreturn]] inline void expected_message_name(int line) { Fail(ErrorCode::ExpectedMessageName, line); }
+    [[noreturn]] inline void expected_open_brace(int line) { Fail(ErrorCode::ExpectedOpenBrace, line); }
+    [[noreturn]] inline void unexpected_end_of_input(int line) { Fail(ErrorCode::UnexpectedEnd, line); }
+    [[noreturn]] inline void expected_field_type(int line) { Fail(ErrorCode::ExpectedFieldType, line); }
+    [[noreturn]] inline void expected_field_name(int line) { Fail(ErrorCode::ExpectedFieldName, line); }
+    [[noreturn]] inline void expected_equals(int line) { Fail(ErrorCode::ExpectedEquals, line); }
+    [[noreturn]] inline void expected_number(int line) { Fail(ErrorCode::ExpectedNumber, line); }
+    [[noreturn]] inline void expected_enum_name(int line) { Fail(ErrorCode::ExpectedEnumName, line); }
+    [[noreturn]] inline void expected_enum_value_name(int line) { Fail(ErrorCode::ExpectedValueName, line); }
+    [[noreturn]] inline void duplicate_message_name(int line) { Fail(ErrorCode::DuplicateMessage, line); }
+    [[noreturn]] inline void duplicate_enum_name(int line) { Fail(ErrorCode::DuplicateEnum, line); }
+    [[noreturn]] inline void enum_name_clashes_with_message(int line) { Fail(ErrorCode::EnumClashesWithMessage, line); }
+    [[noreturn]] inline void field_number_out_of_range(int line) { Fail(ErrorCode::FieldNumberOutOfRange, line); }
+    [[noreturn]] inline void field_number_reserved(int line) { Fail(ErrorCode::FieldNumberReserved, line); }
+    [[noreturn]] inline void duplicate_field_number(int line) { Fail(ErrorCode::DuplicateFieldNumber, line); }
+    [[noreturn]] inline void duplicate_field_name(int line) { Fail(ErrorCode::DuplicateFieldName, line); }
+    [[noreturn]] inline void unknown_field_type(int line) { Fail(ErrorCode::UnknownFieldType, line); }
+    [[noreturn]] inline void too_large_to_check(int line) { Fail(ErrorCode::TooLargeToCheck, line); }
+} // namespace schema_error
+
+struct Counts {
+    size_t messages = 0, fields = 0, enums = 0, values = 0;
+};
+
+namespace detail {
+
+    enum class TokenType : uint8_t { Keyword, Identifier, String, Number, Symbol, End };
+
+    struct Token {
+        TokenType type = TokenType::End;
+        std::string_view value;
+        int line = 1;
+    };
+
+    constexpr bool IsAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+    constexpr bool IsPunct(char c) { return (c >= '!' && c <= '/') || (c >= ':' && c <= '@') || (c >= '[' && c <= '`') || (c >= '{' && c <= '~'); }
+
+    // Same token rules as ProtoTokenizer
+    class Tokenizer {
+    public:
+        constexpr explicit Tokenizer(std::string_view source) : source_(source) {}
+
+        constexpr Token Next(Error& error) {
+            while (pos_ < source_.size() && (source_[pos_] == ' ' || source_[pos_] == '\t' || source_[pos_] == '\r' || source_[pos_] == '\n')) {
+                if (source_[pos_] == '\n') ++line_;
+                ++pos_;
+            }
+            if (pos_ >= source_.size()) return { TokenType::End, {}, line_ };
+            char c = source_[pos_];
+            size_t start = pos_;
+            if (IsAlpha(c) || c == '_') {
+                while (pos_ < source_.size() && (IsAlpha(source_[pos_]) || IsDigit(source_[pos_]) || source_[pos_] == '_')) ++pos_;
+                std::string_view word = source_.substr(start, pos_ - start);
+                bool keyword = word == "message" || word == "enum" || word == "repeated" || word == "optional";
+                return { keyword ? TokenType::Keyword : TokenType::Identifier, word, line_ };
+            }
+            if (IsDigit(c)) {
+                while (pos_ < source_.size() && IsDigit(source_[pos_])) ++pos_;
+                return { TokenType::Number, source_.substr(start, pos_ - start), line_ };
+            }
+            if (c == '"') {
+                ++pos_;
+                while (pos_ < source_.size() && source_[pos_] != '"') ++pos_;
+                Token t{ TokenType::String, source_.substr(start + 1, pos_ - start - 1), line_ };
+                ++pos_;
+                return t;
+            }
+            if (IsPunct(c)) {
+                ++pos_;
+                return { TokenType::Symbol, source_.substr(start, 1), line_ };
+            }
+            error = { ErrorCode::UnreadableCharacter, line_ };
+            return { TokenType::End, {}, line_ };
+        }
+
+    private:
+        std::string_view source_;
+        size_t pos_ = 0;
+        int line_ = 1;
+    };
+
+    constexpr bool ParseNumber(std::string_view digits, int& value) {
+        long long v = 0;
+        for (char c : digits) {
+            v = v * 10 + (c - '0');
+            if (v > 2147483647) return false;
+        }
+        value = static_cast<int>(v);
+        return true;
+    }
+
+    // ProtoParser's grammar; definitions go to sink.Message / sink.Field / sink.Enum / sink.Value
+    template <typename Sink>
+    constexpr Error Parse(std::string_view source, Sink& sink) {
+        Error error;
+        Tokenizer tokenizer(source);
+        Token t = tokenizer.Next(error);
+        auto advance = [&]() { t = tokenizer.Next(error); return error.ok(); };
+        auto fail = [&](ErrorCode code) { if (error.ok()) error = { code, t.line }; return error; };
+        auto is = [&](TokenType type, std::string_view value) { return t.type == type && t.value == value; };
+
+        while (error.ok() && t.type != TokenType::End) {
+            if (t.value == "message") {
+                if (!advance()) return error;
+                if (t.type != TokenType::Identifier) return fail(ErrorCode::ExpectedMessageName);
+                sink.Message(t.value);
+                if (!advance()) return error;
+                if (!is(TokenType::Symbol, "{")) return fail(ErrorCode::ExpectedOpenBrace);
+                if (!advance()) return error;
+                while (!is(TokenType::Symbol, "}")) {
+                    FieldInfo field;
+                    if (t.type == TokenType::End) return fail(ErrorCode::UnexpectedEnd);
+                    if (t.value == "repeated") { field.repeated = true; if (!advance()) return error; }
+                    if (t.value == "optional") { field.optional = true; if (!advance()) return error; }
+                    if (t.type != TokenType::Identifier) return fail(ErrorCode::ExpectedFieldType);
+                    field.type_name = t.value;
+                    if (!advance()) return error;
+                    if (t.type != TokenType::Identifier) return fail(ErrorCode::ExpectedFieldName);
+                    field.name = t.value;
+                    if (!advance()) return error;
+                    if (!is(TokenType::Symbol, "=")) return fail(ErrorCode::ExpectedEquals);
+                    if (!advance()) return error;
+                    if (t.type != TokenType::Number || !ParseNumber(t.value, field.number)) return fail(ErrorCode::ExpectedNumber);
+                    sink.Field(field, t.line);
+                    if (!advance()) return error;
+                    if (is(TokenType::Symbol, ";") && !advance()) return error;
+                }
+                advance();
+            } else if (t.value == "enum") {
+                if (!advance()) return error;
+                if (t.type != TokenType::Identifier) return fail(ErrorCode::ExpectedEnumName);
+                sink.Enum(t.value);
+                if (!advance()) return error;
+                if (!is(TokenType::Symbol, "{")) return fail(ErrorCode::ExpectedOpenBrace);
+                if (!advance()) return error;
+                while (!is(TokenType::Symbol, "}")) {
+                    if (t.type == TokenType::End) return fail(ErrorCode::UnexpectedEnd);
+                    if (t.type != TokenType::Identifier) return fail(ErrorCode::ExpectedValueName);
+                    EnumValueInfo value;
+                    value.name = t.value;
+                    if (!advance()) return error;
+                    if (!is(TokenType::Symbol, "=")) return fail(ErrorCode::ExpectedEquals);
+                    if (!advance()) return error;
+                    if (t.type != TokenType::Number || !ParseNumber(t.value, value.value)) return fail(ErrorCode::ExpectedNumber);
+                    sink.Value(value);
+                    if (!advance()) return error;
+                    if (is(TokenType::Symbol, ";") && !advance()) return error;
+                }
+                advance();
+            } else {
+                advance();  // syntax, package, ... are skipped like ProtoParser does
+            }
+        }
+        return error;
+    }
+
+    struct CountSink {
+        Counts counts;
+        constexpr void Message(std::string_view) { ++counts.messages; }
+        constexpr void Field(const FieldInfo&, int) { ++counts.fields; }
+        constexpr void Enum(std::string_view) { ++counts.enums; }
+        constexpr void Value(const EnumValueInfo&) { ++counts.values; }
+    };
+
+    constexpr bool ScalarType(std::string_view name, FieldType& type) {
+        constexpr std::string_view names[] = { "double", "float", "int32", "int64", "uint32", "uint64", "sint32", "sint64",
+                                               "fixed32", "fixed64", "sfixed32", "sfixed64", "bool", "string", "bytes" };
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+            if (names[i] == name) {
+                type = static_cast<FieldType>(i);
+                return true;
+            }
+        return false;
+    }
+
+    constexpr void Raise(const Error& error) {
+        switch (error.code) {
+        case ErrorCode::None: break;
+        case ErrorCode::UnreadableCharacter: schema_error::unreadable_character(error.line); break;
+        case ErrorCode::ExpectedMessageName: schema_error::expected_message_name(error.line); break;
+        case ErrorCode::ExpectedOpenBrace: schema_error::expected_open_brace(error.line); break;
+        case ErrorCode::UnexpectedEnd: schema_error::unexpected_end_of_input(error.line); break;
+        case ErrorCode::ExpectedFieldType: schema_error::expected_field_type(error.line); break;
+        case ErrorCode::ExpectedFieldName: schema_error::expected_field_name(error.line); break;
+        case ErrorCode::ExpectedEquals: schema_error::expected_equals(error.line); break;
+        case ErrorCode::ExpectedNumber: schema_error::expected_number(error.line); break;
+        case ErrorCode::ExpectedEnumName: schema_error::expected_enum_name(error.line); break;
+        case ErrorCode::ExpectedValueName: schema_error::expected_enum_value_name(error.line); break;
+        case ErrorCode::DuplicateMessage: schema_error::duplicate_message_name(error.line); break;
+        case ErrorCode::DuplicateEnum: schema_error::duplicate_enum_name(error.line); break;
+        case ErrorCode::EnumClashesWithMessage: schema_error::enum_name_clashes_with_message(error.line); break;
+        case ErrorCode::FieldNumberOutOfRange: schema_error::field_number_out_of_range(error.line); break;
+        case ErrorCode::FieldNumberReserved: schema_error::field_number_reserved(error.line); break;
+        case ErrorCode::DuplicateFieldNumber: schema_error::duplicate_field_number(error.line); break;
+        case ErrorCode::DuplicateFieldName: schema_error::duplicate_field_name(error.line); break;
+        case ErrorCode::UnknownFieldType: schema_error::unknown_field_type(error.line); break;
+        case ErrorCode::TooLargeToCheck: schema_error::too_large_to_check(error.line); break;
+        }
+    }
+
+} // namespace detail
+
+template <size_t M, size_t F, size_t E, size_t V>
+struct Schema {
+    std::array<MessageInfo, M> messages{};
+    std::array<FieldInfo, F> fields{};
+    std::array<EnumInfo, E> enums{};
+    std::array<EnumValueInfo, V> values{};
+
+    constexpr size_t FindMessage(std::string_view name) const {
+        for (size_t i = 0; i < M; ++i)
+            if (messages[i].name == name) return i;
+        return npos;
+    }
+
+    constexpr size_t FindEnum(std::string_view name) const {
+        for (size_t i = 0; i < E; ++i)
+            if (enums[i].name == name) return i;
+        return npos;
+    }
+
+    // Index into fields, npos if the message or field does not exist
+    constexpr size_t FindField(size_t message, std::string_view name) const {
+        if (message >= M) return npos;
+        for (size_t i = messages[message].first_field; i < messages[message].first_field + messages[message].field_count; ++i)
+            if (fields[i].name == name) return i;
+        return npos;
+    }
+
+    constexpr size_t FindFieldByNumber(size_t message, int number) const {
+        if (message >= M) return npos;
+        for (size_t i = messages[message].first_field; i < messages[message].first_field + messages[message].field_count; ++i)
+            if (fields[i].number == number) return i;
+        return npos;
+    }
+
+    // Field number by names, 0 if there is no such field
+    constexpr int FieldNumber(std::string_view message, std::string_view field) const {
+        size_t i = FindField(FindMessage(message), field);
+        return i == npos ? 0 : fields[i].number;
+    }
+
+    // Enum value by names, -1 if there is no such value
+    constexpr int EnumValue(std::string_view enum_name, std::string_view value) const {
+        size_t e = FindEnum(enum_name);
+        if (e == npos) return -1;
+        for (size_t i = enums[e].first_value; i < enums[e].first_value + enums[e].value_count; ++i)
+            if (values[i].name == value) return values[i].value;
+        return -1;
+    }
+};
+
+namespace detail {
+
+    template <size_t M, size_t F, size_t E, size_t V>
+    struct TableSink {
+        Schema<M, F, E, V>& schema;
+        std::array<int, F>& lines;
+        size_t m = 0, f = 0, e = 0, v = 0;
+        constexpr void Message(std::string_view name) {
+            schema.messages[m].name = name;
+            schema.messages[m].first_field = f;
+            ++m;
+        }
+        constexpr void Field(const FieldInfo& field, int line) {
+            lines[f] = line;
+            schema.fields[f++] = field;
+            ++schema.messages[m - 1].field_count;
+        }
+        constexpr void Enum(std::string_view name) {
+            schema.enums[e].name = name;
+            schema.enums[e].first_value = v;
+            ++e;
+        }
+        constexpr void Value(const EnumValueInfo& value) {
+            schema.values[v++] = value;
+            ++schema.enums[e - 1].value_count;
+        }
+    };
+
+    // Parses and resolves; the error is returned, not thrown, so Check() can report it
+    template <size_t M, size_t F, size_t E, size_t V>
+    constexpr Error Build(std::string_view source, Schema<M, F, E, V>& schema) {
+        std::array<int, F> lines{};
+        TableSink<M, F, E, V> sink{ schema, lines };
+        Error error = Parse(source, sink);
+        if (!error.ok()) return error;
+
+        // Only the first sink.m / sink.e entries are filled when the tables are oversized (Check)
+        for (size_t i = 0; i < sink.m; ++i)
+            for (size_t j = 0; j < i; ++j)
+                if (schema.messages[i].name == schema.messages[j].name) return { ErrorCode::DuplicateMessage, 0 };
+        for (size_t i = 0; i < sink.e; ++i) {
+            for (size_t j = 0; j < i; ++j)
+                if (schema.enums[i].name == schema.enums[j].name) return { ErrorCode::DuplicateEnum, 0 };
+            if (schema.FindMessage(schema.enums[i].name) != npos) return { ErrorCode::EnumClashesWithMessage, 0 };
+        }
+        for (size_t m = 0; m < sink.m; ++m) {
+            const MessageInfo& msg = schema.messages[m];
+            for (size_t i = msg.first_field; i < msg.first_field + msg.field_count; ++i) {
+                FieldInfo& field = schema.fields[i];
+                if (field.number < 1 || field.number > 536870911) return { ErrorCode::FieldNumberOutOfRange, lines[i] };
+                if (field.number >= 19000 && field.number <= 19999) return { ErrorCode::FieldNumberReserved, lines[i] };
+                for (size_t j = msg.first_field; j < i; ++j) {
+                    if (schema.fields[j].number == field.number) return { ErrorCode::DuplicateFieldNumber, lines[i] };
+                    if (schema.fields[j].name == field.name) return { ErrorCode::DuplicateFieldName, lines[i] };
+                }
+                if (ScalarType(field.type_name, field.type)) continue;
+                if ((field.type_index = schema.FindMessage(field.type_name)) != npos) field.type = FieldType::Message;
+                else if ((field.type_index = schema.FindEnum(field.type_name)) != npos) field.type = FieldType::Enum;
+                else return { ErrorCode::UnknownFieldType, lines[i] };
+            }
+        }
+        return {};
+    }
+
+} // namespace detail
+
+// Definition counts, the template arguments of the Schema for source
+constexpr Counts Count(std::string_view source) {
+    detail::CountSink sink;
+    Error error = detail::Parse(source, sink);
+    if (!error.ok()) detail::Raise(error);  // compile error when evaluated at compile time
+    return sink.counts;
+}
+
+// Parse + resolve, throwing on any error (a compile error in a constant expression)
+template <size_t M, size_t F, size_t E, size_t V>
+constexpr Schema<M, F, E, V> Parse(std::string_view source) {
+    Schema<M, F, E, V> schema;
+    Error error = detail::Build(source, schema);
+    if (!error.ok()) detail::Raise(error);
+    return schema;
+}
+
+// The diagnosis without failing: static_assert(ConstexprProto::Check(src).ok(), "...")
+constexpr Error Check(std::string_view source) {
+    detail::CountSink counter;
+    Error error = detail::Parse(source, counter);
+    if (!error.ok()) return error;
+    // Resolution needs the tables; a generous fixed size keeps this usable as a plain function
+    constexpr size_t kMax = 256;
+    if (counter.counts.messages > kMax || counter.counts.fields > kMax * 4 || counter.counts.enums > kMax || counter.counts.values > kMax * 4)
+        return { ErrorCode::TooLargeToCheck, 0 };  // Parse() sizes its tables from the source instead
+    Schema<kMax, kMax * 4, kMax, kMax * 4> schema;
+    return detail::Build(source, schema);
+}
+
+} // namespace ConstexprProto
+
+// Builds the Schema for a constexpr string_view (or literal) at compile time
+#define CONSTEXPR_PROTO_SCHEMA(source)                                                        \
+    ::ConstexprProto::Parse<::ConstexprProto::Count(source).messages,                       \
+                            ::ConstexprProto::Count(source).fields,                         \
+                            ::ConstexprProto::Count(source).enums,                          \
+                            ::ConstexprProto::Count(source).values>(source)
+
+#endif // CONSTEXPR_PROTO_H
@@ -0,0 +1,286 @@
+#ifndef ENCODED_SIZE_PREDICTOR_H
+#define ENCODED_SIZE_PREDICTOR_H
+
+/* Encoded sizes of TradeProto accounts, computed from the structs without encoding them.
+
+Account::size() is the in-memory size. It says little about the wire size, so builders
+started at their defaults go through several reallocate-and-copy rounds on large accounts.
+The predictors here give the exact numbers, so a buffer can be allocated once:
+
+  - FlatBuffers: FlatBufferLayout replays FlatBufferBuilder's bookkeeping (alignment
+    padding, string terminators, vtables and their deduplication, the root offset)
+    with counters only. PredictFlatBufferSize() returns the finished size, which equals
+    builder.GetSize(). It also returns the builder capacity, which is the most the builder
+    holds at once: the data plus its scratch area of field locations and vtable offsets.
+    A builder started with that capacity allocates exactly once.
+  - protobuf: PredictProtobufSize() applies the proto3 rules of protobufSchema.proto
+    (zero scalars and empty strings skipped, negative int32 and enum values take 10
+    bytes, wallet always present). The result equals ByteSizeLong() of the message that
+    Account::Serialize() fills.
+
+Both predictions follow the Serialize() methods in generatedfbsCode.cpp and
+protobufGeneratedCode.cpp: they measure the same Symbol/Currency C strings, in the
+same field order.
+
+Usage:
+    auto predicted = TradeProto::PredictFlatBufferSize(account);
+    flatbuffers::FlatBufferBuilder builder(predicted.capacity);  // one allocation
+    builder.Finish(account.Serialize(builder));                   // builder.GetSize() == predicted.size
+
+    std::string out;
+    out.reserve(TradeProto::PredictProtobufSize(account));
+*/
+
+#include "../proto/trade.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace TradeProto {
+
+// Dry run of flatbuffers::FlatBufferBuilder (vector_downward, default options: defaults not
+// forced, vtables deduplicated). Offsets are the builder's, measured from the end of the buffer
+class FlatBufferLayout {
+public:
+    using uoffset_t = flatbuffers::uoffset_t;
+    using voffset_t = flatbuffers::voffset_t;
+
+    // Bytes written so far, builder.GetSize()
+    size_t size() const { return size_; }
+    // Largest data + scratch footprint so far, the initial_size that avoids any reallocation
+    size_t peak() const { return peak_; }
+
+    void Clear() {
+        size_ = scratch_ = peak_ = 0;
+        minalign_ = 1;
+        fields_ = 0;
+        vtables_.clear();
+    }
+
+    void Align(size_t elem_size) {
+        minalign_ = std::max(minalign_, elem_size);
+        Push(Padding(size_, elem_size));
+    }
+
+    void PreAlign(size_t len, size_t alignment) {
+        if (len == 0)
+            return;
+        minalign_ = std::max(minalign_, alignment);
+        Push(Padding(size_ + len, alignment));
+    }
+
+    // CreateString(): length prefix, bytes and a zero terminator
+    uoffset_t String(size_t length) {
+        PreAlign(length + 1, sizeof(uoffset_t));
+        Push(length + 1);
+        return Scalar(sizeof(uoffset_t));
+    }
+
+    // CreateVector() of offsets or scalars
+    uoffset_t Vector(size_t count, size_t elem_size) {
+        PreAlign(count * elem_size, sizeof(uoffset_t));
+        PreAlign(count * elem_size, elem_size);
+        Push(count * elem_size);
+        return Scalar(sizeof(uoffset_t));
+    }
+
+    uoffset_t StartTable() {
+        fields_ = 0;
+        return static_cast<uoffset_t>(size_);
+    }
+
+    // AddElement() of a non-default scalar, or AddOffset() of a non-null offset
+    void Field(voffset_t field, size_t elem_size) {
+        if (fields_ == locations_.size())
+            throw std::runtime_error("FlatBufferLayout: too many fields in one table");
+        uoffset_t location = Scalar(elem_size);
+        locations_[fields_++] = { location, field };
+        Scratch(kFieldLocSize);
+    }
+
+    uoffset_t EndTable(uoffset_t start) {
+        uoffset_t object = Scalar(sizeof(flatbuffers::soffset_t));
+
+        // The vtable is always written, then popped again when an identical one exists
+        VTable vtable{};
+        voffset_t max_field = 0;
+        for (size_t i = 0; i < fields_; ++i)
+            max_field = std::max(max_field, locations_[i].field);
+        voffset_t vtable_size = std::max<voffset_t>(static_cast<voffset_t>(max_field + sizeof(voffset_t)), 4);
+        if (vtable_size / sizeof(voffset_t) > vtable.size())
+            throw std::runtime_error("FlatBufferLayout: vtable too large");
+        vtable[0] = vtable_size;
+        vtable[1] = static_cast<voffset_t>(object - start);
+        for (size_t i = 0; i < fields_; ++i)
+            vtable[locations_[i].field / sizeof(voffset_t)] = static_cast<voffset_t>(object - locations_[i].location);
+        Push(vtable_size);
+        scratch_ -= fields_ * kFieldLocSize;
+        fields_ = 0;
+
+        for (const auto& known : vtables_) {
+            if (known == vtable) {
+                size_ -= vtable_size;
+                return object;
+            }
+        }
+        vtables_.push_back(vtable);
+        Scratch(sizeof(uoffset_t));
+        return object;
+    }
+
+    // Finish() without file identifier or size prefix. The scratch area is cleared first
+    uoffset_t Finish() {
+        scratch_ = 0;
+        PreAlign(sizeof(uoffset_t), minalign_);
+        return Scalar(sizeof(uoffset_t));
+    }
+
+    // Tables of trade.fbs, added in the order CreateXxx() adds their fields:
+    // largest first, reverse declaration order among equal sizes. Defaults are
+    // compared with ==, so unlike protobuf a -0.0 price is not written
+
+    uoffset_t AddOrder(const TradeProto::Order& order) {
+        String(strnlen(order.Symbol, sizeof(order.Symbol)));
+        uoffset_t start = StartTable();
+        if (order.Volume != 0.0) Field(Trade::flatbuf::Order::VT_VOLUME, sizeof(double));
+        if (order.Price != 0.0) Field(Trade::flatbuf::Order::VT_PRICE, sizeof(double));
+        Field(Trade::flatbuf::Order::VT_SYMBOL, sizeof(uoffset_t));
+        if (order.Id != 0) Field(Trade::flatbuf::Order::VT_ID, sizeof(int32_t));
+        if (static_cast<int8_t>(order.Type) != 0) Field(Trade::flatbuf::Order::VT_TYPE, sizeof(int8_t));
+        if (static_cast<int8_t>(order.Side) != 0) Field(Trade::flatbuf::Order::VT_SIDE, sizeof(int8_t));
+        return EndTable(start);
+    }
+
+    uoffset_t AddBalance(const TradeProto::Balance& balance) {
+        String(strnlen(balance.Currency, sizeof(balance.Currency)));
+        uoffset_t start = StartTable();
+        if (balance.Amount != 0.0) Field(Trade::flatbuf::Balance::VT_AMOUNT, sizeof(double));
+        Field(Trade::flatbuf::Balance::VT_CURRENCY, sizeof(uoffset_t));
+        return EndTable(start);
+    }
+
+    uoffset_t AddAccount(const TradeProto::Account& account) {
+        AddBalance(account.Wallet);
+        for (const auto& order : account.Orders)
+            AddOrder(order);
+        String(std::strlen(account.Name.c_str()));  // CreateAccountDirect() takes Name.c_str()
+        Vector(account.Orders.size(), sizeof(uoffset_t));
+        uoffset_t start = StartTable();
+        Field(Trade::flatbuf::Account::VT_ORDERS, sizeof(uoffset_t));
+        Field(Trade::flatbuf::Account::VT_WALLET, sizeof(uoffset_t));
+        Field(Trade::flatbuf::Account::VT_NAME, sizeof(uoffset_t));
+        if (account.Id != 0) Field(Trade::flatbuf::Account::VT_ID, sizeof(int32_t));
+        return EndTable(start);
+    }
+
+private:
+    using VTable = std::array<voffset_t, 8>;
+    struct FieldLocation { uoffset_t location; voffset_t field; };
+    static constexpr size_t kFieldLocSize = 8;  // sizeof(flatbuffers::FlatBufferBuilder::FieldLoc)
+
+    size_t size_ = 0;
+    size_t scratch_ = 0;
+    size_t peak_ = 0;
+    size_t minalign_ = 1;
+    std::array<FieldLocation, 8> locations_{};
+    size_t fields_ = 0;
+    std::vector<VTable> vtables_;
+
+    static size_t Padding(size_t size, size_t alignment) { return (~size + 1) & (alignment - 1); }
+
+    void Push(size_t bytes) {
+        size_ += bytes;
+        peak_ = std::max(peak_, size_ + scratch_);
+    }
+
+    void Scratch(size_t bytes) {
+        scratch_ += bytes;
+        peak_ = std::max(peak_, size_ + scratch_);
+    }
+
+    uoffset_t Scalar(size_t elem_size) {
+        Align(elem_size);
+        Push(elem_size);
+        return static_cast<uoffset_t>(size_);
+    }
+};
+
+struct FlatBufferPrediction {
+    size_t size = 0;      // builder.GetSize() after Finish()
+    size_t capacity = 0;  // FlatBufferBuilder initial_size that makes the build allocate once
+};
+
+// Exact prediction for builder.Finish(account.Serialize(builder)) on a fresh (or Clear()ed) builder
+inline FlatBufferPrediction PredictFlatBufferSize(const Account& account, FlatBufferLayout& layout) {
+    layout.Clear();
+    layout.AddAccount(account);
+    layout.Finish();
+    return { layout.size(), layout.peak() };
+}
+
+inline FlatBufferPrediction PredictFlatBufferSize(const Account& account) {
+    FlatBufferLayout layout;
+    return PredictFlatBufferSize(account, layout);
+}
+
+// --- protobuf (protobufSchema.proto, proto3) ---
+
+namespace ProtobufSize {
+
+inline size_t Varint(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+// Field numbers are all below 16, so every tag is one byte
+inline size_t Int32Field(int32_t value) {
+    if (value == 0) return 0;
+    return 1 + (value < 0 ? 10 : Varint(static_cast<uint32_t>(value)));
+}
+
+inline size_t StringField(size_t length) { return length ? 1 + Varint(length) + length : 0; }
+
+inline size_t DoubleField(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits ? 1 + sizeof(double) : 0;
+}
+
+inline size_t MessageField(size_t size) { return 1 + Varint(size) + size; }
+
+}
+
+inline size_t PredictProtobufSize(const Order& order) {
+    using namespace ProtobufSize;
+    return Int32Field(order.Id)
+         + StringField(strnlen(order.Symbol, sizeof(order.Symbol)))
+         + Int32Field(static_cast<int32_t>(order.Side))
+         + Int32Field(static_cast<int32_t>(order.Type))
+         + DoubleField(order.Price)
+         + DoubleField(order.Volume);
+}
+
+inline size_t PredictProtobufSize(const Balance& balance) {
+    using namespace ProtobufSize;
+    return StringField(strnlen(balance.Currency, sizeof(balance.Currency))) + DoubleField(balance.Amount);
+}
+
+inline size_t PredictProtobufSize(const Account& account) {
+    using namespace ProtobufSize;
+    size_t size = Int32Field(account.Id) + StringField(account.Name.size()) + MessageField(PredictProtobufSize(account.Wallet));
+    for (const auto& order : account.Orders)
+        size += MessageField(PredictProtobufSize(order));
+    return size;
+}
+
+}
+
+#endif
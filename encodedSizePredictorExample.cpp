@@ -0,0 +1,98 @@
+#include "encodedSizePredictor.h"
+#include "tradeMetrics.h"
+#include "tradeSampleData.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Default-sized against predicted-size FlatBufferBuilders and protobuf output strings, counting
+// every buffer (re)allocation the encoders make
+namespace {
+
+using namespace TradeProto::SampleData;
+
+const int kAccounts = 2000;
+const int kRounds = 10;
+
+void Report(const char* name, double seconds, size_t allocations, size_t reallocations)
+{
+    std::cout << "  " << name << ": " << static_cast<int>(kAccounts / seconds) << " accounts/s, "
+              << allocations / kRounds << " allocations, " << reallocations / kRounds << " growth reallocations" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    // Mostly small accounts, every 50th with thousands of orders
+    std::vector<TradeProto::Account> accounts = MakeAccounts(kAccounts, 40, 50);
+
+    std::cout << "FlatBuffers (fresh builder per account)" << std::endl;
+    TradeMetrics::CountingAllocator counter;  // growth goes through reallocate_downward()
+    size_t mismatches = 0;
+    double fb_default = Seconds([&]() {
+        for (auto& account : accounts)
+        {
+            flatbuffers::FlatBufferBuilder builder(1024, &counter);
+            builder.Finish(account.Serialize(builder));
+        }
+    }, kRounds);
+    Report("default 1024 bytes", fb_default, counter.allocations, counter.reallocations);
+
+    counter.Reset();
+    TradeProto::FlatBufferLayout layout;
+    double fb_predicted = Seconds([&]() {
+        for (auto& account : accounts)
+        {
+            auto predicted = TradeProto::PredictFlatBufferSize(account, layout);
+            flatbuffers::FlatBufferBuilder builder(predicted.capacity, &counter);
+            builder.Finish(account.Serialize(builder));
+            mismatches += builder.GetSize() != predicted.size;
+        }
+    }, kRounds);
+    Report("predicted capacity", fb_predicted, counter.allocations, counter.reallocations);
+
+    std::cout << "protobuf (all accounts appended to one output string)" << std::endl;
+    std::vector<Trade::protobuf::Account> messages(accounts.size());
+    for (size_t i = 0; i < accounts.size(); ++i)
+        accounts[i].Serialize(messages[i]);
+
+    size_t growths = 0;
+    std::string out;
+    double pb_default = Seconds([&]() {
+        std::string().swap(out);
+        for (const auto& message : messages)
+        {
+            size_t capacity = out.capacity();
+            message.AppendToString(&out);
+            growths += out.capacity() != capacity;
+        }
+    }, kRounds);
+    Report("default growth    ", pb_default, growths, growths - kRounds);
+
+    growths = 0;
+    double pb_predicted = Seconds([&]() {
+        std::string().swap(out);
+        size_t total = 0;
+        for (const auto& account : accounts)
+            total += TradeProto::PredictProtobufSize(account);
+        out.reserve(total);
+        ++growths;
+        for (const auto& message : messages)
+        {
+            size_t capacity = out.capacity();
+            message.AppendToString(&out);
+            growths += out.capacity() != capacity;
+        }
+    }, kRounds);
+    Report("predicted reserve ", pb_predicted, growths, growths - kRounds);
+
+    for (size_t i = 0; i < accounts.size(); ++i)
+        mismatches += messages[i].ByteSizeLong() != TradeProto::PredictProtobufSize(accounts[i]);
+    std::cout << std::endl << "Size mismatches: " << mismatches << std::endl;
+
+    google::protobuf::ShutdownProtobufLibrary();
+
+    return 0;
+}
@@ -0,0 +1,500 @@
+#ifndef FB_TO_PB_TRANSCODER_H
+#define FB_TO_PB_TRANSCODER_H
+
+/* Streams FlatBuffers data straight into protobuf wire bytes, for any schema, using the
+FileDescriptorProto FlatBuffersToProtobuf produced for it. No generated code on either side.
+
+The constructor pairs every FlatBuffers object with the message of the same name and compiles
+a plan per table: for each field, in protobuf field number order, the vtable slot to read, how
+wide the stored value is, how it goes on the wire, the pre-encoded tag bytes, the FlatBuffers
+default and, for tables, the nested plan. Structs use FixedStructCodec, whose whole encoding is
+a template. Transcode() then just walks plans; nothing is looked up by name or type per field.
+
+Field numbers, wire types and labels come from the descriptor, storage widths and vtable slots
+from the schema. Fields present in only one of them are skipped. Proto3 rules apply: scalars
+equal to zero and absent sub-messages are not written, numeric vectors are packed.
+
+A nested message or packed vector gets a one byte length prefix. The few whose length needs more
+are widened in one pass at the end of Transcode(), so no byte is moved more than once however
+deep the nesting.
+
+The input must already be verified (flatbuffers::Verifier or a generated Verify*Buffer):
+Transcode() follows offsets and vector lengths as they are, without bounds checks. */
+
+#include "flatbuffers/flatbuffers.h"
+#include "reflection_generated.h"
+#include "fbsStructCodec.h"
+
+#include <google/protobuf/descriptor.pb.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FbToPbTranscoder {
+public:
+    FbToPbTranscoder(const reflection::SchemaT& schema, const google::protobuf::FileDescriptorProto& file_desc)
+        : plans_(schema.objects.size()), codecs_(schema.objects.size()) {
+        std::unordered_map<std::string, const google::protobuf::DescriptorProto*> messages;
+        for (const auto& msg : file_desc.message_type()) messages.emplace(msg.name(), &msg);
+
+        for (size_t i = 0; i < schema.objects.size(); ++i) {
+            const reflection::ObjectT& obj = *schema.objects[i];
+            object_index_.emplace(obj.name, static_cast<int32_t>(i));
+            if (obj.is_struct) {
+                codecs_[i].reset(new FixedStructCodec(schema, static_cast<int32_t>(i)));
+                continue;
+            }
+            auto it = messages.find(obj.name);
+            if (it != messages.end()) BuildPlan(schema, obj, *it->second, plans_[i]);
+        }
+        if (schema.root_table) root_index_ = ObjectIndex(schema.root_table->name);
+    }
+
+    // Index into schema.objects, -1 if there is no such object
+    int32_t ObjectIndex(const std::string& name) const {
+        auto it = object_index_.find(name);
+        return it == object_index_.end() ? -1 : it->second;
+    }
+
+    // Transcodes a finished, verified buffer whose root is the schema's root_type, appending to out
+    void Transcode(const uint8_t* buffer, std::string& out) const {
+        if (root_index_ < 0) throw std::runtime_error("Schema has no root table");
+        Transcode(root_index_, flatbuffers::GetRoot<flatbuffers::Table>(buffer), out);
+    }
+
+    // Same, for a buffer whose root is the given object
+    void Transcode(int32_t object_index, const uint8_t* buffer, std::string& out) const {
+        Transcode(object_index, flatbuffers::GetRoot<flatbuffers::Table>(buffer), out);
+    }
+
+    // Transcodes one table of the given object, appending the message body to out
+    void Transcode(int32_t object_index, const flatbuffers::Table* table, std::string& out) const {
+        const Plan& plan = plans_.at(object_index);
+        if (!plan.valid) throw std::runtime_error("No transcoding plan for object " + std::to_string(object_index));
+        Lengths lengths;
+        EncodeTable(plan, table, out, lengths);
+        Widen(out, lengths);
+    }
+
+    std::string Transcode(const uint8_t* buffer) const {
+        std::string out;
+        Transcode(buffer, out);
+        return out;
+    }
+
+private:
+    enum ReadKind : uint8_t { ReadBool, ReadI8, ReadU8, ReadI16, ReadU16, ReadI32, ReadU32, ReadI64, ReadU64, ReadF32, ReadF64 };
+    enum WriteKind : uint8_t { WriteVarint, WriteZigZag32, WriteZigZag64, WriteFixed32, WriteFixed64, WriteFloat, WriteDouble, WriteBool };
+    enum StepKind : uint8_t { ScalarField, StringField, TableField, StructField, ScalarVector, StringVector, TableVector, StructVector };
+
+    struct Step {
+        flatbuffers::voffset_t vt;  // vtable slot of the field
+        StepKind kind;
+        ReadKind read;              // storage of the scalar (or vector element)
+        WriteKind write;            // wire encoding of the scalar (or vector element)
+        uint8_t tag_len;
+        uint8_t tag[5];             // pre-encoded field key
+        int32_t nested = -1;        // object index of a table or struct
+        int64_t default_integer = 0;
+        double default_real = 0.0;
+    };
+
+    struct Plan {
+        bool valid = false;
+        std::vector<Step> steps;
+    };
+
+    std::vector<Plan> plans_;                                 // indexed like schema.objects, tables only
+    std::vector<std::unique_ptr<FixedStructCodec>> codecs_;   // indexed like schema.objects, structs only
+    std::unordered_map<std::string, int32_t> object_index_;
+    int32_t root_index_ = -1;
+
+    // ---- plan construction ----
+
+    static ReadKind ReadKindOf(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool: return ReadBool;
+        case reflection::BaseType_Byte: return ReadI8;
+        case reflection::BaseType_UType:
+        case reflection::BaseType_UByte: return ReadU8;
+        case reflection::BaseType_Short: return ReadI16;
+        case reflection::BaseType_UShort: return ReadU16;
+        case reflection::BaseType_Int: return ReadI32;
+        case reflection::BaseType_UInt: return ReadU32;
+        case reflection::BaseType_Long: return ReadI64;
+        case reflection::BaseType_ULong: return ReadU64;
+        case reflection::BaseType_Float: return ReadF32;
+        default: return ReadF64;
+        }
+    }
+
+    static bool IsScalar(reflection::BaseType type) {
+        return type >= reflection::BaseType_Bool && type <= reflection::BaseType_Double;
+    }
+
+    // Wire encoding of a scalar protobuf type, false for strings/messages/groups
+    static bool WriteKindOf(google::protobuf::FieldDescriptorProto::Type type, WriteKind& write) {
+        using FD = google::protobuf::FieldDescriptorProto;
+        switch (type) {
+        case FD::TYPE_INT32: case FD::TYPE_INT64: case FD::TYPE_UINT32: case FD::TYPE_UINT64: case FD::TYPE_ENUM: write = WriteVarint; return true;
+        case FD::TYPE_SINT32: write = WriteZigZag32; return true;
+        case FD::TYPE_SINT64: write = WriteZigZag64; return true;
+        case FD::TYPE_FIXED32: case FD::TYPE_SFIXED32: write = WriteFixed32; return true;
+        case FD::TYPE_FIXED64: case FD::TYPE_SFIXED64: write = WriteFixed64; return true;
+        case FD::TYPE_FLOAT: write = WriteFloat; return true;
+        case FD::TYPE_DOUBLE: write = WriteDouble; return true;
+        case FD::TYPE_BOOL: write = WriteBool; return true;
+        default: return false;
+        }
+    }
+
+    static uint32_t WireTypeOf(WriteKind write) {
+        switch (write) {
+        case WriteFixed32: case WriteFloat: return 5;
+        case WriteFixed64: case WriteDouble: return 1;
+        default: return 0;
+        }
+    }
+
+    static void SetTag(Step& step, uint32_t number, uint32_t wire_type) {
+        uint64_t key = (static_cast<uint64_t>(number) << 3) | wire_type;
+        step.tag_len = 0;
+        while (key >= 0x80) {
+            step.tag[step.tag_len++] = static_cast<uint8_t>(key | 0x80);
+            key >>= 7;
+        }
+        step.tag[step.tag_len++] = static_cast<uint8_t>(key);
+    }
+
+    void BuildPlan(const reflection::SchemaT& schema, const reflection::ObjectT& obj,
+                   const google::protobuf::DescriptorProto& msg, Plan& plan) const {
+        using FD = google::protobuf::FieldDescriptorProto;
+        std::unordered_map<std::string, const reflection::FieldT*> fields;
+        for (const auto& f : obj.fields) fields.emplace(f->name, f.get());
+
+        std::vector<const FD*> pb_fields;
+        for (const auto& f : msg.field()) pb_fields.push_back(&f);
+        std::sort(pb_fields.begin(), pb_fields.end(), [](const FD* a, const FD* b) { return a->number() < b->number(); });
+
+        for (const FD* pb : pb_fields) {
+            auto it = fields.find(pb->name());
+            if (it == fields.end() || it->second->deprecated) continue;
+            const reflection::FieldT& fb = *it->second;
+            const reflection::TypeT& type = *fb.type;
+            bool repeated = pb->label() == FD::LABEL_REPEATED;
+
+            Step step{};
+            step.vt = fb.offset;
+            step.default_integer = fb.default_integer;
+            step.default_real = fb.default_real;
+
+            reflection::BaseType base = type.base_type;
+            if (base == reflection::BaseType_Vector) {
+                if (!repeated) continue;
+                base = type.element;
+            } else if (repeated) {
+                continue;
+            }
+            bool vector = type.base_type == reflection::BaseType_Vector;
+
+            if (IsScalar(base)) {
+                if (!WriteKindOf(pb->type(), step.write)) continue;
+                step.read = ReadKindOf(base);
+                step.kind = vector ? ScalarVector : ScalarField;
+                SetTag(step, pb->number(), vector ? 2 : WireTypeOf(step.write));
+            } else if (base == reflection::BaseType_String) {
+                if (pb->type() != FD::TYPE_STRING && pb->type() != FD::TYPE_BYTES) continue;
+                step.kind = vector ? StringVector : StringField;
+                SetTag(step, pb->number(), 2);
+            } else if (base == reflection::BaseType_Obj) {
+                if (pb->type() != FD::TYPE_MESSAGE) continue;
+                step.nested = type.index;
+                bool is_struct = schema.objects[type.index]->is_struct;
+                step.kind = is_struct ? (vector ? StructVector : StructField) : (vector ? TableVector : TableField);
+                SetTag(step, pb->number(), 2);
+            } else {
+                continue;  // unions and nested vectors have no counterpart in the converted descriptor
+            }
+            plan.steps.push_back(step);
+        }
+        plan.valid = true;
+    }
+
+    // ---- encoding ----
+
+    static void PutVarint(std::string& out, uint64_t value) {
+        char buf[10];
+        size_t n = 0;
+        while (value >= 0x80) {
+            buf[n++] = static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        buf[n++] = static_cast<char>(value);
+        out.append(buf, n);
+    }
+
+    static size_t VarintSize(uint64_t value) {
+        size_t n = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++n;
+        }
+        return n;
+    }
+
+    static void PutTag(std::string& out, const Step& step) {
+        out.append(reinterpret_cast<const char*>(step.tag), step.tag_len);
+    }
+
+    // Length prefixes that need more than their one byte, and by how much the output will grow
+    struct Lengths {
+        struct Wide {
+            size_t at;                   // the one byte prefix, before widening
+            uint64_t length;
+        };
+        std::vector<Wide> wide;
+        size_t grown = 0;
+    };
+
+    struct OpenLength {
+        size_t body;                     // where the body starts, before widening
+        size_t grown;                    // Lengths::grown when the body started
+    };
+
+    // Reserves one byte for the length of what follows
+    static OpenLength BeginLength(std::string& out, const Lengths& lengths) {
+        out.push_back(0);
+        return { out.size(), lengths.grown };
+    }
+
+    // Writes the length of everything appended since BeginLength, counting the prefixes inside it
+    // that will be widened. A length of 128 or more is left for Widen()
+    static void EndLength(std::string& out, Lengths& lengths, const OpenLength& open) {
+        uint64_t length = out.size() - open.body + (lengths.grown - open.grown);
+        if (length < 0x80) {
+            out[open.body - 1] = static_cast<char>(length);
+            return;
+        }
+        lengths.wide.push_back({ open.body - 1, length });
+        lengths.grown += VarintSize(length) - 1;
+    }
+
+    // Makes room for every wide prefix, moving each byte after one once, from the back
+    static void Widen(std::string& out, Lengths& lengths) {
+        if (lengths.wide.empty()) return;
+        std::sort(lengths.wide.begin(), lengths.wide.end(), [](const Lengths::Wide& a, const Lengths::Wide& b) { return a.at < b.at; });
+        size_t read = out.size();
+        out.resize(out.size() + lengths.grown);
+        char* data = &out[0];
+        size_t write = out.size();
+        for (auto it = lengths.wide.rbegin(); it != lengths.wide.rend(); ++it) {
+            size_t tail = read - (it->at + 1);
+            write -= tail;
+            std::memmove(data + write, data + it->at + 1, tail);
+            uint64_t length = it->length;
+            write -= VarintSize(length);
+            char* p = data + write;
+            while (length >= 0x80) {
+                *p++ = static_cast<char>(length | 0x80);
+                length >>= 7;
+            }
+            *p = static_cast<char>(length);
+            read = it->at;
+        }
+    }
+
+    // A scalar is carried as integer bits or as a double, depending on its storage
+    struct Value {
+        uint64_t bits;
+        double real;
+    };
+
+    static Value Read(ReadKind read, const uint8_t* p) {
+        switch (read) {
+        case ReadBool: return { static_cast<uint64_t>(p[0] != 0), 0.0 };
+        case ReadI8: return { static_cast<uint64_t>(static_cast<int64_t>(flatbuffers::ReadScalar<int8_t>(p))), 0.0 };
+        case ReadU8: return { flatbuffers::ReadScalar<uint8_t>(p), 0.0 };
+        case ReadI16: return { static_cast<uint64_t>(static_cast<int64_t>(flatbuffers::ReadScalar<int16_t>(p))), 0.0 };
+        case ReadU16: return { flatbuffers::ReadScalar<uint16_t>(p), 0.0 };
+        case ReadI32: return { static_cast<uint64_t>(static_cast<int64_t>(flatbuffers::ReadScalar<int32_t>(p))), 0.0 };
+        case ReadU32: return { flatbuffers::ReadScalar<uint32_t>(p), 0.0 };
+        case ReadI64: return { static_cast<uint64_t>(flatbuffers::ReadScalar<int64_t>(p)), 0.0 };
+        case ReadU64: return { flatbuffers::ReadScalar<uint64_t>(p), 0.0 };
+        case ReadF32: return { 0, flatbuffers::ReadScalar<float>(p) };
+        default: return { 0, flatbuffers::ReadScalar<double>(p) };
+        }
+    }
+
+    static bool IsReal(ReadKind read) { return read == ReadF32 || read == ReadF64; }
+
+    static void Write(WriteKind write, bool real, const Value& v, std::string& out) {
+        uint64_t bits = real ? static_cast<uint64_t>(static_cast<int64_t>(v.real)) : v.bits;
+        switch (write) {
+        case WriteVarint: PutVarint(out, bits); break;
+        case WriteBool: out.push_back(static_cast<char>(bits != 0 || (real && v.real != 0.0))); break;
+        case WriteZigZag32: {
+            uint32_t u = static_cast<uint32_t>(bits);
+            PutVarint(out, (u << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(u) >> 31));
+            break;
+        }
+        case WriteZigZag64: PutVarint(out, (bits << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(bits) >> 63)); break;
+        case WriteFixed32: {
+            char b[4];
+            flatbuffers::WriteScalar<uint32_t>(b, static_cast<uint32_t>(bits));
+            out.append(b, 4);
+            break;
+        }
+        case WriteFixed64: {
+            char b[8];
+            flatbuffers::WriteScalar<uint64_t>(b, bits);
+            out.append(b, 8);
+            break;
+        }
+        case WriteFloat: {
+            char b[4];
+            flatbuffers::WriteScalar<float>(b, real ? static_cast<float>(v.real) : static_cast<float>(static_cast<int64_t>(v.bits)));
+            out.append(b, 4);
+            break;
+        }
+        case WriteDouble: {
+            char b[8];
+            flatbuffers::WriteScalar<double>(b, real ? v.real : static_cast<double>(static_cast<int64_t>(v.bits)));
+            out.append(b, 8);
+            break;
+        }
+        }
+    }
+
+    static size_t ReadWidth(ReadKind read) {
+        switch (read) {
+        case ReadBool: case ReadI8: case ReadU8: return 1;
+        case ReadI16: case ReadU16: return 2;
+        case ReadI32: case ReadU32: case ReadF32: return 4;
+        default: return 8;
+        }
+    }
+
+    // Same storage and wire layout, so a packed vector is the FlatBuffers bytes as they are
+    static bool SameLayout(ReadKind read, WriteKind write) {
+        return (write == WriteDouble && read == ReadF64) || (write == WriteFloat && read == ReadF32) ||
+               (write == WriteFixed32 && (read == ReadI32 || read == ReadU32)) ||
+               (write == WriteFixed64 && (read == ReadI64 || read == ReadU64));
+    }
+
+    void EncodeTable(const Plan& plan, const flatbuffers::Table* table, std::string& out, Lengths& lengths) const {
+        for (const Step& step : plan.steps) {
+            switch (step.kind) {
+            case ScalarField: {
+                const uint8_t* p = table->GetAddressOf(step.vt);
+                bool real = IsReal(step.read);
+                Value v = p ? Read(step.read, p) : Value{ static_cast<uint64_t>(step.default_integer), step.default_real };
+                if (real ? v.real == 0.0 : v.bits == 0) break;  // proto3 does not write zero
+                PutTag(out, step);
+                Write(step.write, real, v, out);
+                break;
+            }
+            case StringField: {
+                auto* s = table->GetPointer<const flatbuffers::String*>(step.vt);
+                if (!s || s->size() == 0) break;
+                PutTag(out, step);
+                PutVarint(out, s->size());
+                out.append(s->c_str(), s->size());
+                break;
+            }
+            case TableField: {
+                auto* nested = table->GetPointer<const flatbuffers::Table*>(step.vt);
+                if (!nested) break;
+                PutTag(out, step);
+                OpenLength prefix = BeginLength(out, lengths);
+                EncodeTable(plans_[step.nested], nested, out, lengths);
+                EndLength(out, lengths, prefix);
+                break;
+            }
+            case StructField: {
+                const uint8_t* p = table->GetAddressOf(step.vt);
+                if (!p) break;
+                const FixedStructCodec& codec = *codecs_[step.nested];
+                PutTag(out, step);
+                PutVarint(out, codec.EncodedSize());
+                codec.Encode(p, out);
+                break;
+            }
+            case ScalarVector: {
+                auto* vec = table->GetPointer<const flatbuffers::Vector<uint8_t>*>(step.vt);
+                if (!vec || vec->size() == 0) break;
+                size_t count = vec->size();
+                size_t width = ReadWidth(step.read);
+                const uint8_t* p = vec->Data();
+                PutTag(out, step);
+                if (SameLayout(step.read, step.write)) {  // one memcpy for the whole vector
+                    PutVarint(out, count * width);
+                    out.append(reinterpret_cast<const char*>(p), count * width);
+                    break;
+                }
+                bool real = IsReal(step.read);
+                OpenLength prefix = BeginLength(out, lengths);
+                for (size_t i = 0; i < count; ++i, p += width)
+                    Write(step.write, real, Read(step.read, p), out);
+                EndLength(out, lengths, prefix);
+                break;
+            }
+            case StringVector: {
+                auto* vec = table->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>*>(step.vt);
+                if (!vec) break;
+                for (flatbuffers::uoffset_t i = 0; i < vec->size(); ++i) {
+                    const flatbuffers::String* s = vec->Get(i);
+                    PutTag(out, step);
+                    PutVarint(out, s->size());
+                    out.append(s->c_str(), s->size());
+                }
+                break;
+            }
+            case TableVector: {
+                auto* vec = table->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::Table>>*>(step.vt);
+                if (!vec) break;
+                const Plan& nested = plans_[step.nested];
+                for (flatbuffers::uoffset_t i = 0; i < vec->size(); ++i) {
+                    PutTag(out, step);
+                    OpenLength prefix = BeginLength(out, lengths);
+                    EncodeTable(nested, vec->Get(i), out, lengths);
+                    EndLength(out, lengths, prefix);
+                }
+                break;
+            }
+            case StructVector: {
+                auto* vec = table->GetPointer<const flatbuffers::Vector<uint8_t>*>(step.vt);
+                if (!vec || vec->size() == 0) break;
+                const FixedStructCodec& codec = *codecs_[step.nested];
+                size_t count = vec->size();
+                const uint8_t* p = vec->Data();
+                // Every element encodes to the same bytes count: tag + length + body, sized once
+                size_t entry = step.tag_len + VarintSize(codec.EncodedSize()) + codec.EncodedSize();
+                size_t at = out.size();
+                out.resize(at + count * entry);
+                uint8_t* dst = reinterpret_cast<uint8_t*>(&out[at]);
+                for (size_t i = 0; i < count; ++i, p += codec.StructSize()) {
+                    std::memcpy(dst, step.tag, step.tag_len);
+                    uint8_t* q = dst + step.tag_len;
+                    uint64_t length = codec.EncodedSize();
+                    while (length >= 0x80) {
+                        *q++ = static_cast<uint8_t>(length | 0x80);
+                        length >>= 7;
+                    }
+                    *q++ = static_cast<uint8_t>(length);
+                    codec.Encode(p, q);
+                    dst += entry;
+                }
+                break;
+            }
+            }
+        }
+    }
+};
+
+#endif // FB_TO_PB_TRANSCODER_H
@@ -0,0 +1,202 @@
+#ifndef FBS_ACCOUNT_SCAN_H
+#define FBS_ACCOUNT_SCAN_H
+
+/* Projection pushdown scans over archives of Trade::flatbuf::Account records (see recordFile.h).
+
+Instead of Deserialize()ing whole accounts, the scanner reads only the Order fields
+named in the projection straight out of the FlatBuffer and appends them to
+caller-owned column buffers. An optional predicate (side, type, symbol) is checked
+against the buffer first, so rejected orders cost a couple of vtable reads.
+
+Usage:
+    TradeProto::OrderColumns out;                         // reuse across scans, keeps capacity
+    TradeProto::AccountScanner scan(TradeProto::COL_PRICE | TradeProto::COL_VOLUME | TradeProto::COL_SIDE,
+                                    TradeProto::OrderPredicate::Symbol("EURUSD"), &pool);
+    scan.ScanFile(MappedRecordFile("accounts.rec"), out);
+*/
+
+#include "flatbuffers/trade_generated.h"
+#include "recordFile.h"
+#include "threadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace TradeProto {
+
+// Columns that can be projected out of each order (bit mask)
+enum OrderColumn : uint32_t {
+    COL_ACCOUNT_ID = 1u << 0,   // id of the owning account
+    COL_ID = 1u << 1,
+    COL_SYMBOL = 1u << 2,
+    COL_SIDE = 1u << 3,
+    COL_TYPE = 1u << 4,
+    COL_PRICE = 1u << 5,
+    COL_VOLUME = 1u << 6,
+    COL_ALL = (1u << 7) - 1
+};
+
+// Same width as TradeProto::Order::Symbol, always NUL terminated
+constexpr size_t kSymbolWidth = 10;
+using SymbolCell = std::array<char, kSymbolWidth>;
+
+// Filter evaluated against each order before anything is copied out
+struct OrderPredicate {
+    bool match_side = false;
+    Trade::flatbuf::OrderSide side = Trade::flatbuf::OrderSide_buy;
+    bool match_type = false;
+    Trade::flatbuf::OrderType type = Trade::flatbuf::OrderType_market;
+    std::string symbol;   // empty matches any symbol
+
+    static OrderPredicate Side(Trade::flatbuf::OrderSide s) { OrderPredicate p; p.match_side = true; p.side = s; return p; }
+    static OrderPredicate Type(Trade::flatbuf::OrderType t) { OrderPredicate p; p.match_type = true; p.type = t; return p; }
+    static OrderPredicate Symbol(std::string s) { OrderPredicate p; p.symbol = std::move(s); return p; }
+
+    bool Empty() const { return !match_side && !match_type && symbol.empty(); }
+
+    bool Matches(const Trade::flatbuf::Order& order) const {
+        if (match_side && order.side() != side) return false;
+        if (match_type && order.type() != type) return false;
+        if (!symbol.empty()) {
+            const flatbuffers::String* s = order.symbol();  // compared in place, no copy
+            if (!s || s->size() != symbol.size() || std::memcmp(s->c_str(), symbol.data(), symbol.size()) != 0)
+                return false;
+        }
+        return true;
+    }
+};
+
+// Caller-owned output buffers; only the projected columns are filled, the rest stay empty
+struct OrderColumns {
+    std::vector<int32_t> account_id;
+    std::vector<int32_t> id;
+    std::vector<SymbolCell> symbol;
+    std::vector<Trade::flatbuf::OrderSide> side;
+    std::vector<Trade::flatbuf::OrderType> type;
+    std::vector<double> price;
+    std::vector<double> volume;
+    size_t rows = 0;
+
+    // Drops the rows but keeps every buffer's capacity
+    void Clear() {
+        account_id.clear(); id.clear(); symbol.clear(); side.clear();
+        type.clear(); price.clear(); volume.clear();
+        rows = 0;
+    }
+
+    void Append(const OrderColumns& other) {
+        account_id.insert(account_id.end(), other.account_id.begin(), other.account_id.end());
+        id.insert(id.end(), other.id.begin(), other.id.end());
+        symbol.insert(symbol.end(), other.symbol.begin(), other.symbol.end());
+        side.insert(side.end(), other.side.begin(), other.side.end());
+        type.insert(type.end(), other.type.begin(), other.type.end());
+        price.insert(price.end(), other.price.begin(), other.price.end());
+        volume.insert(volume.end(), other.volume.begin(), other.volume.end());
+        rows += other.rows;
+    }
+};
+
+class AccountScanner {
+public:
+    // pool == nullptr scans on the calling thread
+    AccountScanner(uint32_t projection, OrderPredicate predicate = OrderPredicate(), ThreadPool* pool = nullptr)
+        : projection_(projection), predicate_(std::move(predicate)), pool_(pool) {}
+
+    // Each buffer is checked with flatbuffers::Verifier before it is read, and skipped if it fails.
+    // On by default; benchmarks over trusted local archives can turn it off
+    void SetVerify(bool verify) { verify_ = verify; }
+
+    // Scans every FlatBuffer record of a mapped archive, appends matches to out, returns rows added
+    size_t ScanFile(const MappedRecordFile& file, OrderColumns& out) const {
+        std::vector<RecordRef> records = file.Index();
+        return ScanRecords(records, out);
+    }
+
+    // Scans a record stream batch by batch, each batch in parallel
+    size_t ScanStream(std::istream& in, OrderColumns& out, size_t batch_bytes = 8 << 20) const {
+        RecordStreamReader reader(in, batch_bytes);
+        std::vector<RecordRef> batch;
+        size_t rows = 0;
+        while (reader.NextBatch(batch))
+            rows += ScanRecords(batch, out);
+        return rows;
+    }
+
+    // Splits the records into one chunk per worker; chunk results are appended in record order.
+    // The per-chunk columns are local, so one scanner can serve several threads at once
+    size_t ScanRecords(const std::vector<RecordRef>& records, OrderColumns& out) const {
+        size_t before = out.rows;
+        if (!pool_ || pool_->size() == 1 || records.size() < 2) {
+            for (const auto& r : records) ScanRecord(r, out);
+            return out.rows - before;
+        }
+
+        size_t chunks = std::min(records.size(), pool_->size());
+        std::vector<OrderColumns> partials(chunks);
+        size_t step = (records.size() + chunks - 1) / chunks;
+        pool_->ParallelFor(chunks, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                OrderColumns& part = partials[c];
+                size_t end = std::min(records.size(), (c + 1) * step);
+                for (size_t i = c * step; i < end; ++i)
+                    ScanRecord(records[i], part);
+            }
+        });
+        for (size_t c = 0; c < chunks; ++c)
+            out.Append(partials[c]);
+        return out.rows - before;
+    }
+
+    // Scans one account buffer already in memory
+    void ScanAccount(const Trade::flatbuf::Account& account, OrderColumns& out) const {
+        const auto* orders = account.orders();
+        if (!orders) return;
+        int32_t account_id = account.id();
+        bool filter = !predicate_.Empty();
+        for (flatbuffers::uoffset_t i = 0; i < orders->size(); ++i) {
+            const Trade::flatbuf::Order* order = orders->Get(i);
+            if (filter && !predicate_.Matches(*order)) continue;
+            Emit(account_id, *order, out);
+        }
+    }
+
+private:
+    uint32_t projection_;
+    OrderPredicate predicate_;
+    ThreadPool* pool_;
+    bool verify_ = true;
+
+    void ScanRecord(const RecordRef& record, OrderColumns& out) const {
+        if (record.format != RecordFormat::FlatBuffer) return;  // other encodings need a full decode
+        if (verify_) {
+            flatbuffers::Verifier verifier(record.data, record.size);
+            if (!Trade::flatbuf::VerifyAccountBuffer(verifier)) return;
+        }
+        ScanAccount(*Trade::flatbuf::GetAccount(record.data), out);
+    }
+
+    void Emit(int32_t account_id, const Trade::flatbuf::Order& order, OrderColumns& out) const {
+        if (projection_ & COL_ACCOUNT_ID) out.account_id.push_back(account_id);
+        if (projection_ & COL_ID) out.id.push_back(order.id());
+        if (projection_ & COL_SYMBOL) {
+            SymbolCell cell{};
+            if (const flatbuffers::String* s = order.symbol())
+                std::memcpy(cell.data(), s->c_str(), std::min<size_t>(s->size(), kSymbolWidth - 1));
+            out.symbol.push_back(cell);
+        }
+        if (projection_ & COL_SIDE) out.side.push_back(order.side());
+        if (projection_ & COL_TYPE) out.type.push_back(order.type());
+        if (projection_ & COL_PRICE) out.price.push_back(order.price());
+        if (projection_ & COL_VOLUME) out.volume.push_back(order.volume());
+        ++out.rows;
+    }
+};
+
+} // namespace TradeProto
+
+#endif // FBS_ACCOUNT_SCAN_H
@@ -0,0 +1,201 @@
+#ifndef FBS_STRUCT_CODEC_H
+#define FBS_STRUCT_CODEC_H
+
+/* Encodes an inline FlatBuffers struct as the fixed-size protobuf message FlatBuffersToProtobuf
+gives it (fixed32/fixed64/float/double/bool fields, fixed arrays as packed repeated fields).
+
+Every field of such a message is always present and fixed width, so the whole encoding,
+tags and length prefixes included, is known when the codec is built. Encode() copies that
+template in one go and then drops the struct's bytes into their slots. Fields whose
+FlatBuffers width already matches the wire width (int/uint/long/ulong/float/double, and
+arrays of them) are plain memcpys of the struct bytes, both formats being little endian;
+only byte/short/bool fields are widened one by one. */
+
+#include "flatbuffers/flatbuffers.h"
+#include "reflection_generated.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class FixedStructCodec {
+public:
+    FixedStructCodec(const reflection::SchemaT& schema, int32_t object_index) {
+        const reflection::ObjectT& obj = *schema.objects.at(object_index);
+        if (!obj.is_struct) throw std::invalid_argument(obj.name + " is a table, not a struct");
+        struct_size_ = static_cast<size_t>(obj.bytesize);
+        Build(schema, obj, 0, template_, slots_);
+        MergeSlots();
+    }
+
+    size_t StructSize() const { return struct_size_; }     // bytes of the FlatBuffers struct
+    size_t EncodedSize() const { return template_.size(); } // bytes of the protobuf message, always the same
+
+    // Writes exactly EncodedSize() bytes to out
+    void Encode(const uint8_t* fb_struct, uint8_t* out) const {
+        std::memcpy(out, template_.data(), template_.size());
+        for (const Slot& slot : slots_) {
+            const uint8_t* src = fb_struct + slot.fb_offset;
+            uint8_t* dst = out + slot.pb_offset;
+            switch (slot.kind) {
+            case Copy:
+                std::memcpy(dst, src, slot.count);  // count is a byte count for copies
+                break;
+            case WidenSigned:
+                for (uint32_t i = 0; i < slot.count; ++i, src += slot.fb_width, dst += 4)
+                    flatbuffers::WriteScalar<int32_t>(dst, slot.fb_width == 1 ? flatbuffers::ReadScalar<int8_t>(src) : flatbuffers::ReadScalar<int16_t>(src));
+                break;
+            case WidenUnsigned:
+                for (uint32_t i = 0; i < slot.count; ++i, src += slot.fb_width, dst += 4)
+                    flatbuffers::WriteScalar<uint32_t>(dst, slot.fb_width == 1 ? flatbuffers::ReadScalar<uint8_t>(src) : flatbuffers::ReadScalar<uint16_t>(src));
+                break;
+            case Bool:
+                for (uint32_t i = 0; i < slot.count; ++i)
+                    dst[i] = src[i] != 0;
+                break;
+            }
+        }
+    }
+
+    // Appends the encoding to out
+    void Encode(const uint8_t* fb_struct, std::string& out) const {
+        size_t at = out.size();
+        out.resize(at + template_.size());
+        Encode(fb_struct, reinterpret_cast<uint8_t*>(&out[at]));
+    }
+
+private:
+    enum Kind : uint8_t { Copy, WidenSigned, WidenUnsigned, Bool };
+
+    struct Slot {
+        uint32_t fb_offset;   // into the FlatBuffers struct
+        uint32_t pb_offset;   // into the encoded message
+        uint32_t count;       // bytes for Copy, elements otherwise
+        uint8_t fb_width;     // element width in the struct
+        Kind kind;
+    };
+
+    size_t struct_size_ = 0;
+    std::vector<uint8_t> template_;
+    std::vector<Slot> slots_;
+
+    static void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static void PutKey(std::vector<uint8_t>& out, uint32_t number, uint32_t wire_type) {
+        PutVarint(out, (static_cast<uint64_t>(number) << 3) | wire_type);
+    }
+
+    static size_t ScalarSize(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool:
+        case reflection::BaseType_Byte:
+        case reflection::BaseType_UByte: return 1;
+        case reflection::BaseType_Short:
+        case reflection::BaseType_UShort: return 2;
+        case reflection::BaseType_Int:
+        case reflection::BaseType_UInt:
+        case reflection::BaseType_Float: return 4;
+        default: return 8;
+        }
+    }
+
+    // Wire width of the protobuf type FlatBuffersToProtobuf::StructScalarType picks
+    static size_t WireSize(reflection::BaseType type) {
+        if (type == reflection::BaseType_Bool) return 1;
+        return ScalarSize(type) <= 4 ? 4 : 8;
+    }
+
+    static Kind KindOf(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool: return Bool;
+        case reflection::BaseType_Byte:
+        case reflection::BaseType_Short: return WidenSigned;
+        case reflection::BaseType_UByte:
+        case reflection::BaseType_UShort: return WidenUnsigned;
+        default: return Copy;
+        }
+    }
+
+    // Appends count scalars of type at fb_offset to out as value bytes, recording their slot
+    static void AddValues(reflection::BaseType type, uint32_t fb_offset, uint32_t count,
+                          std::vector<uint8_t>& out, std::vector<Slot>& slots) {
+        Kind kind = KindOf(type);
+        uint8_t fb_width = static_cast<uint8_t>(ScalarSize(type));
+        uint32_t wire = static_cast<uint32_t>(WireSize(type));
+        slots.push_back({ fb_offset, static_cast<uint32_t>(out.size()), kind == Copy ? count * fb_width : count, fb_width, kind });
+        out.insert(out.end(), static_cast<size_t>(count) * wire, 0);
+    }
+
+    // Lays out obj's fields in field id order; fb_base is where obj starts inside the outer struct
+    static void Build(const reflection::SchemaT& schema, const reflection::ObjectT& obj, uint32_t fb_base,
+                      std::vector<uint8_t>& out, std::vector<Slot>& slots) {
+        std::vector<const reflection::FieldT*> fields;
+        for (const auto& f : obj.fields) fields.push_back(f.get());
+        std::sort(fields.begin(), fields.end(), [](const reflection::FieldT* a, const reflection::FieldT* b) { return a->id < b->id; });
+
+        for (const reflection::FieldT* field : fields) {
+            const reflection::TypeT& type = *field->type;
+            uint32_t number = field->id + 1u;
+            uint32_t fb_offset = fb_base + field->offset;
+
+            if (type.base_type == reflection::BaseType_Obj) {
+                AddNested(schema, type.index, number, fb_offset, out, slots);
+            } else if (type.base_type == reflection::BaseType_Array && type.element == reflection::BaseType_Obj) {
+                uint32_t stride = static_cast<uint32_t>(schema.objects[type.index]->bytesize);
+                for (uint32_t i = 0; i < type.fixed_length; ++i)  // repeated message, one entry per element
+                    AddNested(schema, type.index, number, fb_offset + i * stride, out, slots);
+            } else if (type.base_type == reflection::BaseType_Array) {
+                PutKey(out, number, 2);  // packed
+                PutVarint(out, static_cast<uint64_t>(type.fixed_length) * WireSize(type.element));
+                AddValues(type.element, fb_offset, type.fixed_length, out, slots);
+            } else {
+                uint32_t wire_type = type.base_type == reflection::BaseType_Bool ? 0 : (WireSize(type.base_type) == 4 ? 5 : 1);
+                PutKey(out, number, wire_type);
+                AddValues(type.base_type, fb_offset, 1, out, slots);
+            }
+        }
+    }
+
+    static void AddNested(const reflection::SchemaT& schema, int32_t index, uint32_t number, uint32_t fb_offset,
+                          std::vector<uint8_t>& out, std::vector<Slot>& slots) {
+        std::vector<uint8_t> nested;
+        std::vector<Slot> nested_slots;
+        Build(schema, *schema.objects[index], fb_offset, nested, nested_slots);
+        PutKey(out, number, 2);
+        PutVarint(out, nested.size());
+        uint32_t shift = static_cast<uint32_t>(out.size());
+        for (Slot slot : nested_slots) {
+            slot.pb_offset += shift;
+            slots.push_back(slot);
+        }
+        out.insert(out.end(), nested.begin(), nested.end());
+    }
+
+    // Back-to-back copies that are contiguous on both sides become one memcpy
+    void MergeSlots() {
+        std::vector<Slot> merged;
+        for (const Slot& slot : slots_) {
+            if (!merged.empty()) {
+                Slot& last = merged.back();
+                if (last.kind == Copy && slot.kind == Copy &&
+                    last.fb_offset + last.count == slot.fb_offset && last.pb_offset + last.count == slot.pb_offset) {
+                    last.count += slot.count;
+                    continue;
+                }
+            }
+            merged.push_back(slot);
+        }
+        slots_.swap(merged);
+    }
+};
+
+#endif // FBS_STRUCT_CODEC_H
@@ -0,0 +1,287 @@
+#ifndef FLAT_ACCOUNT_SNAPSHOT_H
+#define FLAT_ACCOUNT_SNAPSHOT_H
+
+/* Flat, trivially copyable layout of a TradeProto::Account for checkpoints between processes on
+the same architecture. Writing a checkpoint is one memcpy or write(). Restarting is a validation
+pass, after which the bytes are used in place or copied back into Accounts.
+
+A snapshot is one contiguous block, a multiple of 32 bytes:
+
+    FlatAccountHeader   128 bytes  magic, layout version, sizes, checksum, id, inline name,
+                                   wallet, order count and order region offset
+    FlatOrder[count]    32 bytes each, at orders_offset from the start of the header
+
+Nothing in it is a pointer: the order region is found by its offset, so the block can be moved,
+mapped at any address or concatenated with others (a checkpoint file is just snapshots back to
+back, see ForEachFlatAccount()). The name is inline with a fixed capacity,
+kFlatAccountNameCapacity - 1 bytes. Longer names are rejected when the snapshot is built.
+
+Values are stored in host byte order. A snapshot from a machine of the other endianness fails the
+magic check instead of loading garbage. Check() verifies the header and every order's enums. It
+also verifies a 64 bit checksum of the whole block, so a torn or stale write is caught before
+anything is used.
+
+Usage:
+    FlatAccountSnapshot snapshot(account);
+    ::write(fd, snapshot.data(), snapshot.size());
+
+    TradeProto::FlatAccountView view(mapped, length);   // throws on a damaged snapshot
+    view.ToAccount(account);
+*/
+
+#include "../proto/trade.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace TradeProto {
+
+constexpr uint32_t kFlatAccountMagic = 0x54434146;  // "FACT"
+constexpr uint16_t kFlatAccountVersion = 1;
+constexpr size_t kFlatAccountNameCapacity = 64;     // including the terminating zero
+
+struct FlatOrder {
+    int32_t Id;
+    char Symbol[10];   // verbatim, not necessarily zero terminated (as in Order)
+    uint8_t Side;      // OrderSide
+    uint8_t Type;      // OrderType
+    double Price;
+    double Volume;
+};
+
+struct FlatAccountHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;     // sizeof(FlatAccountHeader)
+    uint64_t total_size;      // header + order region
+    uint64_t checksum;        // FlatAccountChecksum() of the whole block
+    int32_t id;
+    uint32_t name_length;
+    char name[kFlatAccountNameCapacity];  // zero padded
+    char currency[16];                    // Balance::Currency, zero padded
+    double amount;
+    uint32_t order_count;
+    uint32_t orders_offset;   // from the start of the header
+};
+
+static_assert(std::is_trivially_copyable<FlatOrder>::value && std::is_standard_layout<FlatOrder>::value, "FlatOrder must stay a plain block");
+static_assert(std::is_trivially_copyable<FlatAccountHeader>::value && std::is_standard_layout<FlatAccountHeader>::value, "FlatAccountHeader must stay a plain block");
+static_assert(sizeof(FlatOrder) == 32, "FlatOrder layout changed, bump kFlatAccountVersion");
+static_assert(sizeof(FlatAccountHeader) == 128, "FlatAccountHeader layout changed, bump kFlatAccountVersion");
+static_assert(sizeof(Order::Symbol) == sizeof(FlatOrder::Symbol), "Order::Symbol size changed");
+static_assert(sizeof(Balance::Currency) <= sizeof(FlatAccountHeader::currency), "Balance::Currency does not fit");
+
+// Order has the same field layout as FlatOrder, so whole order arrays move with one memcpy
+constexpr bool kFlatOrderMatchesOrder = std::is_trivially_copyable<Order>::value && sizeof(Order) == sizeof(FlatOrder)
+    && offsetof(Order, Id) == offsetof(FlatOrder, Id) && offsetof(Order, Symbol) == offsetof(FlatOrder, Symbol)
+    && offsetof(Order, Side) == offsetof(FlatOrder, Side) && offsetof(Order, Type) == offsetof(FlatOrder, Type)
+    && offsetof(Order, Price) == offsetof(FlatOrder, Price) && offsetof(Order, Volume) == offsetof(FlatOrder, Volume);
+
+inline size_t FlatAccountSize(size_t orders) { return sizeof(FlatAccountHeader) + orders * sizeof(FlatOrder); }
+inline size_t FlatAccountSize(const Account& account) { return FlatAccountSize(account.Orders.size()); }
+
+// Checksum of a snapshot of size bytes (a multiple of 32), its checksum field counted as zero.
+// Four independent multiply-rotate lanes over 32 byte blocks keep up with memory bandwidth on restart
+inline uint64_t FlatAccountChecksum(const uint8_t* snapshot, size_t size) {
+    static_assert(offsetof(FlatAccountHeader, checksum) + sizeof(uint64_t) <= 32, "checksum must sit in the first block");
+    const uint64_t k1 = 0x9E3779B185EBCA87ull, k2 = 0xC2B2AE3D27D4EB4Full;
+    uint64_t lanes[4] = { k1 + k2, k2, 0, 0 - k1 };
+    auto round = [&](const uint8_t* block) {
+        for (int lane = 0; lane < 4; ++lane) {
+            uint64_t w;
+            std::memcpy(&w, block + lane * 8, 8);
+            lanes[lane] += w * k2;
+            lanes[lane] = (lanes[lane] << 31) | (lanes[lane] >> 33);
+            lanes[lane] *= k1;
+        }
+    };
+    uint8_t first[32];
+    std::memcpy(first, snapshot, sizeof(first));
+    std::memset(first + offsetof(FlatAccountHeader, checksum), 0, sizeof(uint64_t));
+    round(first);
+    for (size_t i = 32; i + 32 <= size; i += 32)
+        round(snapshot + i);
+    uint64_t h = size;
+    for (uint64_t lane : lanes) {
+        h ^= lane;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+    }
+    return h;
+}
+
+// Writes account as a snapshot of FlatAccountSize(account) bytes at out, which must be 8 byte aligned
+inline void WriteFlatAccount(const Account& account, uint8_t* out) {
+    if (account.Name.size() >= kFlatAccountNameCapacity)
+        throw std::runtime_error("Account name too long for a flat snapshot: " + std::string(account.Name.data(), account.Name.size()));
+    if (account.Orders.size() > UINT32_MAX)
+        throw std::runtime_error("Too many orders for a flat snapshot");
+
+    FlatAccountHeader& header = *reinterpret_cast<FlatAccountHeader*>(out);
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kFlatAccountMagic;
+    header.version = kFlatAccountVersion;
+    header.header_size = sizeof(FlatAccountHeader);
+    header.total_size = FlatAccountSize(account);
+    header.id = account.Id;
+    header.name_length = static_cast<uint32_t>(account.Name.size());
+    std::memcpy(header.name, account.Name.data(), account.Name.size());
+    std::memcpy(header.currency, account.Wallet.Currency, sizeof(account.Wallet.Currency));
+    header.amount = account.Wallet.Amount;
+    header.order_count = static_cast<uint32_t>(account.Orders.size());
+    header.orders_offset = sizeof(FlatAccountHeader);
+
+    uint8_t* region = out + header.orders_offset;
+    if constexpr (kFlatOrderMatchesOrder) {
+        if (!account.Orders.empty())
+            std::memcpy(region, account.Orders.data(), account.Orders.size() * sizeof(FlatOrder));
+    } else {
+        FlatOrder* orders = reinterpret_cast<FlatOrder*>(region);
+        for (const auto& order : account.Orders) {
+            orders->Id = order.Id;
+            std::memcpy(orders->Symbol, order.Symbol, sizeof(orders->Symbol));
+            orders->Side = static_cast<uint8_t>(order.Side);
+            orders->Type = static_cast<uint8_t>(order.Type);
+            orders->Price = order.Price;
+            orders->Volume = order.Volume;
+            ++orders;
+        }
+    }
+    header.checksum = FlatAccountChecksum(out, header.total_size);
+}
+
+// Read-only access to a validated snapshot in someone else's memory (a mapping, a read buffer)
+class FlatAccountView {
+public:
+    // Why data[0, size) does not start with a usable snapshot, nullptr if it does.
+    // Only the snapshot's own total_size bytes are looked at, the rest of size may be other snapshots
+    static const char* Check(const uint8_t* data, size_t size, bool verify_checksum = true) {
+        if (reinterpret_cast<uintptr_t>(data) % alignof(FlatAccountHeader) != 0) return "snapshot is not 8 byte aligned";
+        if (size < sizeof(FlatAccountHeader)) return "truncated snapshot header";
+        const FlatAccountHeader& header = *reinterpret_cast<const FlatAccountHeader*>(data);
+        if (header.magic != kFlatAccountMagic) return "not a flat account snapshot (or other byte order)";
+        if (header.version != kFlatAccountVersion || header.header_size != sizeof(FlatAccountHeader)) return "unsupported snapshot version";
+        if (header.orders_offset < sizeof(FlatAccountHeader) || header.orders_offset % alignof(FlatOrder) != 0) return "bad order region offset";
+        if (header.total_size != header.orders_offset + uint64_t(header.order_count) * sizeof(FlatOrder)) return "size does not match order count";
+        if (header.total_size % 32 != 0) return "size is not a multiple of 32";  // no bytes outside the checksum
+        if (header.total_size > size) return "truncated snapshot";
+        if (header.name_length >= kFlatAccountNameCapacity || header.name[header.name_length] != '\0') return "bad account name";
+        // ToAccount() copies sizeof(Balance::Currency) bytes, the terminator has to be among them
+        if (!std::memchr(header.currency, '\0', sizeof(Balance::Currency))) return "bad wallet currency";
+        const FlatOrder* orders = reinterpret_cast<const FlatOrder*>(data + header.orders_offset);
+        for (uint32_t i = 0; i < header.order_count; ++i)
+            if (orders[i].Side > static_cast<uint8_t>(OrderSide::SELL) || orders[i].Type > static_cast<uint8_t>(OrderType::STOP))
+                return "bad order side or type";
+        if (verify_checksum && FlatAccountChecksum(data, header.total_size) != header.checksum) return "checksum mismatch";
+        return nullptr;
+    }
+
+    // Throws std::runtime_error when Check() fails
+    FlatAccountView(const uint8_t* data, size_t size, bool verify_checksum = true) : data_(data) {
+        if (const char* error = Check(data, size, verify_checksum))
+            throw std::runtime_error(std::string("Invalid flat account snapshot: ") + error);
+    }
+
+    const FlatAccountHeader& header() const { return *reinterpret_cast<const FlatAccountHeader*>(data_); }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return static_cast<size_t>(header().total_size); }
+
+    int32_t id() const { return header().id; }
+    const char* name() const { return header().name; }
+    size_t name_length() const { return header().name_length; }
+    const char* currency() const { return header().currency; }
+    double amount() const { return header().amount; }
+    uint32_t order_count() const { return header().order_count; }
+    const FlatOrder* orders() const { return reinterpret_cast<const FlatOrder*>(data_ + header().orders_offset); }
+
+    // Copies the snapshot into account, reusing Name's and Orders' capacity
+    void ToAccount(Account& account) const {
+        const FlatAccountHeader& h = header();
+        account.Id = h.id;
+        account.Name.assign(h.name, h.name_length);
+        std::memcpy(account.Wallet.Currency, h.currency, sizeof(account.Wallet.Currency));
+        account.Wallet.Amount = h.amount;
+        account.Orders.resize(h.order_count);
+        const FlatOrder* source = orders();
+        if constexpr (kFlatOrderMatchesOrder) {
+            if (h.order_count)
+                std::memcpy(static_cast<void*>(account.Orders.data()), source, h.order_count * sizeof(FlatOrder));
+            return;
+        }
+        for (uint32_t i = 0; i < h.order_count; ++i) {
+            Order& order = account.Orders[i];
+            order.Id = source[i].Id;
+            std::memcpy(order.Symbol, source[i].Symbol, sizeof(order.Symbol));
+            order.Side = static_cast<OrderSide>(source[i].Side);
+            order.Type = static_cast<OrderType>(source[i].Type);
+            order.Price = source[i].Price;
+            order.Volume = source[i].Volume;
+        }
+    }
+
+private:
+    const uint8_t* data_;
+};
+
+// An owned snapshot, 8 byte aligned storage of exactly FlatAccountSize() bytes
+class FlatAccountSnapshot {
+public:
+    FlatAccountSnapshot() = default;
+    explicit FlatAccountSnapshot(const Account& account) { Assign(account); }
+
+    // Rebuilds from account, keeping the storage when it is large enough
+    void Assign(const Account& account) {
+        size_ = FlatAccountSize(account);
+        storage_.resize(size_ / sizeof(uint64_t));
+        WriteFlatAccount(account, data());
+    }
+
+    // Copies and validates a snapshot from raw bytes (a read() buffer), throws on damage
+    void Load(const void* data, size_t size) {
+        storage_.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        if (size) std::memcpy(storage_.data(), data, size);
+        size_ = FlatAccountView(this->data(), size).size();
+    }
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(storage_.data()); }
+    const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(storage_.data()); }
+    size_t size() const { return size_; }
+
+    // Already validated when built or loaded
+    FlatAccountView view() const { return FlatAccountView(data(), size_, false); }
+
+private:
+    std::vector<uint64_t> storage_;
+    size_t size_ = 0;
+};
+
+// Appends account to a checkpoint buffer (snapshots back to back). The buffer is uint64_t words
+// so every snapshot in it stays 8 byte aligned
+inline void AppendFlatAccount(std::vector<uint64_t>& checkpoint, const Account& account) {
+    size_t at = checkpoint.size();
+    checkpoint.resize(at + FlatAccountSize(account) / sizeof(uint64_t));
+    WriteFlatAccount(account, reinterpret_cast<uint8_t*>(checkpoint.data() + at));
+}
+
+// Validates and visits every snapshot of a checkpoint; throws on the first damaged one.
+// data must be 8 byte aligned (an mmap, or a buffer from AppendFlatAccount())
+template <typename F>
+size_t ForEachFlatAccount(const uint8_t* data, size_t size, F&& f, bool verify_checksum = true) {
+    size_t count = 0;
+    for (size_t offset = 0; offset < size; ++count) {
+        FlatAccountView view(data + offset, size - offset, verify_checksum);
+        f(view);
+        offset += view.size();
+    }
+    return count;
+}
+
+}
+
+#endif
@@ -1,6 +1,8 @@
 #include "flatbuffers/trade_generated.h"
+#include "tradeMetrics.h"
 
 #include <algorithm>
+#include <memory_resource>
 
 namespace TradeProto {
 
@@ -18,8 +20,10 @@ struct Order
     void Deserialize(const Trade::flatbuf::Order& value)
     {
         Id = value.id();
-        std::string symbol = value.symbol()->str();
-        std::memcpy(Symbol, symbol.c_str(), std::min(symbol.size() + 1, sizeof(Symbol)));
+        auto symbol = value.symbol();  // copied straight out of the buffer, no std::string temporary
+        size_t length = symbol ? std::min<size_t>(symbol->size(), sizeof(Symbol) - 1) : 0;  // optional in the schema
+        if (length) std::memcpy(Symbol, symbol->c_str(), length);
+        Symbol[length] = '\0';
         Side = (OrderSide)value.side();
         Type = (OrderType)value.type();
         Price = value.price();
@@ -42,8 +46,10 @@ struct Balance
 
     void Deserialize(const Trade::flatbuf::Balance& value)
     {
-        std::string currency = value.currency()->str();
-        std::memcpy(Currency, currency.c_str(), std::min(currency.size() + 1, sizeof(Currency)));
+        auto currency = value.currency();
+        size_t length = currency ? std::min<size_t>(currency->size(), sizeof(Currency) - 1) : 0;
+        if (length) std::memcpy(Currency, currency->c_str(), length);
+        Currency[length] = '\0';
         Amount = value.amount();
     }
 
@@ -52,12 +58,28 @@ struct Balance
 
 struct Account
 {
+    // Name and Orders allocate from the memory resource the account was created with
+    // and keep their capacity across Deserialize calls, so a long-lived account that is
+    // decoded over and over stops allocating once it has seen its largest message
+    int Id;
+    std::pmr::string Name;
+    Balance Wallet;
+    std::pmr::vector<Order> Orders;
+
+    explicit Account(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : Id(0), Name(resource), Orders(resource) {}
+
+    Account(int id, const char* name, const char* currency, double amount,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : Id(id), Name(name, resource), Wallet(currency, amount), Orders(resource) {}
+
     ...
 
     // FlatBuffers serialization
 
     flatbuffers::Offset<Trade::flatbuf::Account> Serialize(flatbuffers::FlatBufferBuilder& builder)
     {
+        TRADE_METRICS_SCOPE(timer, Account, FlatBuffer, Serialize);
         auto wallet = Wallet.Serialize(builder);
         std::vector<flatbuffers::Offset<Trade::flatbuf::Order>> orders;
         for (auto& order : Orders)
@@ -67,16 +89,25 @@ struct Account
 
     void Deserialize(const Trade::flatbuf::Account& value)
     {
+        TRADE_METRICS_SCOPE(timer, Account, FlatBuffer, Deserialize);
         Id = value.id();
-        Name = value.name()->str();
-        Wallet.Deserialize(*value.wallet());
-        Orders.clear();
-        for (auto o : *value.orders())
+        // Every table and string field is optional in fbsSchema.fbs, absent ones decode as empty
+        auto name = value.name();
+        if (name)
+            Name.assign(name->c_str(), name->size());  // reuses Name's buffer
+        else
+            Name.clear();
+        if (auto wallet = value.wallet())
+            Wallet.Deserialize(*wallet);
+        else
         {
-            Order order;
-            order.Deserialize(*o);
-            Orders.emplace_back(order);
+            Wallet.Currency[0] = '\0';  // what the protobuf default wallet decodes to
+            Wallet.Amount = 0;
         }
+        auto orders = value.orders();
+        Orders.resize(orders ? orders->size() : 0);  // sized once from the encoded count, capacity is never given back
+        for (flatbuffers::uoffset_t i = 0; i < Orders.size(); ++i)
+            Orders[i].Deserialize(*orders->Get(i));  // decoded in place, no temporary Order
     }
 
     ...
@@ -0,0 +1,327 @@
+#ifndef MPMC_BUFFER_QUEUE_H
+#define MPMC_BUFFER_QUEUE_H
+
+/* Bounded lock-free multi-producer/multi-consumer queue for handing serialized messages between
+threads, plus the pieces that keep their memory circulating instead of being freed and
+reallocated for every message.
+
+MpmcQueue<T> is Dmitry Vyukov's bounded queue: a power-of-two array of cells, each carrying a
+sequence number that says whether it is free for position p (seq == p) or holds the element of
+position p (seq == p + 1). Producers and consumers each CAS their own position counter and then
+touch only their cell, so there is no lock and no shared write other than the two counters.
+Batch operations claim a whole run of cells with one CAS. Close() sets the top bit of the
+producers' counter, so a push either claimed its cell before the close or fails, and consumers
+know exactly how many elements are left to drain.
+
+SerializedBuffer owns either a FlatBufferBuilder's DetachedBuffer or a protobuf output string.
+BufferRecycler gives both back to producers: builders created with its allocator get their
+blocks from per-size free lists (a DetachedBuffer returns its block when it is destroyed), and
+strings handed to Recycle() keep their capacity for the next SerializeToString. */
+
+#include "flatbuffers/flatbuffers.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+template <typename T>
+class MpmcQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit MpmcQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // False when the queue is full or closed
+    bool TryPush(T&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & kClosed) return false;
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPop(T& value) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Moves as many of values[0, count) in as fit, in order; returns how many (0 once closed)
+    size_t TryPushBatch(T* values, size_t count) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & kClosed) return 0;
+            size_t run = Run(pos, count, 0);
+            if (run == 0) {
+                intptr_t diff = static_cast<intptr_t>(cells_[pos & mask_].sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+                if (diff < 0) return 0;
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + run, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < run; ++i) {
+                    Cell& cell = cells_[(pos + i) & mask_];
+                    cell.value = std::move(values[i]);
+                    cell.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                return run;
+            }
+        }
+    }
+
+    // Moves up to count elements into values, in queue order; returns how many
+    size_t TryPopBatch(T* values, size_t count) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t run = Run(pos, count, 1);
+            if (run == 0) {
+                intptr_t diff = static_cast<intptr_t>(cells_[pos & mask_].sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1);
+                if (diff < 0) return 0;
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + run, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < run; ++i) {
+                    Cell& cell = cells_[(pos + i) & mask_];
+                    values[i] = std::move(cell.value);
+                    cell.sequence.store(pos + i + mask_ + 1, std::memory_order_release);
+                }
+                return run;
+            }
+        }
+    }
+
+    // Blocking forms: spin, then yield, until there is room / an element, or the queue is closed
+    bool Push(T&& value) {
+        for (unsigned spins = 0; !TryPush(std::move(value)); ++spins) {
+            if (closed()) return false;
+            Backoff(spins);
+        }
+        return true;
+    }
+
+    bool Pop(T& value) {
+        for (unsigned spins = 0; !TryPop(value); ++spins) {
+            if (Drained()) return false;
+            Backoff(spins);
+        }
+        return true;
+    }
+
+    size_t PushBatch(T* values, size_t count) {
+        size_t done = 0;
+        for (unsigned spins = 0; done < count; ++spins) {
+            size_t n = TryPushBatch(values + done, count - done);
+            done += n;
+            if (n == 0) {
+                if (closed()) break;
+                Backoff(spins);
+            }
+        }
+        return done;
+    }
+
+    // Waits for at least one element, then takes whatever is there up to count; 0 once closed and drained
+    size_t PopBatch(T* values, size_t count) {
+        for (unsigned spins = 0;; ++spins) {
+            size_t n = TryPopBatch(values, count);
+            if (n != 0) return n;
+            if (Drained()) return 0;
+            Backoff(spins);
+        }
+    }
+
+    // Fails every later push, wakes blocked producers and lets consumers drain what is left
+    void Close() { enqueue_pos_.fetch_or(kClosed, std::memory_order_release); }
+    bool closed() const { return (enqueue_pos_.load(std::memory_order_acquire) & kClosed) != 0; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static constexpr size_t kLine = 64;
+    static constexpr size_t kClosed = ~(~size_t(0) >> 1);  // top bit of enqueue_pos_
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(kLine) std::atomic<size_t> enqueue_pos_{ 0 };
+    alignas(kLine) std::atomic<size_t> dequeue_pos_{ 0 };
+
+    // Number of consecutive cells from pos, at most count, in the state offset says (0 free, 1 full)
+    size_t Run(size_t pos, size_t count, size_t offset) const {
+        size_t run = 0;
+        while (run < count && run <= mask_ &&
+               cells_[(pos + run) & mask_].sequence.load(std::memory_order_acquire) == pos + run + offset)
+            ++run;
+        return run;
+    }
+
+    // Closed, and every element pushed before the close has been claimed by a consumer
+    bool Drained() const {
+        size_t end = enqueue_pos_.load(std::memory_order_acquire);
+        return (end & kClosed) && dequeue_pos_.load(std::memory_order_acquire) >= (end & ~kClosed);
+    }
+
+    static void Backoff(unsigned spins) {
+        if (spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// A finished message: a FlatBufferBuilder's DetachedBuffer or a protobuf output string
+class SerializedBuffer {
+public:
+    SerializedBuffer() = default;
+    SerializedBuffer(flatbuffers::DetachedBuffer&& buffer) : storage_(std::move(buffer)) {}
+    SerializedBuffer(std::string&& buffer) : storage_(std::move(buffer)) {}
+
+    const uint8_t* data() const {
+        if (auto* b = std::get_if<flatbuffers::DetachedBuffer>(&storage_)) return b->data();
+        if (auto* s = std::get_if<std::string>(&storage_)) return reinterpret_cast<const uint8_t*>(s->data());
+        return nullptr;
+    }
+
+    size_t size() const {
+        if (auto* b = std::get_if<flatbuffers::DetachedBuffer>(&storage_)) return b->size();
+        if (auto* s = std::get_if<std::string>(&storage_)) return s->size();
+        return 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    bool is_flatbuffer() const { return std::holds_alternative<flatbuffers::DetachedBuffer>(storage_); }
+    bool is_string() const { return std::holds_alternative<std::string>(storage_); }
+
+    // Takes the string out (for recycling), leaves the buffer empty
+    std::string TakeString() {
+        std::string s;
+        if (auto* p = std::get_if<std::string>(&storage_)) s = std::move(*p);
+        storage_ = std::monostate();
+        return s;
+    }
+
+private:
+    std::variant<std::monostate, flatbuffers::DetachedBuffer, std::string> storage_;
+};
+
+// Returns buffer memory from consumers to producers.
+// Pass allocator() to every FlatBufferBuilder (it must outlive their DetachedBuffers); get
+// protobuf output strings from AcquireString() and hand consumed buffers to Recycle()
+class BufferRecycler {
+public:
+    // per_class: how many free blocks / strings of each kind are kept
+    explicit BufferRecycler(size_t per_class = 256) : allocator_(per_class), strings_(per_class) {}
+
+    flatbuffers::Allocator* allocator() { return &allocator_; }
+
+    // An empty string that usually still has the capacity of a previous message
+    std::string AcquireString() {
+        std::string s;
+        if (strings_.TryPop(s)) s.clear();
+        return s;
+    }
+
+    // Drops the message; its memory goes back to the free lists
+    void Recycle(SerializedBuffer&& buffer) {
+        if (buffer.is_string()) {
+            std::string s = buffer.TakeString();
+            if (s.capacity() > 0) strings_.TryPush(std::move(s));  // full: just free it
+        } else {
+            buffer = SerializedBuffer();  // DetachedBuffer hands its block to the allocator
+        }
+    }
+
+private:
+    // Power-of-two size classes from 256 bytes to 16 MB, each with a lock-free free list
+    class RecyclingAllocator : public flatbuffers::Allocator {
+    public:
+        explicit RecyclingAllocator(size_t per_class) {
+            for (auto& list : free_) list.reset(new MpmcQueue<uint8_t*>(per_class));
+        }
+
+        ~RecyclingAllocator() override {
+            uint8_t* p;
+            for (auto& list : free_)
+                while (list->TryPop(p)) delete[] p;
+        }
+
+        uint8_t* allocate(size_t size) override {
+            size_t cls = Class(size);
+            uint8_t* p;
+            if (cls < kClasses && free_[cls]->TryPop(p)) return p;
+            return new uint8_t[cls < kClasses ? (kMinBlock << cls) : size];
+        }
+
+        void deallocate(uint8_t* p, size_t size) override {
+            size_t cls = Class(size);
+            if (cls < kClasses && free_[cls]->TryPush(std::move(p))) return;
+            delete[] p;
+        }
+
+    private:
+        static constexpr size_t kMinBlock = 256;
+        static constexpr size_t kClasses = 17;  // 256 B .. 16 MB
+
+        std::unique_ptr<MpmcQueue<uint8_t*>> free_[kClasses];
+
+        static size_t Class(size_t size) {
+            size_t cls = 0;
+            while ((kMinBlock << cls) < size && cls < kClasses) ++cls;
+            return cls;
+        }
+    };
+
+    RecyclingAllocator allocator_;
+    MpmcQueue<std::string> strings_;
+};
+
+#endif // MPMC_BUFFER_QUEUE_H
@@ -0,0 +1,174 @@
+#include "../proto/trade.h"
+#include "mpmcBufferQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Hand-off of serialized messages from producer to consumer threads, the way it is done today
+// (mutex + std::queue<std::string>) against MpmcQueue with recycled strings, one at a time and in
+// batches, and with FlatBuffers Accounts passed as DetachedBuffers, their blocks coming from the
+// default allocator or from BufferRecycler's RecyclingAllocator
+namespace {
+
+const size_t kMessages = 1 << 20;
+const size_t kMessageSize = 160;  // about a serialized Account with three orders
+const size_t kBatch = 32;
+
+struct MutexQueue {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::queue<std::string> queue;
+};
+
+// Runs producers/consumers until every message went through, returns messages per second
+template <typename Produce, typename Consume>
+double Run(size_t producers, size_t consumers, Produce produce, Consume consume)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < producers; ++p)
+        threads.emplace_back([&, p] { produce(kMessages / producers + (p < kMessages % producers ? 1 : 0)); });
+    for (size_t c = 0; c < consumers; ++c)
+        threads.emplace_back([&] { consume(); });
+    for (auto& t : threads)
+        t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return kMessages / seconds;
+}
+
+double MutexBaseline(size_t producers, size_t consumers)
+{
+    MutexQueue q;
+    std::atomic<size_t> consumed{ 0 };
+    return Run(producers, consumers,
+        [&](size_t count) {
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::string message(kMessageSize, static_cast<char>(i));  // fresh allocation per message
+                {
+                    std::lock_guard<std::mutex> lock(q.mutex);
+                    q.queue.push(std::move(message));
+                }
+                q.ready.notify_one();
+            }
+        },
+        [&] {
+            std::string message;
+            while (consumed.load(std::memory_order_relaxed) < kMessages)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(q.mutex);
+                    if (!q.ready.wait_for(lock, std::chrono::milliseconds(1), [&] { return !q.queue.empty(); }))
+                        continue;
+                    message = std::move(q.queue.front());
+                    q.queue.pop();
+                }
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+}
+
+double Mpmc(size_t producers, size_t consumers, size_t batch)
+{
+    MpmcQueue<SerializedBuffer> q(4096);
+    BufferRecycler recycler(4096);
+    std::atomic<size_t> consumed{ 0 };
+    return Run(producers, consumers,
+        [&](size_t count) {
+            std::vector<SerializedBuffer> out(batch);
+            for (size_t i = 0; i < count; i += batch)
+            {
+                size_t n = std::min(batch, count - i);
+                for (size_t k = 0; k < n; ++k)
+                {
+                    std::string message = recycler.AcquireString();  // keeps a previous message's capacity
+                    message.resize(kMessageSize, static_cast<char>(i + k));
+                    out[k] = SerializedBuffer(std::move(message));
+                }
+                if (batch == 1)
+                    q.Push(std::move(out[0]));
+                else
+                    q.PushBatch(out.data(), n);
+            }
+        },
+        [&] {
+            std::vector<SerializedBuffer> in(batch);
+            while (consumed.load(std::memory_order_relaxed) < kMessages)
+            {
+                size_t n = batch == 1 ? q.TryPop(in[0]) : q.TryPopBatch(in.data(), batch);
+                if (n == 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (size_t k = 0; k < n; ++k)
+                    recycler.Recycle(std::move(in[k]));
+                consumed.fetch_add(n, std::memory_order_relaxed);
+            }
+        });
+}
+
+// Producers build an Account per message and queue the builder's DetachedBuffer. recycle picks
+// BufferRecycler's allocator over the default one: consumers dropping a buffer then return its
+// block to the free list the next builder allocates from
+double MpmcFlatBuffers(size_t producers, size_t consumers, bool recycle)
+{
+    BufferRecycler recycler(4096);  // outlives the queue, whose buffers may hold its blocks
+    MpmcQueue<SerializedBuffer> q(4096);
+    std::atomic<size_t> consumed{ 0 };
+    TradeProto::Account account(1, "Account 1", "USD", 1000000);
+    account.Orders.emplace_back(1, "EURUSD", TradeProto::OrderSide::BUY, TradeProto::OrderType::LIMIT, 1.0875, 100000);
+    account.Orders.emplace_back(2, "GBPUSD", TradeProto::OrderSide::SELL, TradeProto::OrderType::MARKET, 1.2650, 50000);
+    account.Orders.emplace_back(3, "USDJPY", TradeProto::OrderSide::BUY, TradeProto::OrderType::STOP, 151.20, 25000);
+    return Run(producers, consumers,
+        [&](size_t count) {
+            flatbuffers::FlatBufferBuilder builder(1024, recycle ? recycler.allocator() : nullptr);
+            for (size_t i = 0; i < count; ++i)
+            {
+                builder.Finish(account.Serialize(builder));
+                q.Push(SerializedBuffer(builder.Release()));  // the builder takes a fresh block next time
+            }
+        },
+        [&] {
+            SerializedBuffer message;
+            while (consumed.load(std::memory_order_relaxed) < kMessages)
+            {
+                if (!q.TryPop(message))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                recycler.Recycle(std::move(message));
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::cout << std::setw(10) << "producers" << std::setw(10) << "consumers" << std::setw(17) << "mutex queue" << std::setw(17) << "mpmc"
+        << std::setw(15) << "mpmc x" << kBatch << std::setw(17) << "fb new" << std::setw(17) << "fb recycled" << std::endl;
+    for (size_t threads = 2; threads <= 64; threads *= 2)
+    {
+        size_t producers = threads / 2;
+        size_t consumers = threads / 2;
+        std::cout << std::setw(10) << producers << std::setw(10) << consumers
+            << std::setw(13) << static_cast<long long>(MutexBaseline(producers, consumers) / 1000) << " k/s"
+            << std::setw(13) << static_cast<long long>(Mpmc(producers, consumers, 1) / 1000) << " k/s"
+            << std::setw(13) << static_cast<long long>(Mpmc(producers, consumers, kBatch) / 1000) << " k/s"
+            << std::setw(13) << static_cast<long long>(MpmcFlatBuffers(producers, consumers, false) / 1000) << " k/s"
+            << std::setw(13) << static_cast<long long>(MpmcFlatBuffers(producers, consumers, true) / 1000) << " k/s"
+            << std::endl;
+    }
+    return 0;
+}
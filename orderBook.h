@@ -0,0 +1,331 @@
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+/* Price-level order book for one symbol, fed directly from TradeProto / FlatBuffers / protobuf orders.
+
+Layout is chosen for the update path, which is what streams hammer:
+- each side is a sorted std::vector<Level> with the best price at the back, so the levels
+  that change most are at the cheap end of insert/erase and binary search runs over a few
+  cache lines of contiguous memory;
+- resting orders live in one pooled vector, chained per level in FIFO (time priority) order
+  through 32 bit indices, with freed entries reused;
+- order id -> pool index is an open-addressing table (linear probing, backward-shift delete),
+  so cancel and modify never search.
+Prices are kept as integer ticks so levels compare exactly.
+
+Apply() gives stream semantics: volume 0 cancels, a known id is modified, a new limit order is
+added; market and stop orders never rest and are ignored. A known id arriving on the other side
+is cancelled and re-added there, at the back of its new level. The Order and Account overloads
+skip orders whose symbol is not the book's. Snapshot() writes the book as a
+Trade::flatbuf::Account: name is the symbol and every price level becomes one Order (limit, the
+level's price and total volume, id = number of orders resting there), bids first, best first. */
+
+#include "../proto/trade.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace TradeProto {
+
+class OrderBook {
+public:
+    struct Level {
+        int64_t ticks;
+        double volume;     // sum of resting volume
+        uint32_t count;    // resting orders
+        uint32_t head;     // oldest order (pool index)
+        uint32_t tail;     // newest order
+    };
+
+    explicit OrderBook(std::string symbol, double tick_size = 0.00001, size_t expected_orders = 1024)
+        : symbol_(std::move(symbol)), tick_size_(tick_size) {
+        orders_.reserve(expected_orders);
+        ids_.Reserve(expected_orders);
+    }
+
+    // Adds a resting limit order; false if the id is already in the book or volume is not positive
+    bool Add(int id, OrderSide side, double price, double volume) {
+        if (volume <= 0.0 || ids_.Find(id) != kNone) return false;
+        uint32_t index = NewOrder(id, side, ToTicks(price), volume);
+        ids_.Insert(id, index);
+        Link(index);
+        return true;
+    }
+
+    bool Cancel(int id) {
+        uint32_t index = ids_.Find(id);
+        if (index == kNone) return false;
+        Unlink(index);
+        ids_.Erase(id);
+        FreeOrder(index);
+        return true;
+    }
+
+    // Changes price and/or volume. Keeps time priority only when the volume goes down at the same price
+    bool Modify(int id, double price, double volume) {
+        uint32_t index = ids_.Find(id);
+        if (index == kNone) return false;
+        if (volume <= 0.0) return Cancel(id);
+        Resting& order = orders_[index];
+        int64_t ticks = ToTicks(price);
+        if (ticks == order.ticks && volume <= order.volume) {
+            FindLevel(order.side, ticks)->volume -= order.volume - volume;
+            order.volume = volume;
+            return true;
+        }
+        Unlink(index);
+        order.ticks = ticks;
+        order.volume = volume;
+        Link(index);
+        return true;
+    }
+
+    // Stream update: cancel on zero volume, modify a known id (cancel and add on a side change),
+    // add a new limit order
+    bool Apply(int id, OrderSide side, OrderType type, double price, double volume) {
+        if (volume <= 0.0) return Cancel(id);
+        uint32_t index = ids_.Find(id);
+        if (index != kNone) {
+            if (orders_[index].side == side) return Modify(id, price, volume);
+            Cancel(id);
+            if (type == OrderType::LIMIT) Add(id, side, price, volume);
+            return true;
+        }
+        if (type != OrderType::LIMIT) return false;
+        return Add(id, side, price, volume);
+    }
+
+    // Orders for another symbol do not change the book and return false
+    bool Apply(const Order& order) {
+        if (symbol_ != order.Symbol) return false;
+        return Apply(order.Id, order.Side, order.Type, order.Price, order.Volume);
+    }
+
+    bool Apply(const Trade::flatbuf::Order& order) {
+        const flatbuffers::String* symbol = order.symbol();
+        if (!symbol || symbol->size() != symbol_.size() || std::memcmp(symbol->c_str(), symbol_.data(), symbol_.size()) != 0) return false;
+        return Apply(order.id(), (OrderSide)order.side(), (OrderType)order.type(), order.price(), order.volume());
+    }
+
+    bool Apply(const Trade::protobuf::Order& order) {
+        if (order.symbol() != symbol_) return false;
+        return Apply(order.id(), (OrderSide)order.side(), (OrderType)order.type(), order.price(), order.volume());
+    }
+
+    // Every order of an account buffer for this symbol, straight from the wire types; returns how
+    // many changed the book
+    size_t Apply(const Trade::flatbuf::Account& account) {
+        size_t changed = 0;
+        if (auto* orders = account.orders())
+            for (flatbuffers::uoffset_t i = 0; i < orders->size(); ++i) changed += Apply(*orders->Get(i));
+        return changed;
+    }
+
+    size_t Apply(const Trade::protobuf::Account& account) {
+        size_t changed = 0;
+        for (const auto& order : account.orders()) changed += Apply(order);
+        return changed;
+    }
+
+    // Levels with the best price at the back
+    const std::vector<Level>& bids() const { return bids_; }
+    const std::vector<Level>& asks() const { return asks_; }
+
+    bool BestBid(double& price, double& volume) const { return Best(bids_, price, volume); }
+    bool BestAsk(double& price, double& volume) const { return Best(asks_, price, volume); }
+
+    size_t size() const { return ids_.size(); }
+    double ToPrice(int64_t ticks) const { return static_cast<double>(ticks) * tick_size_; }
+
+    // Writes the book as an Account (see above); depth limits levels per side, 0 for all
+    flatbuffers::Offset<Trade::flatbuf::Account> Snapshot(flatbuffers::FlatBufferBuilder& builder, int account_id, size_t depth = 0) const {
+        std::vector<flatbuffers::Offset<Trade::flatbuf::Order>> levels;
+        size_t bid_levels = depth ? std::min(depth, bids_.size()) : bids_.size();
+        size_t ask_levels = depth ? std::min(depth, asks_.size()) : asks_.size();
+        levels.reserve(bid_levels + ask_levels);
+        auto symbol = builder.CreateString(symbol_);  // shared by every level and the account name
+        auto add = [&](const std::vector<Level>& side, size_t count, Trade::flatbuf::OrderSide fb_side) {
+            for (size_t i = 0; i < count; ++i) {
+                const Level& level = side[side.size() - 1 - i];
+                levels.push_back(Trade::flatbuf::CreateOrder(builder, static_cast<int32_t>(level.count), symbol, fb_side,
+                                                             Trade::flatbuf::OrderType_limit, ToPrice(level.ticks), level.volume));
+            }
+        };
+        add(bids_, bid_levels, Trade::flatbuf::OrderSide_buy);
+        add(asks_, ask_levels, Trade::flatbuf::OrderSide_sell);
+        return Trade::flatbuf::CreateAccount(builder, account_id, symbol, 0, builder.CreateVector(levels));
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Resting {
+        int id;
+        OrderSide side;
+        int64_t ticks;
+        double volume;
+        uint32_t prev;
+        uint32_t next;  // also the free list link
+    };
+
+    // int id -> uint32 index, open addressing with linear probing
+    class IdMap {
+    public:
+        void Reserve(size_t count) {
+            size_t capacity = 16;
+            while (capacity < count * 2) capacity <<= 1;
+            if (capacity > slots_.size()) Rehash(capacity);
+        }
+
+        uint32_t Find(int id) const {
+            if (slots_.empty()) return kNone;
+            for (size_t i = Home(id);; i = (i + 1) & mask_) {
+                const Slot& s = slots_[i];
+                if (s.index == kNone) return kNone;
+                if (s.id == id) return s.index;
+            }
+        }
+
+        void Insert(int id, uint32_t index) {
+            if ((size_ + 1) * 2 > slots_.size()) Rehash(slots_.empty() ? 16 : slots_.size() * 2);
+            size_t i = Home(id);
+            while (slots_[i].index != kNone) i = (i + 1) & mask_;
+            slots_[i] = { id, index };
+            ++size_;
+        }
+
+        void Erase(int id) {
+            size_t i = Home(id);
+            while (slots_[i].id != id || slots_[i].index == kNone) {
+                if (slots_[i].index == kNone) return;
+                i = (i + 1) & mask_;
+            }
+            // Backward shift: pull later entries of the probe run into the hole, no tombstones
+            for (size_t j = (i + 1) & mask_; slots_[j].index != kNone; j = (j + 1) & mask_) {
+                size_t home = Home(slots_[j].id);
+                if (((j - home) & mask_) >= ((j - i) & mask_)) {
+                    slots_[i] = slots_[j];
+                    i = j;
+                }
+            }
+            slots_[i].index = kNone;
+            --size_;
+        }
+
+        size_t size() const { return size_; }
+
+    private:
+        struct Slot {
+            int id;
+            uint32_t index = kNone;
+        };
+        std::vector<Slot> slots_;
+        size_t mask_ = 0;
+        unsigned shift_ = 64;
+        size_t size_ = 0;
+
+        size_t Home(int id) const {
+            return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ull) >> shift_);
+        }
+
+        void Rehash(size_t capacity) {
+            std::vector<Slot> old;
+            old.swap(slots_);
+            slots_.assign(capacity, Slot());
+            mask_ = capacity - 1;
+            shift_ = 64;
+            for (size_t c = capacity; c > 1; c >>= 1) --shift_;
+            size_ = 0;
+            for (const Slot& s : old)
+                if (s.index != kNone) Insert(s.id, s.index);
+        }
+    };
+
+    std::string symbol_;
+    double tick_size_;
+    std::vector<Level> bids_;    // ascending, best (highest) at the back
+    std::vector<Level> asks_;    // descending, best (lowest) at the back
+    std::vector<Resting> orders_;
+    uint32_t free_ = kNone;
+    IdMap ids_;
+
+    int64_t ToTicks(double price) const { return std::llround(price / tick_size_); }
+
+    bool Best(const std::vector<Level>& side, double& price, double& volume) const {
+        if (side.empty()) return false;
+        price = ToPrice(side.back().ticks);
+        volume = side.back().volume;
+        return true;
+    }
+
+    uint32_t NewOrder(int id, OrderSide side, int64_t ticks, double volume) {
+        Resting order{ id, side, ticks, volume, kNone, kNone };
+        if (free_ != kNone) {
+            uint32_t index = free_;
+            free_ = orders_[index].next;
+            orders_[index] = order;
+            return index;
+        }
+        orders_.push_back(order);
+        return static_cast<uint32_t>(orders_.size() - 1);
+    }
+
+    void FreeOrder(uint32_t index) {
+        orders_[index].next = free_;
+        free_ = index;
+    }
+
+    // Position of ticks in a side's vector (best at the back)
+    static std::vector<Level>::iterator LowerBound(std::vector<Level>& levels, OrderSide side, int64_t ticks) {
+        if (side == OrderSide::BUY)
+            return std::lower_bound(levels.begin(), levels.end(), ticks, [](const Level& l, int64_t t) { return l.ticks < t; });
+        return std::lower_bound(levels.begin(), levels.end(), ticks, [](const Level& l, int64_t t) { return l.ticks > t; });
+    }
+
+    std::vector<Level>& Side(OrderSide side) { return side == OrderSide::BUY ? bids_ : asks_; }
+
+    Level* FindLevel(OrderSide side, int64_t ticks) {
+        std::vector<Level>& levels = Side(side);
+        auto it = LowerBound(levels, side, ticks);
+        return it != levels.end() && it->ticks == ticks ? &*it : nullptr;
+    }
+
+    // Appends the order to its level's queue, creating the level if needed
+    void Link(uint32_t index) {
+        Resting& order = orders_[index];
+        std::vector<Level>& levels = Side(order.side);
+        auto it = LowerBound(levels, order.side, order.ticks);
+        if (it == levels.end() || it->ticks != order.ticks) it = levels.insert(it, Level{ order.ticks, 0.0, 0, kNone, kNone });
+        Level& level = *it;
+        order.prev = level.tail;
+        order.next = kNone;
+        if (level.tail != kNone) orders_[level.tail].next = index;
+        else level.head = index;
+        level.tail = index;
+        level.volume += order.volume;
+        ++level.count;
+    }
+
+    // Takes the order out of its level's queue, dropping the level when it empties
+    void Unlink(uint32_t index) {
+        Resting& order = orders_[index];
+        std::vector<Level>& levels = Side(order.side);
+        auto it = LowerBound(levels, order.side, order.ticks);
+        Level& level = *it;
+        if (order.prev != kNone) orders_[order.prev].next = order.next;
+        else level.head = order.next;
+        if (order.next != kNone) orders_[order.next].prev = order.prev;
+        else level.tail = order.prev;
+        if (--level.count == 0) levels.erase(it);
+        else level.volume -= order.volume;
+    }
+};
+
+} // namespace TradeProto
+
+#endif // ORDER_BOOK_H
@@ -0,0 +1,147 @@
+#include "orderBook.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Sustained update rate of OrderBook against the std::map book applications build today,
+// on the same random add / modify / cancel stream around a drifting mid price
+namespace {
+
+const size_t kUpdates = 10000000;
+const size_t kLive = 20000;  // resting orders the stream keeps around
+
+std::vector<TradeProto::Order> MakeStream()
+{
+    std::mt19937_64 rng(42);
+    std::vector<TradeProto::Order> stream;
+    stream.reserve(kUpdates);
+    std::vector<std::pair<int, bool>> live;  // id, buy
+    int next_id = 1;
+    double mid = 1.10000;
+    for (size_t i = 0; i < kUpdates; ++i)
+    {
+        mid += (static_cast<int>(rng() % 3) - 1) * 0.00001;
+        mid = std::min(1.10050, std::max(1.09950, mid));  // wanders, but stays in a realistic band
+        unsigned action = rng() % 4;
+        bool add = live.size() < kLive || action == 0;
+        size_t pick = add ? 0 : rng() % live.size();
+        bool buy = add ? (rng() & 1) != 0 : live[pick].second;  // the side of an existing order does not change
+        double price = mid + (buy ? -1.0 : 1.0) * static_cast<double>(1 + rng() % 50) * 0.00001;
+        double volume = static_cast<double>(1 + rng() % 100) * 1000;
+        auto side = buy ? TradeProto::OrderSide::BUY : TradeProto::OrderSide::SELL;
+        if (add)
+        {
+            stream.emplace_back(next_id, "EURUSD", side, TradeProto::OrderType::LIMIT, price, volume);
+            live.emplace_back(next_id++, buy);
+        }
+        else
+        {
+            int id = live[pick].first;
+            if (action != 3)  // modify
+                stream.emplace_back(id, "EURUSD", side, TradeProto::OrderType::LIMIT, price, volume);
+            else              // cancel
+            {
+                stream.emplace_back(id, "EURUSD", side, TradeProto::OrderType::LIMIT, 0.0, 0.0);
+                live[pick] = live.back();
+                live.pop_back();
+            }
+        }
+    }
+    return stream;
+}
+
+// The std::map version: price -> volume per side plus id -> order
+struct MapBook
+{
+    struct Entry { TradeProto::OrderSide side; double price; double volume; };
+    std::map<double, double, std::greater<double>> bids;
+    std::map<double, double> asks;
+    std::unordered_map<int, Entry> orders;
+
+    void Remove(const Entry& e)
+    {
+        if (e.side == TradeProto::OrderSide::BUY) { auto it = bids.find(e.price); if ((it->second -= e.volume) <= 0.0) bids.erase(it); }
+        else { auto it = asks.find(e.price); if ((it->second -= e.volume) <= 0.0) asks.erase(it); }
+    }
+
+    void Insert(const Entry& e)
+    {
+        if (e.side == TradeProto::OrderSide::BUY) bids[e.price] += e.volume;
+        else asks[e.price] += e.volume;
+    }
+
+    void Apply(const TradeProto::Order& order)
+    {
+        auto it = orders.find(order.Id);
+        if (it != orders.end())
+        {
+            Remove(it->second);
+            if (order.Volume <= 0.0) { orders.erase(it); return; }
+            it->second.price = order.Price;
+            it->second.volume = order.Volume;
+            Insert(it->second);
+            return;
+        }
+        if (order.Volume <= 0.0) return;
+        Entry e{ order.Side, order.Price, order.Volume };
+        orders.emplace(order.Id, e);
+        Insert(e);
+    }
+};
+
+template <typename Fn>
+double Rate(Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return kUpdates / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<TradeProto::Order> stream = MakeStream();
+
+    MapBook map_book;
+    double map_rate = Rate([&] { for (const auto& order : stream) map_book.Apply(order); });
+
+    TradeProto::OrderBook book("EURUSD", 0.00001, kLive * 2);
+    double book_rate = Rate([&] { for (const auto& order : stream) book.Apply(order); });
+
+    std::cout << "std::map book: " << map_rate << " M updates/s" << std::endl;
+    std::cout << "OrderBook:     " << book_rate << " M updates/s" << std::endl;
+    std::cout << "Resting orders: " << book.size() << ", bid levels: " << book.bids().size() << ", ask levels: " << book.asks().size() << std::endl;
+
+    // Ingest straight from FlatBuffer Accounts carrying the same stream, 100 orders per buffer
+    std::vector<flatbuffers::DetachedBuffer> buffers;
+    for (size_t i = 0; i < stream.size(); i += 100)
+    {
+        flatbuffers::FlatBufferBuilder builder;
+        std::vector<flatbuffers::Offset<Trade::flatbuf::Order>> orders;
+        for (size_t k = i; k < std::min(stream.size(), i + 100); ++k)
+            orders.push_back(stream[k].Serialize(builder));
+        builder.Finish(Trade::flatbuf::CreateAccountDirect(builder, 1, "feed", 0, &orders));
+        buffers.push_back(builder.Release());
+    }
+    TradeProto::OrderBook fb_book("EURUSD", 0.00001, kLive * 2);
+    double fb_rate = Rate([&] { for (const auto& buffer : buffers) fb_book.Apply(*Trade::flatbuf::GetAccount(buffer.data())); });
+    std::cout << "OrderBook from FlatBuffers: " << fb_rate << " M updates/s" << std::endl;
+
+    // Top of book as an Account FlatBuffer
+    flatbuffers::FlatBufferBuilder snapshot;
+    snapshot.Finish(book.Snapshot(snapshot, 1, 5));
+    std::cout << "Snapshot (5 levels per side): " << snapshot.GetSize() << " bytes" << std::endl;
+    double price, volume;
+    if (book.BestBid(price, volume)) std::cout << "Best bid: " << price << " x " << volume << std::endl;
+    if (book.BestAsk(price, volume)) std::cout << "Best ask: " << price << " x " << volume << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,537 @@
+/* Generates the protobuf <-> flatcc converter header that practTemplate.txt used to produce
+through T4, straight from a compiled FlatBuffers schema (.bfbs), so it runs in the Linux build:
+
+    pbToFbGenerator accounts.bfbs accounts [--outer-namespace FACE::DM] [-o accounts_Generated_PBtoFB.h]
+
+For every table/struct X in namespace ns it emits
+    Create<X>FromPB(flatcc_builder_t*, const ns::X&)        pb -> fb, tables
+    Create<X>FromPB(ns_X_t*, const ns::X&)                  pb -> fb, structs
+    CreatePBFrom<X>(ns_X_table_t / ns_X_struct_t, ns::X&)   fb -> pb
+in dependency order, honouring the composite_view, sub_template and fixed_array_sequence attributes.
+
+Differences from the template's output, all on the hot path:
+ - fixed-length arrays are copied with one memcpy each way (the template left them unhandled)
+ - sequenceBytes and scalar vectors whose element width matches protobuf's are created / filled
+   in bulk instead of one add_<field>() or push per element
+ - repeated protobuf fields are Reserve()d to the FlatBuffers length before being filled
+ - vectors of fixed_array_sequence structs are extended once for all elements
+ - strings go through the (pointer, length) builder/setter overloads, so nothing calls strlen or
+   builds a std::string temporary
+
+A struct made of a single scalar array also gets the template's CreatePBFrom<X>(root, T (&o_)[N])
+overload. CMakeLists.txt builds the generator and regenerates the header for fbsSchema.fbs. */
+
+#include "flatbuffers/flatbuffers.h"
+#include "reflection_generated.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class PBtoFBGenerator {
+public:
+    PBtoFBGenerator(const reflection::SchemaT& schema, std::string module, std::string outer_namespace)
+        : schema_(schema), module_(std::move(module)), outer_namespace_(std::move(outer_namespace)) {}
+
+    std::string Generate() {
+        out_.str("");
+        std::string guard = module_;
+        std::transform(guard.begin(), guard.end(), guard.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+        out_ << "// Generated by pbToFbGenerator from " << module_ << ".bfbs, do not edit\n\n";
+        out_ << "#ifndef " << guard << "_GENERATED_PBTOFB_H_\n";
+        out_ << "#define " << guard << "_GENERATED_PBTOFB_H_\n\n";
+        out_ << "#include <cstring>\n\n";
+        out_ << "#include \"" << module_ << "_reader.h\"\n";
+        out_ << "#include \"" << module_ << "_builder.h\"\n\n";
+
+        std::vector<std::string> outer = Split(outer_namespace_, "::");
+        for (const auto& ns : outer) out_ << "namespace " << ns << " {\n";
+        if (!outer.empty()) out_ << "\n";
+
+        for (const reflection::ObjectT* obj : ObjectsByDependency()) {
+            if (obj->name.find("ALLTYPEDEFS") != std::string::npos) continue;  // internal/metadata
+            GenerateObject(*obj);
+        }
+
+        for (auto it = outer.rbegin(); it != outer.rend(); ++it) out_ << "} // namespace " << *it << "\n";
+        out_ << "\n#endif  // " << guard << "_GENERATED_PBTOFB_H_\n";
+        return out_.str();
+    }
+
+private:
+    const reflection::SchemaT& schema_;
+    std::string module_;
+    std::string outer_namespace_;
+    std::ostringstream out_;
+
+    // "Trade.flatbuf.Order" -> C prefix "Trade_flatbuf", C++ namespace "Trade::flatbuf", name "Order"
+    struct QualifiedName {
+        std::string c_prefix;
+        std::string cpp_namespace;
+        std::string name;
+        std::string CType() const { return c_prefix + "_" + name; }
+        std::string CppType() const { return cpp_namespace + "::" + name; }
+    };
+
+    static std::vector<std::string> Split(const std::string& text, const std::string& sep) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        while (start <= text.size() && !text.empty()) {
+            size_t end = text.find(sep, start);
+            if (end == std::string::npos) end = text.size();
+            if (end > start) parts.push_back(text.substr(start, end - start));
+            start = end + sep.size();
+        }
+        return parts;
+    }
+
+    static std::string Join(const std::vector<std::string>& parts, size_t count, const std::string& sep) {
+        std::string joined;
+        for (size_t i = 0; i < count; ++i) joined += (i ? sep : "") + parts[i];
+        return joined;
+    }
+
+    static QualifiedName Qualify(const std::string& full_name) {
+        std::vector<std::string> parts = Split(full_name, ".");
+        if (parts.empty()) throw std::runtime_error("Empty type name in schema");
+        QualifiedName q;
+        q.name = parts.back();
+        q.c_prefix = Join(parts, parts.size() - 1, "_");
+        q.cpp_namespace = Join(parts, parts.size() - 1, "::");
+        return q;
+    }
+
+    // Protobuf accessors are the lower-cased field name
+    static std::string PB(const std::string& field_name) {
+        std::string lower = field_name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return lower;
+    }
+
+    static bool HasAttribute(const std::vector<std::unique_ptr<reflection::KeyValueT>>& attributes, const std::string& key, std::string* value = nullptr) {
+        for (const auto& a : attributes) {
+            if (a->key == key) {
+                if (value) *value = a->value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // flatcc scalar name, as in flatbuffers_<name>_vec_t
+    static const char* FlatccScalar(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool: return "bool";
+        case reflection::BaseType_Byte: return "int8";
+        case reflection::BaseType_UByte: return "uint8";
+        case reflection::BaseType_Short: return "int16";
+        case reflection::BaseType_UShort: return "uint16";
+        case reflection::BaseType_Int: return "int32";
+        case reflection::BaseType_UInt: return "uint32";
+        case reflection::BaseType_Long: return "int64";
+        case reflection::BaseType_ULong: return "uint64";
+        case reflection::BaseType_Float: return "float";
+        case reflection::BaseType_Double: return "double";
+        default: throw std::runtime_error("Not a scalar type");
+        }
+    }
+
+    static size_t ScalarSize(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool:
+        case reflection::BaseType_Byte:
+        case reflection::BaseType_UByte: return 1;
+        case reflection::BaseType_Short:
+        case reflection::BaseType_UShort: return 2;
+        case reflection::BaseType_Int:
+        case reflection::BaseType_UInt:
+        case reflection::BaseType_Float: return 4;
+        default: return 8;
+        }
+    }
+
+    // In-memory width of the protobuf C++ type for a FlatBuffers scalar (8/16 bit ints widen to 32)
+    static size_t ProtoSize(reflection::BaseType type) {
+        if (type == reflection::BaseType_Bool) return sizeof(bool);
+        return ScalarSize(type) <= 4 ? 4 : 8;
+    }
+
+    // Scalars whose RepeatedField storage is byte-compatible with the FlatBuffers vector
+    static bool BulkCopyable(reflection::BaseType type, int32_t enum_index) {
+        return enum_index < 0 && ScalarSize(type) == ProtoSize(type);
+    }
+
+    // C++ element type of the T (&o_)[N] overload for structs that are a single scalar array
+    static const char* CppScalar(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool: return "bool";
+        case reflection::BaseType_Byte: return "int8_t";
+        case reflection::BaseType_UByte: return "uint8_t";
+        case reflection::BaseType_Short: return "int16_t";
+        case reflection::BaseType_UShort: return "uint16_t";
+        case reflection::BaseType_Int: return "int32_t";
+        case reflection::BaseType_UInt: return "uint32_t";
+        case reflection::BaseType_Long: return "int64_t";
+        case reflection::BaseType_ULong: return "uint64_t";
+        case reflection::BaseType_Float: return "float";
+        case reflection::BaseType_Double: return "double";
+        default: throw std::runtime_error("Not a scalar type");
+        }
+    }
+
+    std::string CScalarType(reflection::BaseType type) const {
+        return type == reflection::BaseType_Bool ? "flatbuffers_bool_t" : std::string(FlatccScalar(type)) + "_t";
+    }
+
+    // Tables before the tables that use them, like m_ObjectsByDependency in the template
+    std::vector<const reflection::ObjectT*> ObjectsByDependency() const {
+        std::vector<const reflection::ObjectT*> ordered;
+        std::vector<int> state(schema_.objects.size(), 0);  // 0 new, 1 visiting, 2 done
+        std::function<void(size_t)> visit = [&](size_t i) {
+            if (state[i] != 0) return;  // done, or a recursive type we are already inside
+            state[i] = 1;
+            for (const auto& f : schema_.objects[i]->fields) {
+                const reflection::TypeT& t = *f->type;
+                bool refers = t.base_type == reflection::BaseType_Obj ||
+                              ((t.base_type == reflection::BaseType_Vector || t.base_type == reflection::BaseType_Array) && t.element == reflection::BaseType_Obj);
+                if (refers && t.index >= 0) visit(static_cast<size_t>(t.index));
+            }
+            state[i] = 2;
+            ordered.push_back(schema_.objects[i].get());
+        };
+        for (size_t i = 0; i < schema_.objects.size(); ++i) visit(i);
+        return ordered;
+    }
+
+    void GenerateObject(const reflection::ObjectT& obj) {
+        QualifiedName q = Qualify(obj.name);
+        std::string prefix;
+        std::string pb_type = q.name;
+        std::string sub_template;
+        if (HasAttribute(obj.attributes, "composite_view")) prefix = "m_";
+        if (HasAttribute(obj.attributes, "sub_template", &sub_template))
+            pb_type = "T_" + sub_template + "::" + q.name.substr(sub_template.size() + 1);  // +1 skips the underscore
+        pb_type = q.cpp_namespace + "::" + pb_type;
+
+        std::vector<const reflection::FieldT*> fields;
+        for (const auto& f : obj.fields)
+            if (!f->deprecated) fields.push_back(f.get());
+        std::sort(fields.begin(), fields.end(), [](const reflection::FieldT* a, const reflection::FieldT* b) { return a->id < b->id; });
+
+        out_ << "namespace " << q.cpp_namespace << " {\n\n";
+        if (!prefix.empty()) out_ << "class " << q.name << "FACESerializer\n{\npublic:\n\n";
+
+        if (obj.is_struct) {
+            out_ << "inline static void Create" << q.name << "FromPB(" << q.CType() << "_t* ref, const " << pb_type << "& _o)\n{\n";
+            for (const reflection::FieldT* f : fields) StructFieldFromPB(*f, prefix);
+        } else {
+            out_ << "inline static void Create" << q.name << "FromPB(flatcc_builder_t* _fbb, const " << pb_type << "& _o)\n{\n";
+            for (const reflection::FieldT* f : fields) TableFieldFromPB(q, *f, prefix);
+        }
+        out_ << "}\n\n";
+
+        if (obj.is_struct) {
+            out_ << "inline static void CreatePBFrom" << q.name << "(" << q.CType() << "_struct_t root, " << pb_type << "& o_)\n{\n";
+            for (const reflection::FieldT* f : fields) StructFieldToPB(q, *f, prefix);
+        } else {
+            out_ << "inline static void CreatePBFrom" << q.name << "(" << q.CType() << "_table_t root, " << pb_type << "& o_)\n{\n";
+            if (!prefix.empty()) out_ << "    o_.Clear();\n";
+            for (const reflection::FieldT* f : fields) TableFieldToPB(q, *f, prefix);
+        }
+        out_ << "}\n\n";
+        if (obj.is_struct) ArrayStructToPB(q, fields);
+
+        if (!prefix.empty()) out_ << "};\n\n";
+        out_ << "} // namespace " << q.cpp_namespace << "\n\n";
+    }
+
+    // ---------------- pb -> fb, structs (written in place through ref) ----------------
+
+    void StructFieldFromPB(const reflection::FieldT& f, const std::string& prefix) {
+        const reflection::TypeT& t = *f.type;
+        std::string pb = prefix + PB(f.name);
+        if (t.base_type == reflection::BaseType_Array && t.element != reflection::BaseType_Obj) {
+            if (BulkCopyable(t.element, t.index)) {
+                out_ << "    {\n";
+                out_ << "        size_t n = (size_t)_o." << pb << "_size() < " << t.fixed_length << " ? (size_t)_o." << pb << "_size() : " << t.fixed_length << ";\n";
+                out_ << "        memcpy(ref->" << f.name << ", _o." << pb << "().data(), n * sizeof(ref->" << f.name << "[0]));\n";
+                out_ << "        memset(ref->" << f.name << " + n, 0, (" << t.fixed_length << " - n) * sizeof(ref->" << f.name << "[0]));\n";
+                out_ << "    }\n";
+            } else {
+                out_ << "    for (int i = 0; i < " << t.fixed_length << "; ++i)\n";
+                out_ << "        ref->" << f.name << "[i] = i < _o." << pb << "_size() ? (" << CScalarType(t.element) << ")_o." << pb << "(i) : 0;\n";
+            }
+        } else if (t.base_type == reflection::BaseType_Array) {
+            QualifiedName e = Qualify(schema_.objects[t.index]->name);
+            out_ << "    for (int i = 0; i < " << t.fixed_length << " && i < _o." << pb << "_size(); ++i)\n";
+            out_ << "        " << e.cpp_namespace << "::Create" << e.name << "FromPB(&ref->" << f.name << "[i], _o." << pb << "(i));\n";
+        } else if (t.base_type == reflection::BaseType_Obj) {
+            QualifiedName e = Qualify(schema_.objects[t.index]->name);
+            out_ << "    " << e.cpp_namespace << "::Create" << e.name << "FromPB(&ref->" << f.name << ", _o." << pb << "());\n";
+        } else {
+            out_ << "    ref->" << f.name << " = _o." << pb << "();\n";
+        }
+    }
+
+    // ---------------- fb -> pb, structs ----------------
+
+    void StructFieldToPB(const QualifiedName& q, const reflection::FieldT& f, const std::string& prefix) {
+        const reflection::TypeT& t = *f.type;
+        std::string pb = prefix + PB(f.name);
+        if (t.base_type == reflection::BaseType_Array && t.element != reflection::BaseType_Obj) {
+            if (BulkCopyable(t.element, t.index)) {
+                out_ << "    o_.mutable_" << pb << "()->Resize(" << t.fixed_length << ", 0);\n";
+                out_ << "    memcpy(o_.mutable_" << pb << "()->mutable_data(), root->" << f.name << ", sizeof(root->" << f.name << "));\n";
+            } else {
+                out_ << "    o_.clear_" << pb << "();\n";
+                out_ << "    o_.mutable_" << pb << "()->Reserve(" << t.fixed_length << ");\n";
+                out_ << "    for (int i = 0; i < " << t.fixed_length << "; ++i)\n";
+                out_ << "        o_.add_" << pb << "(root->" << f.name << "[i]);\n";
+            }
+        } else if (t.base_type == reflection::BaseType_Array) {
+            QualifiedName e = Qualify(schema_.objects[t.index]->name);
+            out_ << "    o_.clear_" << pb << "();\n";
+            out_ << "    o_.mutable_" << pb << "()->Reserve(" << t.fixed_length << ");\n";
+            out_ << "    for (int i = 0; i < " << t.fixed_length << "; ++i)\n";
+            out_ << "        " << e.cpp_namespace << "::CreatePBFrom" << e.name << "(&root->" << f.name << "[i], *o_.add_" << pb << "());\n";
+        } else if (t.base_type == reflection::BaseType_Obj) {
+            QualifiedName e = Qualify(schema_.objects[t.index]->name);
+            out_ << "    " << e.cpp_namespace << "::CreatePBFrom" << e.name << "(&root->" << f.name << ", *o_.mutable_" << pb << "());\n";
+        } else if (t.index >= 0) {
+            QualifiedName e = Qualify(schema_.enums[t.index]->name);
+            out_ << "    o_.set_" << pb << "((" << e.CppType() << ")" << q.CType() << "_" << f.name << "(root));\n";
+        } else {
+            out_ << "    o_.set_" << pb << "(" << q.CType() << "_" << f.name << "(root));\n";
+        }
+    }
+
+    // A struct that is nothing but one scalar array (coordinates : [float:3]) also keeps the
+    // template's CreatePBFrom<X>(root, T (&o_)[N]) signature next to the message one, for callers
+    // that convert into a plain C array
+    void ArrayStructToPB(const QualifiedName& q, const std::vector<const reflection::FieldT*>& fields) {
+        if (fields.size() != 1) return;
+        const reflection::FieldT& f = *fields[0];
+        const reflection::TypeT& t = *f.type;
+        if (t.base_type != reflection::BaseType_Array || t.element == reflection::BaseType_Obj || t.index >= 0) return;
+        out_ << "inline static void CreatePBFrom" << q.name << "(" << q.CType() << "_struct_t root, " << CppScalar(t.element) << " (&o_)[" << t.fixed_length << "])\n{\n";
+        out_ << "    for (int i = 0; i < " << t.fixed_length << "; ++i)\n";
+        out_ << "        o_[i] = (" << CppScalar(t.element) << ")root->" << f.name << "[i];\n";
+        out_ << "}\n\n";
+    }
+
+    // ---------------- pb -> fb, tables ----------------
+
+    void TableFieldFromPB(const QualifiedName& q, const reflection::FieldT& f, const std::string& prefix) {
+        const reflection::TypeT& t = *f.type;
+        std::string pb = prefix + PB(f.name);
+        std::string fb = q.CType() + "_" + f.name;
+
+        if (f.name == "sequenceBytes") {
+            // Raw bytes: one bulk vector create
+            out_ << "    if (!_o." << pb << "().empty())\n";
+            out_ << "        " << fb << "_create(_fbb, (const uint8_t*)_o." << pb << "().data(), _o." << pb << "().size());\n\n";
+            return;
+        }
+
+        if (t.base_type == reflection::BaseType_Vector) {
+            out_ << "    if (_o." << pb << "_size() > 0)\n    {\n";
+            if (t.element == reflection::BaseType_Obj) {
+                QualifiedName e = Qualify(schema_.objects[t.index]->name);
+                if (schema_.objects[t.index]->is_struct || HasAttribute(f.attributes, "fixed_array_sequence")) {
+                    // Structs are inline: reserve every element with one extend, then fill them in place
+                    out_ << "        " << fb << "_start(_fbb);\n";
+                    out_ << "        " << e.CType() << "_t* ref = " << fb << "_extend(_fbb, _o." << pb << "_size());\n";
+                    out_ << "        for (int i = 0; i < _o." << pb << "_size(); ++i)\n";
+                    out_ << "            " << e.cpp_namespace << "::Create" << e.name << "FromPB(&ref[i], _o." << pb << "(i));\n";
+                    out_ << "        " << fb << "_end(_fbb);\n";
+                } else {
+                    out_ << "        " << fb << "_start(_fbb);\n";
+                    out_ << "        for (int i = 0; i < _o." << pb << "_size(); ++i)\n        {\n";
+                    out_ << "            " << fb << "_push_start(_fbb);\n";
+                    out_ << "            " << e.cpp_namespace << "::Create" << e.name << "FromPB(_fbb, _o." << pb << "(i));\n";
+                    out_ << "            " << fb << "_push_end(_fbb);\n";
+                    out_ << "        }\n";
+                    out_ << "        " << fb << "_end(_fbb);\n";
+                }
+            } else if (t.element == reflection::BaseType_String) {
+                out_ << "        " << fb << "_start(_fbb);\n";
+                out_ << "        for (int i = 0; i < _o." << pb << "_size(); ++i)\n";
+                out_ << "            " << fb << "_push_create(_fbb, _o." << pb << "(i).data(), _o." << pb << "(i).size());\n";
+                out_ << "        " << fb << "_end(_fbb);\n";
+            } else if (BulkCopyable(t.element, t.index)) {
+                out_ << "        " << fb << "_create(_fbb, _o." << pb << "().data(), _o." << pb << "_size());\n";
+            } else {
+                // Width differs (enums, 8/16 bit ints): one extend, then convert in place
+                std::string elem = t.index >= 0 ? Qualify(schema_.enums[t.index]->name).CType() + "_enum_t" : CScalarType(t.element);
+                std::string assign = t.index >= 0 ? Qualify(schema_.enums[t.index]->name).CType() : std::string("flatbuffers_") + FlatccScalar(t.element);
+                out_ << "        " << fb << "_start(_fbb);\n";
+                out_ << "        " << elem << "* v = " << fb << "_extend(_fbb, _o." << pb << "_size());\n";
+                out_ << "        for (int i = 0; i < _o." << pb << "_size(); ++i)\n";
+                out_ << "            " << assign << "_assign_to_pe(&v[i], (" << elem << ")_o." << pb << "(i));\n";
+                out_ << "        " << fb << "_end(_fbb);\n";
+            }
+            out_ << "    }\n\n";
+        } else if (t.base_type == reflection::BaseType_Obj) {
+            QualifiedName e = Qualify(schema_.objects[t.index]->name);
+            if (schema_.objects[t.index]->is_struct) {
+                out_ << "    {\n";
+                out_ << "        " << e.CType() << "_t* ref = " << fb << "_start(_fbb);\n";
+                out_ << "        " << e.cpp_namespace << "::Create" << e.name << "FromPB(ref, _o." << pb << "());\n";
+                out_ << "        " << fb << "_end(_fbb);\n";
+                out_ << "    }\n\n";
+            } else {
+                out_ << "    if (_o.has_" << pb << "())\n    {\n";
+                out_ << "        " << fb << "_start(_fbb);\n";
+                out_ << "        " << e.cpp_namespace << "::Create" << e.name << "FromPB(_fbb, _o." << pb << "());\n";
+                out_ << "        " << fb << "_end(_fbb);\n";
+                out_ << "    }\n\n";
+            }
+        } else if (t.base_type == reflection::BaseType_String) {
+            out_ << "    if (!_o." << pb << "().empty())\n";
+            out_ << "        " << fb << "_create(_fbb, _o." << pb << "().data(), _o." << pb << "().size());\n\n";
+        } else if (t.index >= 0) {
+            QualifiedName e = Qualify(schema_.enums[t.index]->name);
+            out_ << "    " << fb << "_add(_fbb, (" << e.CType() << "_enum_t)_o." << pb << "());\n";
+        } else {
+            out_ << "    " << fb << "_add(_fbb, _o." << pb << "());\n";
+        }
+    }
+
+    // ---------------- fb -> pb, tables ----------------
+
+    void TableFieldToPB(const QualifiedName& q, const reflection::FieldT& f, const std::string& prefix) {
+        const reflection::TypeT& t = *f.type;
+        std::string pb = prefix + PB(f.name);
+        std::string fb = q.CType() + "_" + f.name;
+
+        if (f.name == "sequenceBytes") {
+            out_ << "    if (" << fb << "_is_present(root))\n    {\n";
+            out_ << "        flatbuffers_uint8_vec_t bytes = " << fb << "(root);\n";
+            out_ << "        o_.set_" << pb << "((const char*)bytes, flatbuffers_uint8_vec_len(bytes));  // one copy, binary safe\n";
+            out_ << "    }\n    else\n    {\n";
+            out_ << "        o_.clear_" << pb << "();\n";
+            out_ << "    }\n\n";
+            return;
+        }
+
+        if (t.base_type == reflection::BaseType_Vector) {
+            std::string vec;
+            QualifiedName e;
+            if (t.element == reflection::BaseType_Obj) {
+                e = Qualify(schema_.objects[t.index]->name);
+                vec = e.CType();
+            } else if (t.element == reflection::BaseType_String) {
+                vec = "flatbuffers_string";
+            } else if (t.index >= 0) {
+                e = Qualify(schema_.enums[t.index]->name);
+                vec = e.CType();
+            } else {
+                vec = std::string("flatbuffers_") + FlatccScalar(t.element);
+            }
+
+            out_ << "    o_.clear_" << pb << "();\n";
+            out_ << "    if (" << fb << "_is_present(root))\n    {\n";
+            out_ << "        " << vec << "_vec_t v = " << fb << "(root);\n";
+            out_ << "        size_t len = " << vec << "_vec_len(v);\n";
+            if (t.element != reflection::BaseType_Obj && t.element != reflection::BaseType_String && BulkCopyable(t.element, t.index)) {
+                out_ << "        o_.mutable_" << pb << "()->Resize((int)len, 0);\n";
+                out_ << "        memcpy(o_.mutable_" << pb << "()->mutable_data(), v, len * sizeof(*v));\n";
+            } else {
+                out_ << "        o_.mutable_" << pb << "()->Reserve((int)len);\n";
+                out_ << "        for (size_t i = 0; i < len; ++i)\n";
+                if (t.element == reflection::BaseType_Obj) {  // tables and structs alike
+                    out_ << "            " << e.cpp_namespace << "::CreatePBFrom" << e.name << "(" << vec << "_vec_at(v, i), *o_.add_" << pb << "());\n";
+                } else if (t.element == reflection::BaseType_String) {
+                    out_ << "        {\n";
+                    out_ << "            flatbuffers_string_t s = flatbuffers_string_vec_at(v, i);\n";
+                    out_ << "            o_.add_" << pb << "(s, flatbuffers_string_len(s));\n";
+                    out_ << "        }\n";
+                } else if (t.index >= 0) {
+                    out_ << "            o_.add_" << pb << "((" << e.CppType() << ")" << vec << "_vec_at(v, i));\n";
+                } else {
+                    out_ << "            o_.add_" << pb << "(" << vec << "_vec_at(v, i));\n";
+                }
+            }
+            if (!prefix.empty()) {
+                QualifiedName owner = q;
+                out_ << "        o_.m_Discriminator = " << owner.cpp_namespace << "::" << owner.name << "::CASES_" << Upper(f.name) << ";\n";
+            }
+            out_ << "    }\n\n";
+        } else if (t.base_type == reflection::BaseType_Obj) {
+            QualifiedName e = Qualify(schema_.objects[t.index]->name);
+            out_ << "    if (" << fb << "_is_present(root))\n";
+            out_ << "        " << e.cpp_namespace << "::CreatePBFrom" << e.name << "(" << fb << "(root), *o_.mutable_" << pb << "());\n";
+            out_ << "    else\n";
+            out_ << "        o_.clear_" << pb << "();\n\n";
+        } else if (t.base_type == reflection::BaseType_String) {
+            out_ << "    if (" << fb << "_is_present(root))\n    {\n";
+            out_ << "        flatbuffers_string_t s = " << fb << "(root);\n";
+            out_ << "        o_.set_" << pb << "(s, flatbuffers_string_len(s));\n";
+            out_ << "    }\n    else\n    {\n";
+            out_ << "        o_.clear_" << pb << "();\n";
+            out_ << "    }\n\n";
+        } else if (t.index >= 0) {
+            QualifiedName e = Qualify(schema_.enums[t.index]->name);
+            out_ << "    o_.set_" << pb << "((" << e.CppType() << ")" << fb << "(root));\n";
+        } else {
+            out_ << "    o_.set_" << pb << "(" << fb << "(root));\n";
+        }
+    }
+
+    static std::string Upper(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        return s;
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <schema.bfbs> <module> [--outer-namespace A::B] [-o out.h]\n";
+        return 2;
+    }
+    std::string bfbs_path = argv[1];
+    std::string module = argv[2];
+    std::string outer_namespace;
+    std::string out_path;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--outer-namespace") outer_namespace = argv[i + 1];
+        else if (flag == "-o") out_path = argv[i + 1];
+        else {
+            std::cerr << "unknown option " << flag << "\n";
+            return 2;
+        }
+    }
+
+    try {
+        std::ifstream in(bfbs_path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open " + bfbs_path);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        flatbuffers::Verifier verifier(bytes.data(), bytes.size());
+        if (!reflection::VerifySchemaBuffer(verifier)) throw std::runtime_error(bfbs_path + " is not a valid .bfbs schema");
+        std::unique_ptr<reflection::SchemaT> schema(reflection::GetSchema(bytes.data())->UnPack());
+
+        std::string header = PBtoFBGenerator(*schema, module, outer_namespace).Generate();
+        if (out_path.empty()) {
+            std::cout << header;
+        } else {
+            std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+            out << header;
+            if (!out) throw std::runtime_error("Cannot write " + out_path);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "pbToFbGenerator: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
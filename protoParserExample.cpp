@@ -0,0 +1,135 @@
+#include "constexprProto.h"
+#include "protoParser.h"
+#include "protoStreamParser.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+// The same schema parsed by the compiler: the tables below are in read-only data, no startup cost
+constexpr std::string_view kTradeProto = R"(
+enum OrderSide { buy = 0; sell = 1; }
+enum OrderType { market = 0; limit = 1; stop = 2; }
+message Order { int32 id = 1; string symbol = 2; OrderSide side = 3; OrderType type = 4; double price = 5; double volume = 6; }
+message Balance { string currency = 1; double amount = 2; }
+message Account { int32 id = 1; string name = 2; Balance wallet = 3; repeated Order orders = 4; })";
+
+constexpr auto kTradeSchema = CONSTEXPR_PROTO_SCHEMA(kTradeProto);
+static_assert(kTradeSchema.FieldNumber("Account", "orders") == 4, "Account.orders moved");
+static_assert(kTradeSchema.EnumValue("OrderSide", "sell") == 1, "OrderSide.sell changed");
+
+// Same definitions in the same order, field for field
+static bool SameFile(const ProtoFile& a, const ProtoFile& b) {
+    if (a.messages.size() != b.messages.size() || a.enums.size() != b.enums.size()) return false;
+    for (size_t i = 0; i < a.messages.size(); ++i) {
+        const Message& x = a.messages[i];
+        const Message& y = b.messages[i];
+        if (x.name != y.name || x.fields.size() != y.fields.size()) return false;
+        for (size_t j = 0; j < x.fields.size(); ++j) {
+            const Field& f = x.fields[j];
+            const Field& g = y.fields[j];
+            if (f.type != g.type || f.name != g.name || f.number != g.number || f.repeated != g.repeated || f.optional != g.optional) return false;
+        }
+    }
+    for (size_t i = 0; i < a.enums.size(); ++i)
+        if (a.enums[i].name != b.enums[i].name || a.enums[i].values != b.enums[i].values) return false;
+    return true;
+}
+
+int main() {
+    // Example proto input from sent repo
+    std::string proto = R"(
+enum OrderSide
+{
+    buy = 0;
+    sell = 1;
+}
+
+enum OrderType
+{
+    market = 0;
+    limit = 1;
+    stop = 2;
+}
+
+message Order
+{
+    int32 id = 1;
+    string symbol = 2;
+    OrderSide side = 3;
+    OrderType type = 4;
+    double price = 5;
+    double volume = 6;
+}
+
+message Balance
+{
+    string currency = 1;
+    double amount = 2;
+}
+
+message Account
+{
+    int32 id = 1;
+    string name = 2;
+    Balance wallet = 3;
+    repeated Order orders = 4;
+})";
+
+    ProtoParser parser(proto);             
+    ProtoFile file = parser.ParseFile();   
+
+    // messages
+    std::cout << "Messages:\n";
+    for (const auto& msg : file.messages) {
+        std::cout << "- " << msg.name << "\n";
+        for (const auto& f : msg.fields) {
+            std::cout << "  -- " << (f.repeated ? "repeated " : "") << f.type << " " << f.name << " = " << f.number << "\n";
+        }
+    }
+
+
+
+    // enums
+    std::cout << "\nEnums:\n";
+    for (const auto& e : file.enums) {
+        std::cout << "- " << e.name << "\n";
+        for (const auto& val : e.values) {
+            std::cout << "  -- " << val.first << " = " << val.second << "\n";
+        }
+    }
+
+    // Same schema pushed in 16 byte chunks, definitions come out as soon as they are complete
+    std::cout << "\nStreamed:\n";
+    ProtoStreamParser stream(
+        [](Message&& msg) { std::cout << "- message " << msg.name << " (" << msg.fields.size() << " fields)\n"; },
+        [](Enum&& e) { std::cout << "- enum " << e.name << " (" << e.values.size() << " values)\n"; });
+    for (size_t i = 0; i < proto.size(); i += 16) {
+        stream.Feed(proto.data() + i, std::min<size_t>(16, proto.size() - i));
+    }
+    stream.Finish();
+
+    // The streamed parse must match ProtoParser however the input is cut, down to one byte a chunk
+    for (size_t chunk = 1; chunk <= proto.size(); ++chunk) {
+        ProtoStreamFileBuilder builder;
+        for (size_t i = 0; i < proto.size(); i += chunk) {
+            builder.Feed(proto.data() + i, std::min(chunk, proto.size() - i));
+        }
+        if (!SameFile(builder.Finish(), file)) {
+            std::cout << "Streamed parse differs from ProtoParser with " << chunk << " byte chunks\n";
+            return 1;
+        }
+    }
+    std::cout << "Streamed parse matches ProtoParser at every chunk size from 1 to " << proto.size() << " bytes\n";
+
+    std::cout << "\nCompile time:\n";
+    for (const auto& msg : kTradeSchema.messages) {
+        std::cout << "- " << msg.name << "\n";
+        for (size_t i = msg.first_field; i < msg.first_field + msg.field_count; ++i) {
+            const auto& f = kTradeSchema.fields[i];
+            std::cout << "  -- " << (f.repeated ? "repeated " : "") << f.type_name << " " << f.name << " = " << f.number << "\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include "protoStreamParser.h"
+
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+// ------------------- Tokenizer ----------------------
+
+namespace {
+
+bool IsIdentifierChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+bool IsDigit(char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }
+
+TokenType WordType(const std::string& word) {
+    if (word == "message" || word == "enum" || word == "repeated" || word == "optional") return TokenType::KEYWORD;
+    return TokenType::IDENTIFIER;
+}
+
+}
+
+ProtoStreamTokenizer::ProtoStreamTokenizer(TokenSink sink)
+    : sink_(std::move(sink)), carry_line_(1), carry_column_(1), line_(1), column_(1) {}
+
+void ProtoStreamTokenizer::Feed(const char* data, size_t size) {
+    size_t pos = carry_.empty() ? 0 : ContinueCarry(data, size);  // finish the token the last chunk cut off
+
+    while (pos < size) {
+        char c = data[pos];
+        if (c == ' ' || c == '\t' || c == '\r') {    // same whitespace rules as ProtoTokenizer
+            ++pos;
+            ++column_;
+            continue;
+        }
+        if (c == '\n') {
+            ++pos;
+            ++line_;
+            column_ = 1;
+            continue;
+        }
+
+        int start_column = column_;
+        size_t start = pos;
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_' || IsDigit(c)) {
+            bool number = IsDigit(c);
+            while (pos < size && (number ? IsDigit(data[pos]) : IsIdentifierChar(data[pos]))) ++pos;
+            column_ += static_cast<int>(pos - start);
+            if (pos == size) {                       // may continue in the next chunk
+                carry_.assign(data + start, pos - start);
+                carry_line_ = line_;
+                carry_column_ = start_column;
+                return;
+            }
+            std::string word(data + start, pos - start);
+            sink_({ number ? TokenType::NUMBER : WordType(word), std::move(word), line_, start_column });
+        }
+        else if (c == '"') {
+            const void* close = std::memchr(data + pos + 1, '"', size - pos - 1);
+            if (!close) {                            // string runs into the next chunk
+                carry_.assign(data + pos, size - pos);
+                carry_line_ = line_;
+                carry_column_ = start_column;
+                column_ += static_cast<int>(size - pos);
+                return;
+            }
+            size_t end = static_cast<const char*>(close) - data;
+            column_ += static_cast<int>(end + 1 - pos);
+            sink_({ TokenType::STRING, std::string(data + pos + 1, end - pos - 1), line_, start_column });
+            pos = end + 1;
+        }
+        else if (std::ispunct(static_cast<unsigned char>(c))) {
+            ++pos;
+            ++column_;
+            sink_({ TokenType::SYMBOL, std::string(1, c), line_, start_column });
+        }
+        else {
+            throw std::runtime_error("Unreadable Character in .proto");
+        }
+    }
+}
+
+// Extends carry_ with the start of the new chunk, returns how much of the chunk it took
+size_t ProtoStreamTokenizer::ContinueCarry(const char* data, size_t size) {
+    size_t pos = 0;
+    if (carry_[0] == '"') {
+        const void* close = std::memchr(data, '"', size);
+        pos = close ? static_cast<size_t>(static_cast<const char*>(close) - data) + 1 : size;
+    }
+    else {
+        bool number = IsDigit(carry_[0]);
+        while (pos < size && (number ? IsDigit(data[pos]) : IsIdentifierChar(data[pos]))) ++pos;
+    }
+    carry_.append(data, pos);
+    column_ += static_cast<int>(pos);
+    bool complete = carry_[0] == '"' ? carry_.size() > 1 && carry_.back() == '"' : pos < size;
+    if (complete) EmitCarry();
+    return pos;
+}
+
+void ProtoStreamTokenizer::EmitCarry() {
+    if (carry_[0] == '"') {
+        // An unterminated string at the very end reads to end of input, like ProtoTokenizer
+        size_t length = carry_.size() > 1 && carry_.back() == '"' ? carry_.size() - 2 : carry_.size() - 1;
+        sink_({ TokenType::STRING, carry_.substr(1, length), carry_line_, carry_column_ });
+    }
+    else if (IsDigit(carry_[0])) {
+        sink_({ TokenType::NUMBER, carry_, carry_line_, carry_column_ });
+    }
+    else {
+        sink_({ WordType(carry_), carry_, carry_line_, carry_column_ });
+    }
+    carry_.clear();
+}
+
+void ProtoStreamTokenizer::Finish() {
+    if (!carry_.empty()) EmitCarry();
+    sink_({ TokenType::EOF_TOKEN, "", line_, column_ });
+}
+
+// --------------------- Parser ------------------------
+
+ProtoStreamParser::ProtoStreamParser(MessageSink on_message, EnumSink on_enum)
+    : tokenizer_([this](Token&& token) { OnToken(std::move(token)); }),
+      on_message_(std::move(on_message)), on_enum_(std::move(on_enum)) {}
+
+void ProtoStreamParser::Expect(const Token& token, TokenType type, const std::string& val) {
+    if (token.type != type || (!val.empty() && token.value != val)) {
+        throw std::runtime_error("Unexpected token: " + token.value);
+    }
+}
+
+// One step of ProtoParser's grammar per token
+void ProtoStreamParser::OnToken(Token&& token) {
+    if (token.type == TokenType::EOF_TOKEN) {
+        if (state_ != State::TopLevel) throw std::runtime_error("Unexpected end of input");
+        return;
+    }
+    bool is_close = token.type == TokenType::SYMBOL && token.value == "}";
+
+    switch (state_) {
+    case State::TopLevel:
+        if (token.value == "message") state_ = State::MessageName;
+        else if (token.value == "enum") state_ = State::EnumName;
+        break;                                       // anything else (syntax, package, ...) is skipped
+
+    // message Name { [repeated] [optional] type name = number [;] ... }
+    case State::MessageName:
+        Expect(token, TokenType::IDENTIFIER);
+        message_ = Message();
+        message_.name = std::move(token.value);
+        state_ = State::MessageOpen;
+        break;
+    case State::MessageOpen:
+        Expect(token, TokenType::SYMBOL, "{");
+        state_ = State::FieldStart;
+        break;
+    case State::FieldEnd:
+        if (token.value == ";") {
+            state_ = State::FieldStart;
+            break;
+        }
+        state_ = State::FieldStart;                  // ';' is optional, this token starts the next field
+        // fall through
+    case State::FieldStart:
+        if (is_close && !field_.repeated && !field_.optional) {
+            on_message_(std::move(message_));
+            state_ = State::TopLevel;
+            break;
+        }
+        if (token.value == "repeated" && !field_.repeated && !field_.optional) {
+            field_.repeated = true;
+            break;
+        }
+        if (token.value == "optional" && !field_.optional) {
+            field_.optional = true;
+            break;
+        }
+        Expect(token, TokenType::IDENTIFIER);        // type
+        field_.type = std::move(token.value);
+        state_ = State::FieldName;
+        break;
+    case State::FieldName:
+        Expect(token, TokenType::IDENTIFIER);
+        field_.name = std::move(token.value);
+        state_ = State::FieldEquals;
+        break;
+    case State::FieldEquals:
+        Expect(token, TokenType::SYMBOL, "=");
+        state_ = State::FieldNumber;
+        break;
+    case State::FieldNumber:
+        Expect(token, TokenType::NUMBER);
+        field_.number = std::stoi(token.value);
+        message_.fields.push_back(std::move(field_));
+        field_ = Field();
+        state_ = State::FieldEnd;
+        break;
+
+    // enum Name { name = number [;] ... }
+    case State::EnumName:
+        Expect(token, TokenType::IDENTIFIER);
+        enum_ = Enum();
+        enum_.name = std::move(token.value);
+        state_ = State::EnumOpen;
+        break;
+    case State::EnumOpen:
+        Expect(token, TokenType::SYMBOL, "{");
+        state_ = State::ValueStart;
+        break;
+    case State::ValueEnd:
+        if (token.value == ";") {
+            state_ = State::ValueStart;
+            break;
+        }
+        state_ = State::ValueStart;
+        // fall through
+    case State::ValueStart:
+        if (is_close) {
+            on_enum_(std::move(enum_));
+            state_ = State::TopLevel;
+            break;
+        }
+        Expect(token, TokenType::IDENTIFIER);
+        value_name_ = std::move(token.value);
+        state_ = State::ValueEquals;
+        break;
+    case State::ValueEquals:
+        Expect(token, TokenType::SYMBOL, "=");
+        state_ = State::ValueNumber;
+        break;
+    case State::ValueNumber:
+        Expect(token, TokenType::NUMBER);
+        enum_.values.push_back({ std::move(value_name_), std::stoi(token.value) });
+        state_ = State::ValueEnd;
+        break;
+    }
+}
+
+// ------------------ File builder ---------------------
+
+ProtoStreamFileBuilder::ProtoStreamFileBuilder()
+    : parser_([this](Message&& m) { file_.messages.push_back(std::move(m)); },
+              [this](Enum&& e) { file_.enums.push_back(std::move(e)); }) {}
+
+ProtoFile ProtoStreamFileBuilder::Finish() {
+    parser_.Finish();
+    return std::move(file_);
+}
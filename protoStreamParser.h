@@ -0,0 +1,91 @@
+#ifndef PROTO_STREAM_PARSER_H
+#define PROTO_STREAM_PARSER_H
+
+#include "protoParser.h"
+
+#include <functional>
+#include <string>
+
+// Push-based counterparts of ProtoTokenizer / ProtoParser for schemas that arrive in pieces.
+// Input is fed in chunks of any size, tokens may straddle chunk boundaries, and every Message or
+// Enum is handed out as soon as its closing '}' has been read. Only the unfinished token and the
+// definition being parsed are kept, so memory does not grow with the schema.
+// Accepts exactly what ProtoParser accepts and produces the same Message/Enum values.
+
+// ------------------- Tokenizer ----------------------
+
+class ProtoStreamTokenizer {
+public:
+    using TokenSink = std::function<void(Token&&)>;
+
+    explicit ProtoStreamTokenizer(TokenSink sink);
+
+    // Tokenizes the chunk; a token cut off at its end is finished by the next Feed or Finish
+    void Feed(const char* data, size_t size);
+    void Feed(const std::string& chunk) { Feed(chunk.data(), chunk.size()); }
+
+    // End of input: flushes the last token and emits EOF_TOKEN
+    void Finish();
+
+private:
+    TokenSink sink_;
+    std::string carry_;   // unfinished identifier, number or string from the previous chunk
+    int carry_line_;
+    int carry_column_;
+    int line_;
+    int column_;
+
+    size_t ContinueCarry(const char* data, size_t size);
+    void EmitCarry();
+};
+
+// --------------------- Parser ------------------------
+
+class ProtoStreamParser {
+public:
+    using MessageSink = std::function<void(Message&&)>;
+    using EnumSink = std::function<void(Enum&&)>;
+
+    ProtoStreamParser(MessageSink on_message, EnumSink on_enum);
+
+    void Feed(const char* data, size_t size) { tokenizer_.Feed(data, size); }
+    void Feed(const std::string& chunk) { tokenizer_.Feed(chunk); }
+
+    // Throws if the input ended inside a definition
+    void Finish() { tokenizer_.Finish(); }
+
+private:
+    enum class State {
+        TopLevel,
+        MessageName, MessageOpen, FieldStart, FieldName, FieldEquals, FieldNumber, FieldEnd,
+        EnumName, EnumOpen, ValueStart, ValueEquals, ValueNumber, ValueEnd
+    };
+
+    ProtoStreamTokenizer tokenizer_;
+    MessageSink on_message_;
+    EnumSink on_enum_;
+    State state_ = State::TopLevel;
+    Message message_;
+    Field field_;
+    Enum enum_;
+    std::string value_name_;
+
+    void OnToken(Token&& token);
+    static void Expect(const Token& token, TokenType type, const std::string& val = "");
+};
+
+// Collects everything into a ProtoFile, for callers that still want the whole schema at the end
+class ProtoStreamFileBuilder {
+public:
+    ProtoStreamFileBuilder();
+
+    void Feed(const char* data, size_t size) { parser_.Feed(data, size); }
+    void Feed(const std::string& chunk) { parser_.Feed(chunk); }
+    ProtoFile Finish();
+
+private:
+    ProtoFile file_;
+    ProtoStreamParser parser_;
+};
+
+#endif // PROTO_STREAM_PARSER_H
@@ -1,4 +1,5 @@
 #include "protobuf/trade.pb.h"
+#include "tradeMetrics.h"
 
 #include <algorithm>
 
@@ -24,8 +25,10 @@ struct Order
     void Deserialize(const Trade::protobuf::Order& value)
     {
         Id = value.id();
-        std::string symbol = value.symbol();
-        std::memcpy(Symbol, symbol.c_str(), std::min(symbol.size() + 1, sizeof(Symbol)));
+        const std::string& symbol = value.symbol();  // reference, no copy
+        size_t length = std::min(symbol.size(), sizeof(Symbol) - 1);
+        std::memcpy(Symbol, symbol.data(), length);
+        Symbol[length] = '\0';
         Side = (OrderSide)value.side();
         Type = (OrderType)value.type();
         Price = value.price();
@@ -50,8 +53,10 @@ struct Balance
 
     void Deserialize(const Trade::protobuf::Balance& value)
     {
-        std::string currency = value.currency();
-        std::memcpy(Currency, currency.c_str(), std::min(currency.size() + 1, sizeof(Currency)));
+        const std::string& currency = value.currency();
+        size_t length = std::min(currency.size(), sizeof(Currency) - 1);
+        std::memcpy(Currency, currency.data(), length);
+        Currency[length] = '\0';
         Amount = value.amount();
     }
 
@@ -66,6 +71,7 @@ struct Account
 
     Trade::protobuf::Account& Serialize(Trade::protobuf::Account& value)
     {
+        TRADE_METRICS_SCOPE(timer, Account, Protobuf, Serialize);
         value.set_id(id);
         value.set_name(Name);
         value.set_allocated_wallet(&Wallet.Serialize(*value.wallet().New(value.GetArena())));
@@ -76,16 +82,13 @@ struct Account
 
     void Deserialize(const Trade::protobuf::Account& value)
     {
+        TRADE_METRICS_SCOPE(timer, Account, Protobuf, Deserialize);
         Id = value.id();
-        Name = value.name();
+        Name.assign(value.name().data(), value.name().size());  // std::pmr::string, reuses its buffer
         Wallet.Deserialize(value.wallet());
-        Orders.clear();
+        Orders.resize(value.orders_size());  // sized once from the encoded count, capacity is never given back
         for (int i = 0; i < value.orders_size(); ++i)
-        {
-            Order order;
-            order.Deserialize(value.orders(i));
-            Orders.emplace_back(order);
-        }
+            Orders[i].Deserialize(value.orders(i));  // decoded in place, no temporary Order
     }
 
     ...
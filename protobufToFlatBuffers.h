@@ -0,0 +1,431 @@
+#ifndef PROTOBUF_TO_FLATBUFFERS_H
+#define PROTOBUF_TO_FLATBUFFERS_H
+
+/* Converts a parsed .proto (ProtoFile from ProtoParser, or a FileDescriptorProto) into a FlatBuffers
+schema, both as reflection::SchemaT and as .fbs text. The reverse of FlatBuffersToProtobuf.
+
+pb enums -> fb enums with the narrowest underlying type that holds every value (byte for OrderSide)
+pb messages -> fb tables
+pb scalars -> fb scalars of the same width (int32 -> int, uint64 -> ulong, ...), bytes -> [ubyte]
+pb repeated fields -> fb vectors
+
+Table field ids follow the protobuf field numbers (id = number - 1), so ids stay stable as the .proto
+evolves. FlatBuffers wants ids without gaps, so unused numbers become deprecated placeholder fields
+(unused_<number>) that take a vtable slot but no space in the table. The .fbs declares fields in
+id order. */
+
+#include "protoParser.h"
+#include "reflection_generated.h"
+#include <google/protobuf/descriptor.pb.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class ProtobufToFlatBuffers {
+public:
+    // name_space is the FlatBuffers namespace for every type, e.g. "Trade.flatbuf".
+    // root_type defaults to the last message no other message refers to
+    ProtobufToFlatBuffers(const ProtoFile& proto, std::string name_space, std::string root_type = "")
+        : proto_(proto), namespace_(std::move(name_space)), root_type_(std::move(root_type)) {
+        Index();
+    }
+
+    // Lifts a FileDescriptorProto into the ProtoFile model (pass its package as name_space)
+    static ProtoFile FromDescriptor(const google::protobuf::FileDescriptorProto& file_desc) {
+        ProtoFile proto;
+        for (const auto& enum_desc : file_desc.enum_type()) {
+            Enum e;
+            e.name = enum_desc.name();
+            for (const auto& value : enum_desc.value()) e.values.push_back({ value.name(), value.number() });
+            proto.enums.push_back(std::move(e));
+        }
+        for (const auto& msg_desc : file_desc.message_type()) {
+            Message msg;
+            msg.name = msg_desc.name();
+            for (const auto& field_desc : msg_desc.field()) {
+                Field field;
+                field.name = field_desc.name();
+                field.number = field_desc.number();
+                field.repeated = field_desc.label() == google::protobuf::FieldDescriptorProto::LABEL_REPEATED;
+                field.type = field_desc.type_name().empty() ? ScalarTypeName(field_desc.type()) : ShortName(field_desc.type_name());
+                msg.fields.push_back(std::move(field));
+            }
+            proto.messages.push_back(std::move(msg));
+        }
+        return proto;
+    }
+
+    // Builds the reflection schema (fields sorted by name, as flatc stores them)
+    std::unique_ptr<reflection::SchemaT> ConvertSchema() const {
+        std::unique_ptr<reflection::SchemaT> schema(new reflection::SchemaT());
+        schema->file_name = FileBase() + ".fbs";
+
+        for (const Enum& e : proto_.enums) {
+            std::unique_ptr<reflection::EnumT> enum_def(new reflection::EnumT());
+            enum_def->name = Qualified(e.name);
+            enum_def->underlying_type.reset(new reflection::TypeT());
+            enum_def->underlying_type->base_type = NarrowestEnumType(e);
+            enum_def->underlying_type->base_size = static_cast<uint32_t>(ScalarSize(enum_def->underlying_type->base_type));
+            for (const auto& value : e.values) {
+                std::unique_ptr<reflection::EnumValT> val(new reflection::EnumValT());
+                val->name = value.first;
+                val->value = value.second;
+                enum_def->values.push_back(std::move(val));
+            }
+            std::sort(enum_def->values.begin(), enum_def->values.end(),
+                      [](const std::unique_ptr<reflection::EnumValT>& a, const std::unique_ptr<reflection::EnumValT>& b) { return a->value < b->value; });
+            schema->enums.push_back(std::move(enum_def));
+        }
+
+        for (const Message& msg : proto_.messages) {
+            std::unique_ptr<reflection::ObjectT> obj(new reflection::ObjectT());
+            obj->name = Qualified(msg.name);
+            obj->minalign = 1;
+            std::vector<const Field*> by_id = FieldsById(msg);
+            for (size_t id = 0; id < by_id.size(); ++id) {
+                std::unique_ptr<reflection::FieldT> f(new reflection::FieldT());
+                f->id = static_cast<uint16_t>(id);
+                f->offset = static_cast<uint16_t>(4 + 2 * id);  // vtable slot
+                if (!by_id[id]) {
+                    f->name = PlaceholderName(msg, id);
+                    f->deprecated = true;
+                    f->type.reset(new reflection::TypeT());
+                    f->type->base_type = reflection::BaseType_UByte;
+                    f->type->base_size = 1;
+                    obj->fields.push_back(std::move(f));
+                    continue;
+                }
+                const Field& field = *by_id[id];
+                f->name = field.name;
+                f->type.reset(new reflection::TypeT(ResolveType(field)));
+                obj->minalign = std::max<int32_t>(obj->minalign, static_cast<int32_t>(InlineSize(field)));
+                obj->fields.push_back(std::move(f));
+            }
+            std::sort(obj->fields.begin(), obj->fields.end(),
+                      [](const std::unique_ptr<reflection::FieldT>& a, const std::unique_ptr<reflection::FieldT>& b) { return a->name < b->name; });
+            schema->objects.push_back(std::move(obj));
+        }
+        // reflection keeps objects and enums sorted by name; indexes were resolved against the
+        // .proto order, so sort and rewrite them
+        SortByName(*schema);
+
+        std::string root = RootType();
+        for (const auto& obj : schema->objects)
+            if (obj->name == Qualified(root)) schema->root_table.reset(new reflection::ObjectT(CopyObject(*obj)));
+        return schema;
+    }
+
+    // .fbs text in the style of fbsSchema.fbs
+    std::string ConvertText() const {
+        std::ostringstream out;
+        if (!namespace_.empty()) out << "namespace " << namespace_ << ";\n\n";
+
+        for (const Enum& e : proto_.enums) {
+            out << "enum " << e.name << " : " << FbsScalarName(NarrowestEnumType(e)) << "\n{\n";
+            std::vector<std::pair<std::string, int>> values = e.values;
+            std::sort(values.begin(), values.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second < b.second; });
+            for (size_t i = 0; i < values.size(); ++i)
+                out << "    " << values[i].first << " = " << values[i].second << (i + 1 < values.size() ? ",\n" : "\n");
+            out << "}\n\n";
+        }
+
+        for (const Message& msg : proto_.messages) {
+            std::vector<const Field*> by_id = FieldsById(msg);  // nullptr for a placeholder
+            out << "table " << msg.name << "\n{\n";
+            for (size_t id = 0; id < by_id.size(); ++id) {
+                if (!by_id[id]) {
+                    out << "    " << PlaceholderName(msg, id) << " : ubyte (id: " << id << ", deprecated);\n";
+                    continue;
+                }
+                out << "    " << by_id[id]->name << " : " << FbsTypeName(*by_id[id]) << " (id: " << id << ");\n";
+            }
+            out << "}\n\n";
+        }
+
+        std::string root = RootType();
+        if (!root.empty()) out << "root_type " << root << ";\n";
+        return out.str();
+    }
+
+    // Checks that converting the FlatBuffers schema back to protobuf (FlatBuffersToProtobuf) gives the
+    // same messages, field names, numbers, labels and type kinds. Describes the first difference in diff.
+    // bytes fields become [ubyte] and come back as repeated uint32, so they never match
+    bool RoundTripMatches(const google::protobuf::FileDescriptorProto& back, std::string* diff = nullptr) const {
+        auto fail = [diff](const std::string& what) {
+            if (diff) *diff = what;
+            return false;
+        };
+        std::map<std::string, const google::protobuf::DescriptorProto*> messages;
+        for (const auto& m : back.message_type()) messages[ShortName(m.name())] = &m;
+        for (const Message& msg : proto_.messages) {
+            auto it = messages.find(msg.name);
+            if (it == messages.end()) return fail("message " + msg.name + " missing");
+            for (const Field& field : msg.fields) {
+                const google::protobuf::FieldDescriptorProto* match = nullptr;
+                for (const auto& f : it->second->field())
+                    if (f.name() == field.name) match = &f;
+                if (!match) return fail(msg.name + "." + field.name + " missing");
+                if (match->number() != field.number)
+                    return fail(msg.name + "." + field.name + " is number " + std::to_string(field.number) + ", came back as " + std::to_string(match->number()));
+                bool repeated = match->label() == google::protobuf::FieldDescriptorProto::LABEL_REPEATED;
+                if (repeated != field.repeated) return fail(msg.name + "." + field.name + " label differs");
+                std::string back_type = match->type_name().empty() ? ScalarTypeName(match->type()) : ShortName(match->type_name());
+                if (!SameKind(field.type, back_type)) return fail(msg.name + "." + field.name + " is " + field.type + ", came back as " + back_type);
+            }
+        }
+        return true;
+    }
+
+private:
+    const ProtoFile& proto_;
+    std::string namespace_;
+    std::string root_type_;
+    std::map<std::string, size_t> message_index_;
+    std::map<std::string, size_t> enum_index_;
+
+    void Index() {
+        for (size_t i = 0; i < proto_.messages.size(); ++i) message_index_[proto_.messages[i].name] = i;
+        for (size_t i = 0; i < proto_.enums.size(); ++i) enum_index_[proto_.enums[i].name] = i;
+    }
+
+    std::string Qualified(const std::string& name) const { return namespace_.empty() ? name : namespace_ + "." + name; }
+
+    std::string FileBase() const {
+        std::string root = RootType();
+        return root.empty() ? "schema" : root;
+    }
+
+    static std::string ShortName(const std::string& name) {
+        size_t dot = name.find_last_of('.');
+        return dot == std::string::npos ? name : name.substr(dot + 1);
+    }
+
+    // Fields indexed by FlatBuffers id (number - 1), nullptr where the .proto skips a number
+    static std::vector<const Field*> FieldsById(const Message& msg) {
+        const int kMaxNumber = 32766;  // the vtable slot 4 + 2 * id must fit a uint16 voffset
+        std::vector<const Field*> fields;
+        for (const Field& f : msg.fields) {
+            if (f.number < 1 || f.number > kMaxNumber)
+                throw std::runtime_error("Field " + msg.name + "." + f.name + " number " + std::to_string(f.number) + " has no FlatBuffers id");
+            size_t id = static_cast<size_t>(f.number - 1);
+            if (id >= fields.size()) fields.resize(id + 1, nullptr);
+            if (fields[id]) throw std::runtime_error("Fields " + fields[id]->name + " and " + f.name + " of " + msg.name + " share a number");
+            fields[id] = &f;
+        }
+        return fields;
+    }
+
+    // Name of the deprecated field holding id's slot, kept clear of the message's real field names
+    static std::string PlaceholderName(const Message& msg, size_t id) {
+        std::string name = "unused_" + std::to_string(id + 1);
+        for (;;) {
+            bool taken = false;
+            for (const Field& f : msg.fields) taken = taken || f.name == name;
+            if (!taken) return name;
+            name += "_";
+        }
+    }
+
+    std::string RootType() const {
+        if (!root_type_.empty()) return root_type_;
+        std::map<std::string, bool> referenced;
+        for (const Message& msg : proto_.messages)
+            for (const Field& f : msg.fields) referenced[f.type] = true;
+        std::string root;
+        for (const Message& msg : proto_.messages)
+            if (!referenced.count(msg.name)) root = msg.name;
+        return root;
+    }
+
+    static reflection::BaseType ScalarBaseType(const std::string& type) {
+        if (type == "bool") return reflection::BaseType_Bool;
+        if (type == "int32" || type == "sint32" || type == "sfixed32") return reflection::BaseType_Int;
+        if (type == "uint32" || type == "fixed32") return reflection::BaseType_UInt;
+        if (type == "int64" || type == "sint64" || type == "sfixed64") return reflection::BaseType_Long;
+        if (type == "uint64" || type == "fixed64") return reflection::BaseType_ULong;
+        if (type == "float") return reflection::BaseType_Float;
+        if (type == "double") return reflection::BaseType_Double;
+        if (type == "string") return reflection::BaseType_String;
+        return reflection::BaseType_None;
+    }
+
+    static std::string ScalarTypeName(google::protobuf::FieldDescriptorProto::Type type) {
+        switch (type) {
+        case google::protobuf::FieldDescriptorProto::TYPE_BOOL: return "bool";
+        case google::protobuf::FieldDescriptorProto::TYPE_INT32: return "int32";
+        case google::protobuf::FieldDescriptorProto::TYPE_SINT32: return "sint32";
+        case google::protobuf::FieldDescriptorProto::TYPE_SFIXED32: return "sfixed32";
+        case google::protobuf::FieldDescriptorProto::TYPE_UINT32: return "uint32";
+        case google::protobuf::FieldDescriptorProto::TYPE_FIXED32: return "fixed32";
+        case google::protobuf::FieldDescriptorProto::TYPE_INT64: return "int64";
+        case google::protobuf::FieldDescriptorProto::TYPE_SINT64: return "sint64";
+        case google::protobuf::FieldDescriptorProto::TYPE_SFIXED64: return "sfixed64";
+        case google::protobuf::FieldDescriptorProto::TYPE_UINT64: return "uint64";
+        case google::protobuf::FieldDescriptorProto::TYPE_FIXED64: return "fixed64";
+        case google::protobuf::FieldDescriptorProto::TYPE_FLOAT: return "float";
+        case google::protobuf::FieldDescriptorProto::TYPE_DOUBLE: return "double";
+        case google::protobuf::FieldDescriptorProto::TYPE_STRING: return "string";
+        case google::protobuf::FieldDescriptorProto::TYPE_BYTES: return "bytes";
+        default: return "";
+        }
+    }
+
+    // Types that survive pb -> fb -> pb as the same kind (width and signedness, or the same named type)
+    bool SameKind(const std::string& original, const std::string& back) const {
+        if (original == back) return true;
+        reflection::BaseType a = ScalarBaseType(original);
+        return a != reflection::BaseType_None && a == ScalarBaseType(back);
+    }
+
+    static size_t ScalarSize(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool:
+        case reflection::BaseType_Byte:
+        case reflection::BaseType_UByte: return 1;
+        case reflection::BaseType_Short:
+        case reflection::BaseType_UShort: return 2;
+        case reflection::BaseType_Long:
+        case reflection::BaseType_ULong:
+        case reflection::BaseType_Double: return 8;
+        default: return 4;  // int, uint, float and every offset (string, vector, table)
+        }
+    }
+
+    static const char* FbsScalarName(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool: return "bool";
+        case reflection::BaseType_Byte: return "byte";
+        case reflection::BaseType_UByte: return "ubyte";
+        case reflection::BaseType_Short: return "short";
+        case reflection::BaseType_UShort: return "ushort";
+        case reflection::BaseType_Int: return "int";
+        case reflection::BaseType_UInt: return "uint";
+        case reflection::BaseType_Long: return "long";
+        case reflection::BaseType_ULong: return "ulong";
+        case reflection::BaseType_Float: return "float";
+        case reflection::BaseType_Double: return "double";
+        case reflection::BaseType_String: return "string";
+        default: return "";
+        }
+    }
+
+    // Smallest integer type holding every value of the enum
+    static reflection::BaseType NarrowestEnumType(const Enum& e) {
+        long long lo = 0, hi = 0;
+        for (const auto& value : e.values) {
+            lo = std::min<long long>(lo, value.second);
+            hi = std::max<long long>(hi, value.second);
+        }
+        if (lo >= std::numeric_limits<int8_t>::min() && hi <= std::numeric_limits<int8_t>::max()) return reflection::BaseType_Byte;
+        if (lo >= 0 && hi <= std::numeric_limits<uint8_t>::max()) return reflection::BaseType_UByte;
+        if (lo >= std::numeric_limits<int16_t>::min() && hi <= std::numeric_limits<int16_t>::max()) return reflection::BaseType_Short;
+        if (lo >= 0 && hi <= std::numeric_limits<uint16_t>::max()) return reflection::BaseType_UShort;
+        return reflection::BaseType_Int;
+    }
+
+    reflection::TypeT ResolveType(const Field& field) const {
+        reflection::TypeT type;
+        reflection::BaseType base = reflection::BaseType_None;
+        int32_t index = -1;
+        if (field.type == "bytes") {
+            base = reflection::BaseType_UByte;
+            type.base_type = reflection::BaseType_Vector;  // bytes are always a vector, repeated bytes aren't supported
+            type.element = base;
+            type.element_size = 1;
+            return type;
+        }
+        auto m = message_index_.find(field.type);
+        auto e = enum_index_.find(field.type);
+        if (m != message_index_.end()) {
+            base = reflection::BaseType_Obj;
+            index = static_cast<int32_t>(m->second);
+        } else if (e != enum_index_.end()) {
+            base = NarrowestEnumType(proto_.enums[e->second]);
+            index = static_cast<int32_t>(e->second);
+        } else {
+            base = ScalarBaseType(field.type);
+            if (base == reflection::BaseType_None) throw std::runtime_error("Unknown type " + field.type + " for field " + field.name);
+        }
+
+        if (field.repeated) {
+            type.base_type = reflection::BaseType_Vector;
+            type.element = base;
+            type.element_size = static_cast<uint32_t>(ScalarSize(base));
+        } else {
+            type.base_type = base;
+            type.base_size = static_cast<uint32_t>(ScalarSize(base));
+        }
+        type.index = index;
+        return type;
+    }
+
+    // Bytes the field takes inside the table itself
+    size_t InlineSize(const Field& field) const {
+        if (field.repeated || field.type == "bytes") return 4;
+        if (message_index_.count(field.type)) return 4;
+        auto e = enum_index_.find(field.type);
+        if (e != enum_index_.end()) return ScalarSize(NarrowestEnumType(proto_.enums[e->second]));
+        return ScalarSize(ScalarBaseType(field.type));
+    }
+
+    std::string FbsTypeName(const Field& field) const {
+        if (field.type == "bytes") return "[ubyte]";
+        std::string name;
+        if (message_index_.count(field.type) || enum_index_.count(field.type)) name = field.type;
+        else name = FbsScalarName(ScalarBaseType(field.type));
+        return field.repeated ? "[" + name + "]" : name;
+    }
+
+    static reflection::ObjectT CopyObject(const reflection::ObjectT& obj) {
+        reflection::ObjectT copy;
+        copy.name = obj.name;
+        copy.is_struct = obj.is_struct;
+        copy.minalign = obj.minalign;
+        copy.bytesize = obj.bytesize;
+        for (const auto& f : obj.fields) {
+            std::unique_ptr<reflection::FieldT> field(new reflection::FieldT());
+            field->name = f->name;
+            field->id = f->id;
+            field->offset = f->offset;
+            field->deprecated = f->deprecated;
+            field->type.reset(new reflection::TypeT(*f->type));
+            copy.fields.push_back(std::move(field));
+        }
+        return copy;
+    }
+
+    // Sorts objects and enums by name and rewrites every type index to match
+    static void SortByName(reflection::SchemaT& schema) {
+        auto remap = [](auto& items) {
+            std::vector<size_t> order(items.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::sort(order.begin(), order.end(), [&items](size_t a, size_t b) { return items[a]->name < items[b]->name; });
+            std::vector<int32_t> new_index(items.size());
+            auto sorted = std::move(items);
+            items.clear();
+            for (size_t i = 0; i < order.size(); ++i) {
+                new_index[order[i]] = static_cast<int32_t>(i);
+                items.push_back(std::move(sorted[order[i]]));
+            }
+            return new_index;
+        };
+        std::vector<int32_t> object_index = remap(schema.objects);
+        std::vector<int32_t> enum_index = remap(schema.enums);
+        for (auto& obj : schema.objects) {
+            for (auto& f : obj->fields) {
+                reflection::TypeT& t = *f->type;
+                if (t.index < 0) continue;
+                bool is_obj = t.base_type == reflection::BaseType_Obj || (t.base_type == reflection::BaseType_Vector && t.element == reflection::BaseType_Obj);
+                t.index = is_obj ? object_index[t.index] : enum_index[t.index];
+            }
+        }
+    }
+};
+
+#endif // PROTOBUF_TO_FLATBUFFERS_H
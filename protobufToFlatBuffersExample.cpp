@@ -0,0 +1,96 @@
+#include "protoParser.h"
+#include "protobufToFlatBuffers.h"
+#include "FlatbuffersToProtobuf"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Checks the converted schema itself: one table per message, each field at id number - 1 and a
+// vector exactly when it is repeated, every other id a deprecated placeholder. Empty when it holds
+static std::string CheckSchema(const ProtoFile& proto, const reflection::SchemaT& schema, const std::string& name_space)
+{
+    for (const Message& msg : proto.messages)
+    {
+        const reflection::ObjectT* table = nullptr;
+        for (const auto& obj : schema.objects)
+            if (obj->name == name_space + "." + msg.name) table = obj.get();
+        if (!table || table->is_struct) return "no table for message " + msg.name;
+
+        size_t live = 0;
+        for (const auto& f : table->fields)
+        {
+            if (f->deprecated)
+                continue;
+            ++live;
+            const Field* field = nullptr;
+            for (const Field& candidate : msg.fields)
+                if (candidate.name == f->name) field = &candidate;
+            if (!field) return msg.name + "." + f->name + " is not in the .proto";
+            if (f->id != field->number - 1) return msg.name + "." + f->name + " has id " + std::to_string(f->id);
+            if ((f->type->base_type == reflection::BaseType_Vector) != field->repeated) return msg.name + "." + f->name + " repeated mismatch";
+        }
+        if (live != msg.fields.size()) return msg.name + " lost fields";
+        for (size_t id = 0; id < table->fields.size(); ++id)
+        {
+            bool found = false;
+            for (const auto& f : table->fields)
+                found = found || f->id == id;
+            if (!found) return msg.name + " has no field with id " + std::to_string(id);
+        }
+    }
+    return "";
+}
+
+int main(int argc, char** argv)
+{
+    // Parse the protobuf schema (defaults to the one in this repo)
+    std::ifstream in(argc > 1 ? argv[1] : "protobufSchema.proto");
+    std::stringstream source;
+    source << in.rdbuf();
+    ProtoParser parser(source.str());
+    ProtoFile proto = parser.ParseFile();
+
+    // Convert to a FlatBuffers schema and show the .fbs text
+    ProtobufToFlatBuffers converter(proto, "Trade.flatbuf");
+    std::cout << converter.ConvertText() << std::endl;
+
+    std::unique_ptr<reflection::SchemaT> converted = converter.ConvertSchema();
+    std::string problem = CheckSchema(proto, *converted, "Trade.flatbuf");
+    if (!problem.empty())
+    {
+        std::cout << "Converted schema FAILED: " << problem << std::endl;
+        return 1;
+    }
+    std::cout << "Converted schema OK" << std::endl;
+
+    // Round trip: .proto -> reflection::SchemaT -> FileDescriptorProto must describe the same messages
+    std::unique_ptr<reflection::SchemaT> schema = converter.ConvertSchema();
+    google::protobuf::FileDescriptorProto back = FlatBuffersToProtobuf(schema.get()).Convert();
+    std::string diff;
+    if (!converter.RoundTripMatches(back, &diff))
+    {
+        std::cout << "Round trip FAILED: " << diff << std::endl;
+        return 1;
+    }
+    std::cout << "Round trip OK" << std::endl;
+
+    // Benchmark both directions
+    const int iterations = 10000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        schema = converter.ConvertSchema();
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        back = FlatBuffersToProtobuf(schema.get()).Convert();
+    auto end = std::chrono::steady_clock::now();
+
+    auto ns = [](std::chrono::steady_clock::duration d) { return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(); };
+    std::cout << "proto -> fbs: " << ns(middle - start) / iterations << " ns/schema" << std::endl;
+    std::cout << "fbs -> proto: " << ns(end - middle) / iterations << " ns/schema" << std::endl;
+
+    google::protobuf::ShutdownProtobufLibrary();
+    return 0;
+}
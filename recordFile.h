@@ -0,0 +1,223 @@
+#ifndef RECORD_FILE_H
+#define RECORD_FILE_H
+
+/* Record archive format used for Account dumps.
+
+Each record is an 8 byte header followed by the payload, padded so the next header
+starts on an 8 byte boundary:
+
+    uint32 size    payload length in bytes (little endian)
+    uint32 format  RecordFormat of the payload
+    payload        size bytes, 8 byte aligned
+    padding        0-7 zero bytes
+
+Keeping payloads 8 byte aligned lets FlatBuffers be read (and verified) in place
+straight out of an mmapped file. */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class RecordFormat : uint32_t {
+    FlatBuffer = 0,   // Trade::flatbuf::Account
+    Protobuf = 1,     // Trade::protobuf::Account
+    ProtobufC = 2     // Accounts__Account (accounts.proto)
+};
+
+// Header in front of every payload
+struct RecordHeader {
+    uint32_t size;
+    uint32_t format;
+};
+static_assert(sizeof(RecordHeader) == 8, "record header must stay 8 bytes");
+
+// A payload inside a mapped file or buffer, offset is where the header starts
+struct RecordRef {
+    uint64_t offset;
+    uint32_t size;
+    RecordFormat format;
+    const uint8_t* data;
+};
+
+inline size_t RecordPadding(size_t size) { return (8 - (size & 7)) & 7; }
+
+// Full on-disk footprint of a record with this payload size
+inline size_t RecordSpan(size_t size) { return sizeof(RecordHeader) + size + RecordPadding(size); }
+
+// Reads the record at offset, returns false on a truncated or corrupt header
+inline bool ReadRecordAt(const uint8_t* base, size_t length, uint64_t offset, RecordRef& record) {
+    if (offset + sizeof(RecordHeader) > length) return false;
+    RecordHeader header;
+    std::memcpy(&header, base + offset, sizeof(header));
+    if (header.size > length - offset - sizeof(RecordHeader)) return false;
+    record.offset = offset;
+    record.size = header.size;
+    record.format = static_cast<RecordFormat>(header.format);
+    record.data = base + offset + sizeof(RecordHeader);
+    return true;
+}
+
+// Walks every record in [base, base + length), calling fn(const RecordRef&).
+// Stops at the first truncated record (a partially written tail) and returns the bytes consumed.
+template <typename F>
+size_t ForEachRecord(const uint8_t* base, size_t length, F&& fn) {
+    uint64_t offset = 0;
+    RecordRef record;
+    while (ReadRecordAt(base, length, offset, record)) {
+        fn(record);
+        offset += RecordSpan(record.size);
+    }
+    return offset > length ? length : static_cast<size_t>(offset);
+}
+
+// Appends records to a file
+class RecordWriter {
+public:
+    explicit RecordWriter(const std::string& path) : out_(path, std::ios::binary | std::ios::trunc) {
+        if (!out_) throw std::runtime_error("Cannot open record file: " + path);
+    }
+
+    // Returns the offset the record was written at. Payloads must fit the 32 bit size field
+    uint64_t Append(const void* data, size_t size, RecordFormat format) {
+        static const char zeros[8] = {};
+        if (size > UINT32_MAX) throw std::runtime_error("Record too large: " + std::to_string(size) + " bytes");
+        RecordHeader header{ static_cast<uint32_t>(size), static_cast<uint32_t>(format) };
+        uint64_t at = offset_;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.write(static_cast<const char*>(data), size);
+        out_.write(zeros, RecordPadding(size));
+        if (!out_) throw std::runtime_error("Record write failed");
+        offset_ += RecordSpan(size);
+        return at;
+    }
+
+    void Flush() { out_.flush(); }
+
+private:
+    std::ofstream out_;
+    uint64_t offset_ = 0;
+};
+
+// Read-only mapping of a whole record file
+class MappedRecordFile {
+public:
+    explicit MappedRecordFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("Cannot open record file: " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat record file: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        inode_ = static_cast<uint64_t>(st.st_ino);
+        mtime_ns_ = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map record file: " + path);
+            }
+            data_ = static_cast<const uint8_t*>(p);
+            ::madvise(p, size_, MADV_SEQUENTIAL);  // scans walk the file front to back
+        }
+        ::close(fd);  // the mapping keeps the file alive
+    }
+
+    ~MappedRecordFile() {
+        if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+
+    MappedRecordFile(const MappedRecordFile&) = delete;
+    MappedRecordFile& operator=(const MappedRecordFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Identity of the file as mapped, for sidecar files that must match it
+    uint64_t inode() const { return inode_; }
+    uint64_t mtime_ns() const { return mtime_ns_; }
+
+    // Switches the mapping from sequential readahead to random access, for point lookups
+    void AdviseRandom() const {
+        if (data_) ::madvise(const_cast<uint8_t*>(data_), size_, MADV_RANDOM);
+    }
+
+    // Header offsets of every record, cheap since only the headers are touched
+    std::vector<RecordRef> Index() const {
+        std::vector<RecordRef> records;
+        ForEachRecord(data_, size_, [&records](const RecordRef& r) { records.push_back(r); });
+        return records;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    uint64_t inode_ = 0;
+    uint64_t mtime_ns_ = 0;
+};
+
+// Pulls whole records out of a stream in batches of roughly batch_bytes.
+// The buffer is 8 byte aligned and reused between calls; records in it stay valid until the next call.
+class RecordStreamReader {
+public:
+    explicit RecordStreamReader(std::istream& in, size_t batch_bytes = 8 << 20)
+        : in_(in), batch_bytes_(batch_bytes) {}
+
+    // Fills records with the next batch, returns false once the stream is exhausted. A stream that
+    // ends inside a record, header or payload, throws std::runtime_error
+    bool NextBatch(std::vector<RecordRef>& records) {
+        records.clear();
+        used_ = 0;
+        offsets_.clear();
+        while (used_ < batch_bytes_) {
+            RecordHeader header;
+            if (!in_.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+                if (in_.gcount() > 0) throw std::runtime_error("Truncated record header in stream");
+                break;
+            }
+            size_t span = RecordSpan(header.size);
+            Grow(used_ + span);
+            std::memcpy(Bytes() + used_, &header, sizeof(header));
+            size_t body = span - sizeof(header);
+            if (!in_.read(reinterpret_cast<char*>(Bytes() + used_ + sizeof(header)), body) &&
+                static_cast<size_t>(in_.gcount()) < header.size)
+                throw std::runtime_error("Truncated record in stream");
+            offsets_.push_back(used_);
+            used_ += span;
+        }
+        // Pointers are taken after the last Grow so they stay valid
+        for (size_t offset : offsets_) {
+            RecordRef record;
+            ReadRecordAt(Bytes(), used_, offset, record);
+            records.push_back(record);
+        }
+        return !records.empty();
+    }
+
+private:
+    std::istream& in_;
+    size_t batch_bytes_;
+    std::vector<uint64_t> buffer_;   // uint64_t storage keeps payloads 8 byte aligned
+    std::vector<size_t> offsets_;
+    size_t used_ = 0;
+
+    uint8_t* Bytes() { return reinterpret_cast<uint8_t*>(buffer_.data()); }
+
+    void Grow(size_t bytes) {
+        size_t words = (bytes + 7) / 8;
+        if (words > buffer_.size()) buffer_.resize(std::max(words, buffer_.size() * 2));
+    }
+};
+
+#endif // RECORD_FILE_H
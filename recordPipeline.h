@@ -0,0 +1,600 @@
+#ifndef RECORD_PIPELINE_H
+#define RECORD_PIPELINE_H
+
+/* Pipelined ingest of record files (recordFile.h) into TradeProto::Account objects.
+
+    read stage      one thread keeps queue_depth block reads in flight, through io_uring when
+                    liburing is available and the kernel allows it, otherwise through pread on
+                    a ThreadPool. Completed blocks are put back in file order and cut into
+                    batches of whole records.
+    decode stage    decode_threads workers verify and decode each record (FlatBuffer, protobuf or
+                    protobuf-c, taken from the record header) into reusable Account objects.
+    consume stage   one thread hands accounts to the callback in file order.
+
+Stages talk through BoundedQueues, so a slow consumer stalls decoding, which stalls
+reading, instead of buffering the whole file in memory. The first exception thrown in any
+stage (the consumer included) stops the others and is rethrown from Run().
+
+Usage:
+    RecordPipeline pipeline(options);
+    RecordPipeline::Stats stats = pipeline.Run("accounts.rec",
+        [](const TradeProto::Account& account, const RecordRef& record) { ... });
+*/
+
+#include "../proto/trade.h"
+#include "accounts.pb-c.h"
+#include "recordFile.h"
+#include "tradeMetrics.h"
+#include "threadPool.h"
+#include "tradeVerifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__has_include)
+#if __has_include(<liburing.h>) && !defined(RECORD_PIPELINE_NO_IO_URING)
+#include <liburing.h>
+#define RECORD_PIPELINE_HAVE_IO_URING 1
+#endif
+#endif
+
+// Blocking FIFO with a fixed capacity, Push() waits while full (backpressure), Pop() while empty
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    // Returns false if the queue was closed
+    bool Push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(value));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Returns false once the queue is closed and drained
+    bool Pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        value = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Non-blocking Push, returns false if full or closed
+    bool TryPush(T value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || items_.size() >= capacity_) return false;
+        items_.push_back(std::move(value));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool TryPop(T& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) return false;
+        value = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Wakes everyone, Pop() keeps returning queued items until empty
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    std::deque<T> items_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    bool closed_ = false;
+};
+
+namespace TradeProto {
+
+template <size_t N>
+inline void CopyFixedString(char (&dst)[N], const char* src, size_t len) {
+    len = std::min(len, N - 1);
+    std::memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+// Decodes one record of any supported format into account, reusing its storage.
+// Returns false on a corrupt payload or an unknown format.
+inline bool DecodeAccountRecord(const RecordRef& record, Account& account) {
+    switch (record.format) {
+    case RecordFormat::FlatBuffer: {
+        {
+            TRADE_METRICS_SCOPE(timer, Account, FlatBuffer, Verify);
+            TRADE_METRICS_BYTES(timer, record.size, 0);
+            if (VerifyAccountBuffer(record.data, record.size) != VerifyError::None) {
+                TRADE_METRICS_ERROR(Account, FlatBuffer, Verify);
+                return false;
+            }
+        }
+        account.Deserialize(*Trade::flatbuf::GetAccount(record.data));  // times itself
+        return true;
+    }
+    case RecordFormat::Protobuf: {
+        thread_local Trade::protobuf::Account message;  // reused so parsing keeps its capacity
+        {
+            TRADE_METRICS_SCOPE(timer, Account, Protobuf, Parse);
+            TRADE_METRICS_BYTES(timer, record.size, 0);
+            if (!message.ParseFromArray(record.data, static_cast<int>(record.size))) {
+                TRADE_METRICS_ERROR(Account, Protobuf, Parse);
+                return false;
+            }
+        }
+        account.Deserialize(message);  // times itself
+        return true;
+    }
+    case RecordFormat::ProtobufC: {
+        TRADE_METRICS_SCOPE(timer, Account, ProtobufC, Deserialize);
+        TRADE_METRICS_BYTES(timer, record.size, 0);
+        Accounts__Account* message = accounts__account__unpack(nullptr, record.size, record.data);
+        if (!message) {
+            TRADE_METRICS_ERROR(Account, ProtobufC, Parse);
+            return false;
+        }
+        account.Id = message->id;
+        account.Name = message->name;
+        if (message->wallet) {
+            CopyFixedString(account.Wallet.Currency, message->wallet->currency, std::strlen(message->wallet->currency));
+            account.Wallet.Amount = message->wallet->amount;
+        } else {
+            account.Wallet.Currency[0] = '\0';  // account is reused, don't keep the previous record's wallet
+            account.Wallet.Amount = 0;
+        }
+        account.Orders.resize(message->n_orders);
+        for (size_t i = 0; i < message->n_orders; ++i) {
+            const Accounts__Order* src = message->orders[i];
+            Order& dst = account.Orders[i];
+            dst.Id = src->id;
+            CopyFixedString(dst.Symbol, src->symbol, std::strlen(src->symbol));
+            dst.Side = (OrderSide)src->side;
+            dst.Type = (OrderType)src->type;
+            dst.Price = src->price;
+            dst.Volume = src->volume;
+        }
+        accounts__account__free_unpacked(message, nullptr);
+        return true;
+    }
+    }
+    return false;
+}
+
+} // namespace TradeProto
+
+class RecordPipeline {
+public:
+    struct Options {
+        size_t block_bytes = 1 << 20;   // size of each read
+        size_t queue_depth = 16;        // reads kept in flight
+        size_t decode_threads = 0;      // 0 = hardware threads - 2
+        size_t queue_batches = 32;      // capacity of each inter-stage queue
+        bool direct_io = false;         // O_DIRECT, bypasses the page cache for one-shot scans
+        bool use_io_uring = true;       // false forces the thread pool reader
+    };
+
+    struct Stats {
+        uint64_t records = 0;
+        uint64_t bytes = 0;
+        uint64_t decode_errors = 0;     // corrupt records, plus one for a truncated last record
+        uint64_t truncated_bytes = 0;   // bytes of the partial record the file ends with
+        bool used_io_uring = false;
+    };
+
+    using Consumer = std::function<void(const TradeProto::Account&, const RecordRef&)>;
+
+    RecordPipeline() : RecordPipeline(Options()) {}
+    explicit RecordPipeline(const Options& options) : options_(options) {
+        if (options_.block_bytes % kAlign != 0) throw std::invalid_argument("block_bytes must be a multiple of 4096");
+        if (options_.decode_threads == 0) {
+            unsigned hw = std::thread::hardware_concurrency();
+            options_.decode_threads = hw > 3 ? hw - 2 : 1;
+        }
+    }
+
+    ~RecordPipeline() {
+        for (Block* b : free_blocks_) delete b;
+    }
+
+    RecordPipeline(const RecordPipeline&) = delete;
+    RecordPipeline& operator=(const RecordPipeline&) = delete;
+
+    // Runs all three stages over the file and returns once the consumer has seen every record.
+    // Rethrows the first exception thrown by a stage after all of them have stopped
+    Stats Run(const std::string& path, const Consumer& consumer) {
+        int fd = OpenInput(path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat record file: " + path);
+        }
+        uint64_t file_size = static_cast<uint64_t>(st.st_size);
+
+        Stats stats;
+        std::atomic<uint64_t> decode_errors{ 0 };
+        BoundedQueue<std::unique_ptr<RawBatch>> raw(options_.queue_batches);
+        BoundedQueue<std::unique_ptr<DecodedBatch>> decoded(options_.queue_batches);
+        BoundedQueue<std::unique_ptr<DecodedBatch>> recycled(options_.queue_batches);
+
+        // First failure of any stage; closing the queues unblocks and stops the others
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        std::atomic<bool> failed{ false };
+        auto fail = [&] {
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+            failed.store(true);
+            raw.Close();
+            decoded.Close();
+        };
+
+        // Decode stage
+        auto decode = [&] {
+            std::unique_ptr<RawBatch> in;
+            while (!failed.load() && raw.Pop(in)) {
+                std::unique_ptr<DecodedBatch> out;
+                if (!recycled.TryPop(out)) out.reset(new DecodedBatch());
+                out->sequence = in->sequence;
+                out->block = std::move(in->block);
+                out->records.swap(in->records);
+                out->ok.assign(out->records.size(), 0);
+                if (out->accounts.size() < out->records.size()) out->accounts.resize(out->records.size());
+                for (size_t r = 0; r < out->records.size(); ++r) {
+                    out->ok[r] = TradeProto::DecodeAccountRecord(out->records[r], out->accounts[r]);
+                    if (!out->ok[r]) decode_errors.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (!decoded.Push(std::move(out))) break;
+            }
+        };
+        std::vector<std::thread> decoders;
+        for (size_t i = 0; i < options_.decode_threads; ++i) {
+            decoders.emplace_back([&] {
+                try {
+                    decode();
+                } catch (...) {
+                    fail();
+                }
+            });
+        }
+
+        // Consume stage, restores file order with a small reorder window
+        auto consume = [&] {
+            std::map<uint64_t, std::unique_ptr<DecodedBatch>> pending;
+            uint64_t next = 0;
+            std::unique_ptr<DecodedBatch> batch;
+            while (!failed.load() && decoded.Pop(batch)) {
+                pending.emplace(batch->sequence, std::move(batch));
+                for (auto it = pending.find(next); it != pending.end(); it = pending.find(++next)) {
+                    DecodedBatch& ready = *it->second;
+                    for (size_t r = 0; r < ready.records.size(); ++r) {
+                        if (!ready.ok[r]) continue;
+                        consumer(ready.accounts[r], ready.records[r]);
+                        ++stats.records;
+                        stats.bytes += ready.records[r].size;
+                    }
+                    ready.block.reset();  // hand the read buffer back to the pool
+                    recycled.TryPush(std::move(it->second));  // dropped if the free list is full
+                    pending.erase(it);
+                }
+            }
+        };
+        std::thread consumer_thread([&] {
+            try {
+                consume();
+            } catch (...) {
+                fail();
+            }
+        });
+
+        // Read stage runs on this thread
+        try {
+            uint64_t tail = 0;
+            stats.used_io_uring = ReadBlocks(fd, file_size, raw, tail);
+            if (tail > 0) {
+                stats.truncated_bytes = tail;  // a partial last record, e.g. a writer that died mid-append
+                decode_errors.fetch_add(1, std::memory_order_relaxed);
+            }
+        } catch (const Stopped&) {
+            // a later stage failed, its exception is rethrown below
+        } catch (...) {
+            fail();
+        }
+        raw.Close();
+        for (auto& d : decoders) d.join();
+        decoded.Close();
+        consumer_thread.join();
+        ::close(fd);
+        if (error) std::rethrow_exception(error);
+
+        stats.decode_errors = decode_errors.load();
+        return stats;
+    }
+
+private:
+    static constexpr size_t kAlign = 4096;          // O_DIRECT buffer/offset alignment
+    static constexpr size_t kHeadroom = 64 * 1024;  // room in front of a block for the previous block's partial record
+
+    // Thrown through the read stage when the raw queue was closed by a failing later stage
+    struct Stopped {};
+
+    // One read buffer; data() points past the headroom so a partial record can be prepended in place
+    struct Block {
+        uint8_t* memory = nullptr;
+        size_t capacity = 0;     // bytes available after the headroom
+        size_t length = 0;       // bytes actually read
+        uint64_t file_offset = 0;
+        uint64_t index = 0;
+
+        uint8_t* data() const { return memory + kHeadroom; }
+        ~Block() { std::free(memory); }
+    };
+
+    struct RawBatch {
+        uint64_t sequence = 0;
+        std::shared_ptr<Block> block;       // owns the bytes records point into
+        std::vector<RecordRef> records;
+    };
+
+    struct DecodedBatch {
+        uint64_t sequence = 0;
+        std::shared_ptr<Block> block;
+        std::vector<RecordRef> records;
+        std::vector<TradeProto::Account> accounts;   // reused across batches
+        std::vector<uint8_t> ok;
+    };
+
+    Options options_;
+    std::mutex pool_mutex_;
+    std::vector<Block*> free_blocks_;
+
+    int OpenInput(const std::string& path) {
+        int flags = O_RDONLY | O_CLOEXEC;
+        int fd = -1;
+#ifdef O_DIRECT
+        if (options_.direct_io) fd = ::open(path.c_str(), flags | O_DIRECT);
+#endif
+        if (fd < 0) fd = ::open(path.c_str(), flags);  // filesystems without O_DIRECT fall back to buffered reads
+        if (fd < 0) throw std::runtime_error("Cannot open record file: " + path);
+        if (!options_.direct_io) ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return fd;
+    }
+
+    std::shared_ptr<Block> AcquireBlock(size_t capacity) {
+        Block* block = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            if (capacity == options_.block_bytes && !free_blocks_.empty()) {
+                block = free_blocks_.back();
+                free_blocks_.pop_back();
+            }
+        }
+        if (!block) {
+            block = new Block();
+            size_t bytes = (kHeadroom + capacity + kAlign - 1) / kAlign * kAlign;  // aligned_alloc wants a multiple of the alignment
+            block->memory = static_cast<uint8_t*>(std::aligned_alloc(kAlign, bytes));
+            if (!block->memory) {
+                delete block;
+                throw std::bad_alloc();
+            }
+            block->capacity = capacity;
+        }
+        block->length = 0;
+        return std::shared_ptr<Block>(block, [this](Block* b) {
+            if (b->capacity == options_.block_bytes) {
+                std::lock_guard<std::mutex> lock(pool_mutex_);
+                free_blocks_.push_back(b);
+            } else {
+                delete b;  // one-off oversized blocks are not pooled
+            }
+        });
+    }
+
+    // Carries the tail of the last block (an incomplete record) into the next one
+    struct Splitter {
+        RecordPipeline* owner;
+        BoundedQueue<std::unique_ptr<RawBatch>>* out;
+        std::shared_ptr<Block> carry_block;
+        size_t carry_offset = 0;
+        size_t carry_length = 0;
+        uint64_t sequence = 0;
+
+        void Feed(std::shared_ptr<Block> block) {
+            uint8_t* start = block->data();
+            size_t length = block->length;
+            if (carry_length > 0) {
+                if (carry_length <= kHeadroom) {
+                    start -= carry_length;  // record headers are 8 byte aligned in the file, so this stays aligned
+                    std::memcpy(start, carry_block->data() + carry_offset, carry_length);
+                } else {
+                    // Record larger than the headroom: stitch into a dedicated buffer
+                    std::shared_ptr<Block> joined = owner->AcquireBlock(carry_length + length);
+                    std::memcpy(joined->data(), carry_block->data() + carry_offset, carry_length);
+                    std::memcpy(joined->data() + carry_length, block->data(), length);
+                    joined->file_offset = block->file_offset - carry_length;
+                    block = joined;
+                    start = joined->data();
+                }
+                length += carry_length;
+            }
+            uint64_t base_offset = block->file_offset - (block->data() - start);
+
+            std::unique_ptr<RawBatch> batch(new RawBatch());
+            batch->sequence = sequence++;
+            size_t consumed = ForEachRecord(start, length, [&](const RecordRef& r) {
+                RecordRef record = r;
+                record.offset += base_offset;  // report file offsets, not buffer offsets
+                batch->records.push_back(record);
+            });
+            carry_block = block;
+            carry_offset = static_cast<size_t>(start - block->data()) + consumed;
+            carry_length = length - consumed;
+            batch->block = std::move(block);
+            if (!out->Push(std::move(batch))) throw Stopped();
+        }
+    };
+
+    // Returns true if io_uring did the reads; tail is what is left of an incomplete last record
+    bool ReadBlocks(int fd, uint64_t file_size, BoundedQueue<std::unique_ptr<RawBatch>>& out, uint64_t& tail) {
+        Splitter splitter{ this, &out, nullptr, 0, 0, 0 };
+        uint64_t blocks = (file_size + options_.block_bytes - 1) / options_.block_bytes;
+        bool used_io_uring = false;
+#ifdef RECORD_PIPELINE_HAVE_IO_URING
+        used_io_uring = options_.use_io_uring && ReadBlocksIoUring(fd, file_size, blocks, splitter);
+#endif
+        if (!used_io_uring) ReadBlocksThreadPool(fd, file_size, blocks, splitter);
+        tail = splitter.carry_length;
+        return used_io_uring;
+    }
+
+    // pread the remainder of a block after a short read
+    static void FinishRead(int fd, Block& block, size_t want) {
+        while (block.length < want) {
+            ssize_t n = ::pread(fd, block.data() + block.length, want - block.length, block.file_offset + block.length);
+            if (n < 0) throw std::runtime_error("Record file read failed");
+            if (n == 0) break;
+            block.length += static_cast<size_t>(n);
+        }
+    }
+
+    // O_DIRECT needs aligned lengths, so direct reads ask for a full block and stop short at EOF
+    size_t BlockWant(uint64_t index, uint64_t file_size) const {
+        if (options_.direct_io) return options_.block_bytes;
+        uint64_t offset = index * options_.block_bytes;
+        return static_cast<size_t>(std::min<uint64_t>(options_.block_bytes, file_size - offset));
+    }
+
+    void ReadBlocksThreadPool(int fd, uint64_t file_size, uint64_t blocks, Splitter& splitter) {
+        ThreadPool readers(options_.queue_depth);
+        std::deque<std::future<std::shared_ptr<Block>>> inflight;  // already in file order
+        uint64_t issued = 0;
+        while (issued < blocks || !inflight.empty()) {
+            while (issued < blocks && inflight.size() < options_.queue_depth) {
+                std::shared_ptr<Block> block = AcquireBlock(options_.block_bytes);
+                block->index = issued;
+                block->file_offset = issued * options_.block_bytes;
+                size_t want = BlockWant(issued, file_size);
+                inflight.push_back(readers.Submit([fd, block, want] {
+                    FinishRead(fd, *block, want);
+                    return block;
+                }));
+                ++issued;
+            }
+            std::shared_ptr<Block> done = inflight.front().get();
+            inflight.pop_front();
+            splitter.Feed(std::move(done));
+        }
+    }
+
+#ifdef RECORD_PIPELINE_HAVE_IO_URING
+    bool ReadBlocksIoUring(int fd, uint64_t file_size, uint64_t blocks, Splitter& splitter) {
+        struct io_uring ring;
+        if (io_uring_queue_init(static_cast<unsigned>(options_.queue_depth), &ring, 0) < 0)
+            return false;  // kernel without io_uring or blocked by seccomp, use the thread pool
+
+        std::map<uint64_t, std::shared_ptr<Block>> inflight;   // keeps buffers alive while the kernel writes
+        std::map<uint64_t, std::shared_ptr<Block>> completed;  // reorder window
+        uint64_t issued = 0;
+        uint64_t next = 0;
+        size_t outstanding = 0;  // submitted to the kernel and not reaped; prepared SQEs a failed submit left behind never complete
+        try {
+            while (next < blocks) {
+                // Top up the submission queue and submit the whole batch with one syscall
+                unsigned queued = 0;
+                while (issued < blocks && inflight.size() + completed.size() < options_.queue_depth) {
+                    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+                    if (!sqe) break;
+                    std::shared_ptr<Block> block = AcquireBlock(options_.block_bytes);
+                    block->index = issued;
+                    block->file_offset = issued * options_.block_bytes;
+                    io_uring_prep_read(sqe, fd, block->data(), static_cast<unsigned>(BlockWant(issued, file_size)), block->file_offset);
+                    io_uring_sqe_set_data64(sqe, issued);
+                    inflight.emplace(issued++, std::move(block));
+                    ++queued;
+                }
+                if (queued > 0 || outstanding == 0) {
+                    int submitted = io_uring_submit(&ring);
+                    if (submitted < 0) throw std::runtime_error("io_uring submit failed");
+                    outstanding += static_cast<size_t>(submitted);
+                    if (outstanding == 0) throw std::runtime_error("io_uring accepted no reads");
+                }
+
+                // Reap everything that is ready, waiting for at least one completion
+                struct io_uring_cqe* cqe;
+                if (io_uring_wait_cqe(&ring, &cqe) < 0)
+                    throw std::runtime_error("io_uring wait failed");
+                do {
+                    uint64_t index = io_uring_cqe_get_data64(cqe);
+                    int res = cqe->res;
+                    io_uring_cqe_seen(&ring, cqe);
+                    --outstanding;
+                    if (res < 0) throw std::runtime_error("Record file read failed: " + std::string(std::strerror(-res)));
+                    auto it = inflight.find(index);
+                    it->second->length = static_cast<size_t>(res);
+                    FinishRead(fd, *it->second, BlockWant(index, file_size));  // rare short read
+                    completed.emplace(index, std::move(it->second));
+                    inflight.erase(it);
+                } while (io_uring_peek_cqe(&ring, &cqe) == 0);
+
+                for (auto it = completed.find(next); it != completed.end(); it = completed.find(++next)) {
+                    splitter.Feed(std::move(it->second));
+                    completed.erase(it);
+                }
+            }
+        } catch (...) {
+            // Drain the reads the kernel has before their buffers go away. Blocks whose SQEs were
+            // never submitted are not in its hands and can simply be dropped
+            while (outstanding > 0) {
+                struct io_uring_cqe* cqe;
+                if (io_uring_wait_cqe(&ring, &cqe) < 0) {
+                    // Cannot tell when the kernel is done with them: leak the buffers rather than free them under a read
+                    new std::map<uint64_t, std::shared_ptr<Block>>(std::move(inflight));
+                    break;
+                }
+                inflight.erase(io_uring_cqe_get_data64(cqe));
+                io_uring_cqe_seen(&ring, cqe);
+                --outstanding;
+            }
+            io_uring_queue_exit(&ring);
+            throw;
+        }
+        io_uring_queue_exit(&ring);
+        return true;
+    }
+#endif
+};
+
+#endif // RECORD_PIPELINE_H
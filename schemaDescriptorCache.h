@@ -0,0 +1,233 @@
+#ifndef SCHEMA_DESCRIPTOR_CACHE_H
+#define SCHEMA_DESCRIPTOR_CACHE_H
+
+/* On-disk cache of FlatBuffersToProtobuf results, so service start-up only converts schemas it has
+never seen before.
+
+Entries are keyed by a 64 bit hash of the schema's FlatBuffer bytes (the .bfbs contents, or the
+SchemaT packed back into a buffer) mixed with FlatBuffersToProtobuf::kVersion. Each entry is one
+file, <dir>/<key>.fdp:
+
+    uint32 magic     'FDC2'
+    uint32 version   converter version the entry was made with
+    uint64 key
+    uint64 schema    bytes of the schema buffer that follows
+    uint64 size      bytes of the serialized FileDescriptorProto after it
+    schema buffer
+    payload
+
+The key is only a hash, so a load compares the stored schema bytes with the requested ones and
+treats a mismatch as a miss (the entry is then replaced by the colliding schema's).
+
+Loads mmap the entry and parse the descriptor straight out of the mapping. Stores write a private
+temp file, fsync it and rename() it into place, so concurrent processes sharing the directory only
+ever see complete entries (the loser of a race just replaces an identical file). Storing is best
+effort: a read-only or full cache directory only shows up in Stats::store_failures, the converted
+descriptor is still returned. */
+
+#include "FlatbuffersToProtobuf"
+#include "flatbuffers/flatbuffers.h"
+#include "reflection_generated.h"
+#include "threadPool.h"
+
+#include <google/protobuf/descriptor.pb.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class SchemaDescriptorCache {
+public:
+    struct Stats {
+        std::atomic<uint64_t> hits{ 0 };
+        std::atomic<uint64_t> misses{ 0 };
+        std::atomic<uint64_t> store_failures{ 0 };  // entries that could not be written
+    };
+
+    // Creates the directory if it does not exist yet
+    explicit SchemaDescriptorCache(std::string directory) : directory_(std::move(directory)) {
+        if (::mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST)
+            throw std::runtime_error("Cannot create schema cache directory: " + directory_);
+    }
+
+    // Cached descriptor for a .bfbs buffer; on a hit the schema is never unpacked or converted.
+    // The buffer is verified first, a malformed one throws instead of being converted or cached
+    google::protobuf::FileDescriptorProto GetOrConvert(const uint8_t* bfbs, size_t size) {
+        flatbuffers::Verifier verifier(bfbs, size);
+        if (!reflection::VerifySchemaBuffer(verifier))
+            throw std::runtime_error("Invalid schema buffer");
+        uint64_t key = Key(bfbs, size);
+        google::protobuf::FileDescriptorProto file_desc;
+        if (Load(key, bfbs, size, file_desc)) {
+            stats_.hits.fetch_add(1, std::memory_order_relaxed);
+            return file_desc;
+        }
+        stats_.misses.fetch_add(1, std::memory_order_relaxed);
+        std::unique_ptr<reflection::SchemaT> schema(reflection::GetSchema(bfbs)->UnPack());
+        file_desc = FlatBuffersToProtobuf(schema.get()).Convert();
+        Store(key, bfbs, size, file_desc);  // best effort, a failed store only costs a conversion next time
+        return file_desc;
+    }
+
+    // Same for a schema that is already unpacked (it is packed once to compute the key)
+    google::protobuf::FileDescriptorProto GetOrConvert(const reflection::SchemaT& schema) {
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(reflection::Schema::Pack(builder, &schema));
+        const uint8_t* bytes = builder.GetBufferPointer();
+        size_t size = builder.GetSize();
+        uint64_t key = Key(bytes, size);
+        google::protobuf::FileDescriptorProto file_desc;
+        if (Load(key, bytes, size, file_desc)) {
+            stats_.hits.fetch_add(1, std::memory_order_relaxed);
+            return file_desc;
+        }
+        stats_.misses.fetch_add(1, std::memory_order_relaxed);
+        file_desc = FlatBuffersToProtobuf(&schema).Convert();
+        Store(key, bytes, size, file_desc);
+        return file_desc;
+    }
+
+    // Cached GetOrConvert over many schemas on a pool, results in input order
+    std::vector<google::protobuf::FileDescriptorProto> GetOrConvertAll(const std::vector<const reflection::SchemaT*>& schemas, ThreadPool& pool) {
+        std::vector<google::protobuf::FileDescriptorProto> results(schemas.size());
+        pool.ParallelFor(schemas.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                results[i] = GetOrConvert(*schemas[i]);
+        });
+        return results;
+    }
+
+    // Hash of the schema bytes and the converter version
+    static uint64_t Key(const uint8_t* data, size_t size) {
+        const uint64_t k = 0x9E3779B97F4A7C15ull;
+        uint64_t h = 0xCBF29CE484222325ull ^ (static_cast<uint64_t>(FlatBuffersToProtobuf::kVersion) * k) ^ size;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {  // a word at a time, schemas can be hundreds of KB
+            uint64_t w;
+            std::memcpy(&w, data + i, 8);
+            h = Mix(h ^ w);
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, size - i);
+        return Mix(h ^ tail ^ (static_cast<uint64_t>(size - i) << 56));
+    }
+
+    // Fills file_desc from the cache, false on a miss, a damaged entry or an entry made for other
+    // schema bytes with the same key
+    bool Load(uint64_t key, const uint8_t* schema, size_t schema_size, google::protobuf::FileDescriptorProto& file_desc) const {
+        std::string path = EntryPath(key);
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(EntryHeader)) {
+            ::close(fd);
+            return false;
+        }
+        size_t length = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(p);
+        EntryHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        bool ok = header.magic == kMagic && header.version == FlatBuffersToProtobuf::kVersion && header.key == key &&
+                  header.schema_size == schema_size && length - sizeof(EntryHeader) >= schema_size &&
+                  header.size == length - sizeof(EntryHeader) - schema_size &&
+                  std::memcmp(bytes + sizeof(EntryHeader), schema, schema_size) == 0 &&
+                  file_desc.ParseFromArray(bytes + sizeof(EntryHeader) + schema_size, static_cast<int>(header.size));
+        ::munmap(p, length);
+        return ok;
+    }
+
+    // Writes the entry atomically (temp file + fsync + rename). Returns false, leaving no temp file
+    // behind, if the entry could not be written
+    bool Store(uint64_t key, const uint8_t* schema, size_t schema_size, const google::protobuf::FileDescriptorProto& file_desc) {
+        std::string payload;
+        if (!file_desc.SerializeToString(&payload)) return StoreFailed();
+
+        EntryHeader header{ kMagic, FlatBuffersToProtobuf::kVersion, key, schema_size, payload.size() };
+        std::string final_path = EntryPath(key);
+        std::string temp_path = final_path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(RandomSuffix());
+
+        int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0) return StoreFailed();
+        bool ok = WriteAll(fd, &header, sizeof(header)) && WriteAll(fd, schema, schema_size) &&
+                  WriteAll(fd, payload.data(), payload.size()) && ::fsync(fd) == 0;
+        ok = (::close(fd) == 0) && ok;
+        if (!ok || std::rename(temp_path.c_str(), final_path.c_str()) != 0) {
+            ::unlink(temp_path.c_str());
+            return StoreFailed();
+        }
+        return true;
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    static constexpr uint32_t kMagic = 0x32434446;  // "FDC2" little endian, entries now carry the schema bytes
+
+    struct EntryHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint64_t schema_size;
+        uint64_t size;
+    };
+    static_assert(sizeof(EntryHeader) == 32, "cache entry header layout is part of the file format");
+
+    std::string directory_;
+    Stats stats_;
+
+    bool StoreFailed() {
+        stats_.store_failures.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    static uint64_t Mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static uint64_t RandomSuffix() {
+        thread_local std::mt19937_64 rng(std::random_device{}());
+        return rng();
+    }
+
+    static bool WriteAll(int fd, const void* data, size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t n = ::write(fd, p, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    std::string EntryPath(uint64_t key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.fdp", static_cast<unsigned long long>(key));
+        return directory_ + "/" + name;
+    }
+};
+
+#endif // SCHEMA_DESCRIPTOR_CACHE_H
@@ -0,0 +1,599 @@
+#ifndef SCHEMA_MIGRATION_H
+#define SCHEMA_MIGRATION_H
+
+/* Schema evolution applied while decoding, instead of decoding into the new structs and fixing
+them up afterwards.
+
+DiffMessages() compares a message of the writer's .proto (ProtoFile, fields matched by number)
+and DiffObjects() a table of the writer's bfbs (reflection::SchemaT, fields matched by id) with
+the reader's version, and produces a MigrationPlan listing, per field:
+    Keep     same number / id, name and type
+    Rename   same number / id, new name
+    Widen    same number / id, type widened without loss (int32 -> int64, float -> double,
+             uint32 -> int64, int32 -> double, enum <-> int32, string <-> bytes, ...)
+    Drop     only the writer has it, the decoder skips it
+    Default  only the reader has it, it keeps the prototype's value (or a non-zero bfbs default)
+Incompatible changes (narrowing, scalar <-> string, repeated <-> singular) throw
+std::runtime_error when the plan is made, not at decode time.
+
+WireDecoder<T> (protobuf wire format) and TableDecoder<T> (FlatBuffers tables) compile a plan
+plus a binding table (reader field name -> setter of T) into a per-number lookup, so decoding
+old data into new structs is one pass: T starts as a copy of the prototype, each
+writer field is read with the writer's encoding and handed to its reader setter. OrderBindings()
+binds TradeProto::Order to the Order message of protobufSchema.proto / fbsSchema.fbs.
+
+Usage:
+    auto plan = SchemaMigration::DiffMessages(old_file, new_file, "Order");
+    SchemaMigration::WireDecoder<TradeProto::Order> decoder(plan, SchemaMigration::OrderBindings());
+    decoder.Decode(data, size, order);
+*/
+
+#include "../proto/trade.h"
+#include "flatbuffers/flatbuffers.h"
+#include "protoParser.h"
+#include "reflection_generated.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace SchemaMigration {
+
+// Logical field types shared by both schema languages
+enum class Scalar : uint8_t {
+    Bool, Int8, Int16, Int32, Int64, UInt8, UInt16, UInt32, UInt64, Float, Double, String, Bytes, Enum, Message
+};
+
+// How the writer put a value on the protobuf wire
+enum class Encoding : uint8_t { Varint, ZigZag, Fixed32, Fixed64, Length, None };
+
+struct FieldType {
+    Scalar scalar = Scalar::Int32;
+    Encoding encoding = Encoding::None;
+    bool repeated = false;
+};
+
+// A decoded value in every representation the writer type allows; setters take the one matching T
+struct Value {
+    int64_t i = 0;
+    uint64_t u = 0;
+    double d = 0.0;
+    std::string_view s;
+};
+
+struct FieldChange {
+    enum Kind : uint8_t { Keep, Rename, Widen, Drop, Default };
+
+    Kind kind = Keep;
+    int number = 0;              // protobuf number or FlatBuffers id, of the writer (reader for Default)
+    std::string writer_name;
+    std::string reader_name;
+    FieldType from;
+    FieldType to;
+    bool renamed = false;        // a Widen can also be renamed
+    Value default_value;         // Default: the reader's default (FlatBuffers schemas carry one)
+};
+
+struct MigrationPlan {
+    std::string message;
+    std::vector<FieldChange> changes;   // writer fields by number, then the reader-only fields
+
+    bool Identity() const {
+        return std::all_of(changes.begin(), changes.end(), [](const FieldChange& c) { return c.kind == FieldChange::Keep; });
+    }
+
+    std::string Describe() const {
+        static const char* const kinds[] = { "keep", "rename", "widen", "drop", "default" };
+        std::string text;
+        for (const FieldChange& c : changes) {
+            text += std::string(kinds[c.kind]) + " " + std::to_string(c.number) + " ";
+            text += c.kind == FieldChange::Default ? c.reader_name : c.writer_name;
+            if (c.renamed) text += " -> " + c.reader_name;
+            text += "\n";
+        }
+        return text;
+    }
+};
+
+namespace detail {
+
+    inline int Bits(Scalar s) {
+        switch (s) {
+        case Scalar::Bool: return 1;
+        case Scalar::Int8: case Scalar::UInt8: return 8;
+        case Scalar::Int16: case Scalar::UInt16: return 16;
+        case Scalar::Int32: case Scalar::UInt32: case Scalar::Enum: case Scalar::Float: return 32;
+        default: return 64;
+        }
+    }
+
+    inline bool IsSigned(Scalar s) { return s == Scalar::Int8 || s == Scalar::Int16 || s == Scalar::Int32 || s == Scalar::Int64 || s == Scalar::Enum; }
+    inline bool IsUnsigned(Scalar s) { return s == Scalar::UInt8 || s == Scalar::UInt16 || s == Scalar::UInt32 || s == Scalar::UInt64; }
+
+    // True when every value of from is exactly representable in to
+    inline bool Widens(Scalar from, Scalar to) {
+        if (from == to) return true;
+        if ((from == Scalar::String && to == Scalar::Bytes) || (from == Scalar::Bytes && to == Scalar::String)) return true;
+        if ((from == Scalar::Enum && to == Scalar::Int32) || (from == Scalar::Int32 && to == Scalar::Enum)) return true;
+        bool from_int = from == Scalar::Bool || IsSigned(from) || IsUnsigned(from);
+        if (from_int && (IsSigned(to) || IsUnsigned(to))) {
+            if (from == Scalar::Bool) return true;
+            if (IsSigned(from) && IsUnsigned(to)) return false;
+            if (to == Scalar::Enum) return false;
+            return Bits(to) > Bits(from) || (Bits(to) == Bits(from) && IsSigned(from) == IsSigned(to));
+        }
+        if (from_int && to == Scalar::Double) return Bits(from) <= 32;
+        if (from_int && to == Scalar::Float) return Bits(from) <= 16;
+        return from == Scalar::Float && to == Scalar::Double;
+    }
+
+    inline void Classify(FieldChange& change) {
+        if (change.from.repeated != change.to.repeated || !Widens(change.from.scalar, change.to.scalar))
+            throw std::runtime_error("Cannot migrate field " + change.writer_name + " (" + std::to_string(change.number) + ") to " + change.reader_name);
+        change.renamed = change.writer_name != change.reader_name;
+        if (change.from.scalar != change.to.scalar) change.kind = FieldChange::Widen;
+        else change.kind = change.renamed ? FieldChange::Rename : FieldChange::Keep;
+    }
+
+    inline FieldType ProtoType(const ProtoFile& file, const Field& field) {
+        struct Known { const char* name; Scalar scalar; Encoding encoding; };
+        static const Known known[] = {
+            { "double", Scalar::Double, Encoding::Fixed64 }, { "float", Scalar::Float, Encoding::Fixed32 },
+            { "int32", Scalar::Int32, Encoding::Varint }, { "int64", Scalar::Int64, Encoding::Varint },
+            { "uint32", Scalar::UInt32, Encoding::Varint }, { "uint64", Scalar::UInt64, Encoding::Varint },
+            { "sint32", Scalar::Int32, Encoding::ZigZag }, { "sint64", Scalar::Int64, Encoding::ZigZag },
+            { "fixed32", Scalar::UInt32, Encoding::Fixed32 }, { "fixed64", Scalar::UInt64, Encoding::Fixed64 },
+            { "sfixed32", Scalar::Int32, Encoding::Fixed32 }, { "sfixed64", Scalar::Int64, Encoding::Fixed64 },
+            { "bool", Scalar::Bool, Encoding::Varint }, { "string", Scalar::String, Encoding::Length },
+            { "bytes", Scalar::Bytes, Encoding::Length },
+        };
+        FieldType type;
+        type.repeated = field.repeated;
+        for (const Known& k : known)
+            if (field.type == k.name) {
+                type.scalar = k.scalar;
+                type.encoding = k.encoding;
+                return type;
+            }
+        for (const Enum& e : file.enums)
+            if (e.name == field.type) {
+                type.scalar = Scalar::Enum;
+                type.encoding = Encoding::Varint;
+                return type;
+            }
+        for (const Message& m : file.messages)
+            if (m.name == field.type) {
+                type.scalar = Scalar::Message;
+                type.encoding = Encoding::Length;
+                return type;
+            }
+        throw std::runtime_error("Unknown field type " + field.type + " of " + field.name);
+    }
+
+    inline const Message& FindMessage(const ProtoFile& file, const std::string& name) {
+        for (const Message& m : file.messages)
+            if (m.name == name) return m;
+        throw std::runtime_error("Message " + name + " is not in the schema");
+    }
+
+    inline Scalar FlatScalar(reflection::BaseType type) {
+        switch (type) {
+        case reflection::BaseType_Bool: return Scalar::Bool;
+        case reflection::BaseType_Byte: return Scalar::Int8;
+        case reflection::BaseType_UType:
+        case reflection::BaseType_UByte: return Scalar::UInt8;
+        case reflection::BaseType_Short: return Scalar::Int16;
+        case reflection::BaseType_UShort: return Scalar::UInt16;
+        case reflection::BaseType_Int: return Scalar::Int32;
+        case reflection::BaseType_UInt: return Scalar::UInt32;
+        case reflection::BaseType_Long: return Scalar::Int64;
+        case reflection::BaseType_ULong: return Scalar::UInt64;
+        case reflection::BaseType_Float: return Scalar::Float;
+        case reflection::BaseType_Double: return Scalar::Double;
+        case reflection::BaseType_String: return Scalar::String;
+        case reflection::BaseType_Obj: return Scalar::Message;
+        default: throw std::runtime_error("Unsupported FlatBuffers field type");
+        }
+    }
+
+    // FlatBuffers enums are their underlying integer type here, so byte -> short enums widen
+    inline FieldType FlatType(const reflection::FieldT& field) {
+        const reflection::TypeT& type = *field.type;
+        FieldType result;
+        result.repeated = type.base_type == reflection::BaseType_Vector;
+        result.scalar = FlatScalar(result.repeated ? type.element : type.base_type);
+        return result;
+    }
+
+    inline const reflection::ObjectT& FindObject(const reflection::SchemaT& schema, const std::string& name) {
+        for (const auto& object : schema.objects) {
+            const std::string& full = object->name;      // "Trade.flatbuf.Order"
+            if (full == name || (full.size() > name.size() && full.compare(full.size() - name.size(), name.size(), name) == 0 &&
+                                 full[full.size() - name.size() - 1] == '.'))
+                return *object;
+        }
+        throw std::runtime_error("Table " + name + " is not in the schema");
+    }
+
+} // namespace detail
+
+// Plan for decoding `message` written with `writer` into structs generated from `reader`
+inline MigrationPlan DiffMessages(const ProtoFile& writer, const ProtoFile& reader, const std::string& message) {
+    const Message& old_message = detail::FindMessage(writer, message);
+    const Message& new_message = detail::FindMessage(reader, message);
+    MigrationPlan plan;
+    plan.message = message;
+
+    std::vector<const Field*> old_fields;
+    for (const Field& f : old_message.fields) old_fields.push_back(&f);
+    std::sort(old_fields.begin(), old_fields.end(), [](const Field* a, const Field* b) { return a->number < b->number; });
+    for (const Field* old_field : old_fields) {
+        FieldChange change;
+        change.number = old_field->number;
+        change.writer_name = old_field->name;
+        change.from = detail::ProtoType(writer, *old_field);
+        auto it = std::find_if(new_message.fields.begin(), new_message.fields.end(),
+                               [&](const Field& f) { return f.number == old_field->number; });
+        if (it == new_message.fields.end()) {
+            change.kind = FieldChange::Drop;
+        } else {
+            change.reader_name = it->name;
+            change.to = detail::ProtoType(reader, *it);
+            detail::Classify(change);
+        }
+        plan.changes.push_back(std::move(change));
+    }
+    for (const Field& new_field : new_message.fields) {
+        if (std::any_of(old_fields.begin(), old_fields.end(), [&](const Field* f) { return f->number == new_field.number; })) continue;
+        FieldChange change;
+        change.kind = FieldChange::Default;                  // proto3: zero / empty
+        change.number = new_field.number;
+        change.reader_name = new_field.name;
+        change.to = detail::ProtoType(reader, new_field);
+        plan.changes.push_back(std::move(change));
+    }
+    return plan;
+}
+
+// Plan for reading table `object` written with `writer` into structs generated from `reader`.
+// Deprecated fields count as absent.
+inline MigrationPlan DiffObjects(const reflection::SchemaT& writer, const reflection::SchemaT& reader, const std::string& object) {
+    const reflection::ObjectT& old_object = detail::FindObject(writer, object);
+    const reflection::ObjectT& new_object = detail::FindObject(reader, object);
+    MigrationPlan plan;
+    plan.message = object;
+
+    auto live = [](const reflection::ObjectT& o, uint16_t id) -> const reflection::FieldT* {
+        for (const auto& f : o.fields)
+            if (f->id == id && !f->deprecated) return f.get();
+        return nullptr;
+    };
+    std::vector<const reflection::FieldT*> old_fields;
+    for (const auto& f : old_object.fields)
+        if (!f->deprecated) old_fields.push_back(f.get());
+    std::sort(old_fields.begin(), old_fields.end(), [](const reflection::FieldT* a, const reflection::FieldT* b) { return a->id < b->id; });
+
+    for (const reflection::FieldT* old_field : old_fields) {
+        FieldChange change;
+        change.number = old_field->id;
+        change.writer_name = old_field->name;
+        change.from = detail::FlatType(*old_field);
+        change.default_value.i = old_field->default_integer;  // read from the writer's table when absent
+        change.default_value.u = static_cast<uint64_t>(old_field->default_integer);
+        change.default_value.d = old_field->default_real;
+        if (const reflection::FieldT* new_field = live(new_object, old_field->id)) {
+            change.reader_name = new_field->name;
+            change.to = detail::FlatType(*new_field);
+            detail::Classify(change);
+        } else {
+            change.kind = FieldChange::Drop;
+        }
+        plan.changes.push_back(std::move(change));
+    }
+    for (const auto& new_field : new_object.fields) {
+        if (new_field->deprecated || live(old_object, new_field->id)) continue;
+        FieldChange change;
+        change.kind = FieldChange::Default;
+        change.number = new_field->id;
+        change.reader_name = new_field->name;
+        change.to = detail::FlatType(*new_field);
+        change.default_value.i = new_field->default_integer;
+        change.default_value.u = static_cast<uint64_t>(new_field->default_integer);
+        change.default_value.d = new_field->default_real != 0.0 ? new_field->default_real : static_cast<double>(new_field->default_integer);
+        plan.changes.push_back(std::move(change));
+    }
+    return plan;
+}
+
+// Reader field name -> how to store a value into T. Repeated fields get one call per element.
+template <typename T>
+struct Binding {
+    const char* name;
+    void (*set)(T& target, const Value& value);
+};
+
+// TradeProto::Order against the current Order message / table
+inline const std::vector<Binding<TradeProto::Order>>& OrderBindings() {
+    using TradeProto::Order;
+    static const std::vector<Binding<Order>> bindings = {
+        { "id", [](Order& o, const Value& v) { o.Id = static_cast<int>(v.i); } },
+        { "symbol", [](Order& o, const Value& v) {
+            size_t size = std::min(v.s.size(), sizeof(o.Symbol) - 1);
+            if (size) std::memcpy(o.Symbol, v.s.data(), size);
+            o.Symbol[size] = '\0';
+        } },
+        { "side", [](Order& o, const Value& v) { o.Side = static_cast<TradeProto::OrderSide>(v.i); } },
+        { "type", [](Order& o, const Value& v) { o.Type = static_cast<TradeProto::OrderType>(v.i); } },
+        { "price", [](Order& o, const Value& v) { o.Price = v.d; } },
+        { "volume", [](Order& o, const Value& v) { o.Volume = v.d; } },
+    };
+    return bindings;
+}
+
+namespace detail {
+
+    // Every representation of an integer the writer stored as `from`
+    inline Value FromInteger(uint64_t raw, Scalar from) {
+        Value v;
+        switch (Bits(from)) {             // narrow to the writer width first, like the generated code does
+        case 1: raw = raw != 0; break;
+        case 8: raw = IsSigned(from) ? static_cast<uint64_t>(static_cast<int8_t>(raw)) : static_cast<uint8_t>(raw); break;
+        case 16: raw = IsSigned(from) ? static_cast<uint64_t>(static_cast<int16_t>(raw)) : static_cast<uint16_t>(raw); break;
+        case 32: raw = IsSigned(from) ? static_cast<uint64_t>(static_cast<int32_t>(raw)) : static_cast<uint32_t>(raw); break;
+        default: break;
+        }
+        v.u = raw;
+        v.i = static_cast<int64_t>(raw);
+        v.d = IsUnsigned(from) ? static_cast<double>(raw) : static_cast<double>(v.i);
+        return v;
+    }
+
+    inline Value FromDouble(double d) {
+        Value v;                          // never read as an integer: plans do not narrow
+        v.d = d;
+        return v;
+    }
+
+    // Binding index per reader field name, with unbound fields at -1
+    template <typename T>
+    int BindingIndex(const std::vector<Binding<T>>& bindings, const std::string& name) {
+        for (size_t i = 0; i < bindings.size(); ++i)
+            if (name == bindings[i].name) return static_cast<int>(i);
+        return -1;
+    }
+
+    inline bool IsZero(const Value& v) { return v.i == 0 && v.u == 0 && v.d == 0.0 && v.s.empty(); }
+
+    // The prototype decoding starts from: the caller's T with the singular fields the plan defaults
+    // set to the reader schema's default. A zero default (all of proto3's) leaves the caller's
+    // value, and no other binding is called, so repeated bindings never see a stray element
+    template <typename T>
+    T MakePrototype(const MigrationPlan& plan, const std::vector<Binding<T>>& bindings, T prototype) {
+        for (const FieldChange& c : plan.changes) {
+            if (c.kind != FieldChange::Default || c.to.repeated || IsZero(c.default_value)) continue;
+            int index = BindingIndex(bindings, c.reader_name);
+            if (index >= 0) bindings[index].set(prototype, c.default_value);
+        }
+        return prototype;
+    }
+
+} // namespace detail
+
+// Protobuf wire decoder for data written with the plan's writer schema
+template <typename T>
+class WireDecoder {
+public:
+    WireDecoder(const MigrationPlan& plan, const std::vector<Binding<T>>& bindings, T prototype = T())
+        : bindings_(bindings), prototype_(detail::MakePrototype(plan, bindings, std::move(prototype))) {
+        for (const FieldChange& c : plan.changes) {
+            if (c.kind == FieldChange::Drop || c.kind == FieldChange::Default) continue;
+            int index = detail::BindingIndex(bindings_, c.reader_name);
+            if (index < 0) continue;                         // the struct has no member for it: skipped
+            if (c.number <= 0 || c.number > kMaxDenseNumber) throw std::runtime_error("Field number too large for WireDecoder");
+            if (static_cast<size_t>(c.number) >= entries_.size()) entries_.resize(c.number + 1);
+            entries_[c.number] = { c.from.scalar, c.from.encoding, static_cast<int16_t>(index) };
+        }
+    }
+
+    // Throws std::runtime_error on malformed input
+    void Decode(const uint8_t* data, size_t size, T& out) const {
+        out = prototype_;
+        const uint8_t* p = data;
+        const uint8_t* end = data + size;
+        while (p < end) {
+            uint64_t tag = Varint(p, end);
+            uint64_t number = tag >> 3;
+            unsigned wire = tag & 7;
+            const Entry* entry = number < entries_.size() && entries_[number].binding >= 0 ? &entries_[number] : nullptr;
+            if (!entry) {
+                Skip(wire, p, end);                          // dropped, unbound or unknown
+                continue;
+            }
+            if (wire == 2 && entry->encoding != Encoding::Length) {   // packed repeated scalars
+                uint64_t length = Varint(p, end);
+                if (length > static_cast<uint64_t>(end - p)) throw std::runtime_error("Truncated packed field");
+                const uint8_t* packed_end = p + length;
+                while (p < packed_end) Store(*entry, ReadScalar(*entry, p, packed_end), out);
+                continue;
+            }
+            if (wire != WireType(entry->encoding)) throw std::runtime_error("Wire type does not match the writer schema");
+            if (entry->encoding == Encoding::Length) {
+                uint64_t length = Varint(p, end);
+                if (length > static_cast<uint64_t>(end - p)) throw std::runtime_error("Truncated field");
+                Value v;
+                v.s = std::string_view(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+                p += length;
+                Store(*entry, v, out);
+            } else {
+                Store(*entry, ReadScalar(*entry, p, end), out);
+            }
+        }
+    }
+
+    void Decode(const std::string& data, T& out) const { Decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), out); }
+
+private:
+    static constexpr int kMaxDenseNumber = 4096;
+
+    struct Entry {
+        Scalar scalar = Scalar::Int32;
+        Encoding encoding = Encoding::None;
+        int16_t binding = -1;
+    };
+
+    std::vector<Binding<T>> bindings_;
+    T prototype_;
+    std::vector<Entry> entries_;         // by writer field number
+
+    void Store(const Entry& entry, const Value& value, T& out) const { bindings_[entry.binding].set(out, value); }
+
+    static unsigned WireType(Encoding encoding) {
+        switch (encoding) {
+        case Encoding::Fixed64: return 1;
+        case Encoding::Length: return 2;
+        case Encoding::Fixed32: return 5;
+        default: return 0;
+        }
+    }
+
+    static uint64_t Varint(const uint8_t*& p, const uint8_t* end) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) throw std::runtime_error("Truncated varint");
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("Malformed varint");
+    }
+
+    static Value ReadScalar(const Entry& entry, const uint8_t*& p, const uint8_t* end) {
+        switch (entry.encoding) {
+        case Encoding::Varint:
+            return detail::FromInteger(Varint(p, end), entry.scalar);
+        case Encoding::ZigZag: {
+            uint64_t raw = Varint(p, end);
+            return detail::FromInteger((raw >> 1) ^ (~(raw & 1) + 1), entry.scalar);
+        }
+        case Encoding::Fixed32: {
+            if (end - p < 4) throw std::runtime_error("Truncated fixed32");
+            uint32_t raw;
+            std::memcpy(&raw, p, 4);
+            p += 4;
+            if (entry.scalar == Scalar::Float) {
+                float f;
+                std::memcpy(&f, &raw, 4);
+                return detail::FromDouble(f);
+            }
+            return detail::FromInteger(raw, entry.scalar);
+        }
+        case Encoding::Fixed64: {
+            if (end - p < 8) throw std::runtime_error("Truncated fixed64");
+            uint64_t raw;
+            std::memcpy(&raw, p, 8);
+            p += 8;
+            if (entry.scalar == Scalar::Double) {
+                double d;
+                std::memcpy(&d, &raw, 8);
+                return detail::FromDouble(d);
+            }
+            return detail::FromInteger(raw, entry.scalar);
+        }
+        default:
+            throw std::runtime_error("Unexpected encoding");
+        }
+    }
+
+    static void Skip(unsigned wire, const uint8_t*& p, const uint8_t* end) {
+        switch (wire) {
+        case 0: Varint(p, end); return;
+        case 1: if (end - p < 8) throw std::runtime_error("Truncated field"); p += 8; return;
+        case 2: {
+            uint64_t length = Varint(p, end);
+            if (length > static_cast<uint64_t>(end - p)) throw std::runtime_error("Truncated field");
+            p += length;
+            return;
+        }
+        case 5: if (end - p < 4) throw std::runtime_error("Truncated field"); p += 4; return;
+        default: throw std::runtime_error("Unsupported wire type");
+        }
+    }
+};
+
+// FlatBuffers table decoder for buffers written with the plan's writer schema
+template <typename T>
+class TableDecoder {
+public:
+    TableDecoder(const MigrationPlan& plan, const std::vector<Binding<T>>& bindings, T prototype = T())
+        : bindings_(bindings), prototype_(detail::MakePrototype(plan, bindings, std::move(prototype))) {
+        for (const FieldChange& c : plan.changes) {
+            if (c.kind == FieldChange::Drop || c.kind == FieldChange::Default) continue;
+            int index = detail::BindingIndex(bindings_, c.reader_name);
+            if (index < 0) continue;
+            if (c.from.repeated || c.from.scalar == Scalar::Message)
+                throw std::runtime_error("TableDecoder binds scalar and string fields only: " + c.writer_name);
+            Step step;
+            step.vt = static_cast<flatbuffers::voffset_t>(4 + 2 * c.number);
+            step.scalar = c.from.scalar;
+            step.writer_default = c.default_value;
+            step.binding = index;
+            steps_.push_back(step);
+        }
+    }
+
+    // Absent writer fields read as the writer's default, like generated accessors do
+    void Decode(const flatbuffers::Table& table, T& out) const {
+        out = prototype_;
+        for (const Step& step : steps_) {
+            Value v;
+            switch (step.scalar) {
+            case Scalar::Bool: case Scalar::UInt8: v = Integer<uint8_t>(table, step); break;
+            case Scalar::Int8: v = Integer<int8_t>(table, step); break;
+            case Scalar::Int16: v = Integer<int16_t>(table, step); break;
+            case Scalar::UInt16: v = Integer<uint16_t>(table, step); break;
+            case Scalar::Int32: case Scalar::Enum: v = Integer<int32_t>(table, step); break;
+            case Scalar::UInt32: v = Integer<uint32_t>(table, step); break;
+            case Scalar::Int64: v = Integer<int64_t>(table, step); break;
+            case Scalar::UInt64: v = Integer<uint64_t>(table, step); break;
+            case Scalar::Float: v = detail::FromDouble(table.GetField<float>(step.vt, static_cast<float>(step.writer_default.d))); break;
+            case Scalar::Double: v = detail::FromDouble(table.GetField<double>(step.vt, step.writer_default.d)); break;
+            case Scalar::String: case Scalar::Bytes:
+                if (auto s = table.GetPointer<const flatbuffers::String*>(step.vt)) v.s = std::string_view(s->c_str(), s->size());
+                else continue;                               // absent string: the reader default stays
+                break;
+            default: continue;
+            }
+            bindings_[step.binding].set(out, v);
+        }
+    }
+
+    template <typename Generated>
+    void Decode(const Generated* table, T& out) const { Decode(*reinterpret_cast<const flatbuffers::Table*>(table), out); }
+
+private:
+    struct Step {
+        flatbuffers::voffset_t vt = 0;
+        Scalar scalar = Scalar::Int32;
+        Value writer_default;
+        int binding = -1;
+    };
+
+    std::vector<Binding<T>> bindings_;
+    T prototype_;
+    std::vector<Step> steps_;
+
+    template <typename S>
+    static Value Integer(const flatbuffers::Table& table, const Step& step) {
+        S value = table.GetField<S>(step.vt, static_cast<S>(step.writer_default.i));
+        return detail::FromInteger(static_cast<uint64_t>(value), step.scalar);
+    }
+};
+
+} // namespace SchemaMigration
+
+#endif // SCHEMA_MIGRATION_H
@@ -0,0 +1,106 @@
+#include "../proto/trade.h"
+#include "schemaMigration.h"
+#include "tradeSampleData.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Orders written with an older Order message decoded straight into today's TradeProto::Order:
+// id, symbol, side and volume are kept, price widens from float to double, a comment field the
+// reader no longer has is dropped and type, which the writer did not have yet, keeps the value of
+// the prototype. Checks every field against what was written, then times the decoder
+namespace {
+
+const char* const kWriterProto = R"(
+enum OrderSide { buy = 0; sell = 1; }
+message Order { int32 id = 1; string symbol = 2; OrderSide side = 3; float price = 5; double volume = 6; string comment = 7; })";
+
+const char* const kReaderProto = R"(
+enum OrderSide { buy = 0; sell = 1; }
+enum OrderType { market = 0; limit = 1; stop = 2; }
+message Order { int32 id = 1; string symbol = 2; OrderSide side = 3; OrderType type = 4; double price = 5; double volume = 6; })";
+
+const int kDecodes = 1000000;
+
+void Varint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void Bytes(std::string& out, int number, const std::string& value)
+{
+    Varint(out, static_cast<uint64_t>(number) << 3 | 2);
+    Varint(out, value.size());
+    out += value;
+}
+
+template <typename F>
+void Fixed(std::string& out, int number, F value)
+{
+    Varint(out, static_cast<uint64_t>(number) << 3 | (sizeof(F) == 8 ? 1 : 5));
+    out.append(reinterpret_cast<const char*>(&value), sizeof(F));
+}
+
+// One order in the writer's wire format
+std::string WriteOldOrder(int id, const std::string& symbol, int side, float price, double volume, const std::string& comment)
+{
+    std::string out;
+    Varint(out, 1 << 3);
+    Varint(out, static_cast<uint64_t>(id));
+    Bytes(out, 2, symbol);
+    Varint(out, 3 << 3);
+    Varint(out, static_cast<uint64_t>(side));
+    Fixed(out, 5, price);
+    Fixed(out, 6, volume);
+    Bytes(out, 7, comment);
+    return out;
+}
+
+void Expect(bool ok, const char* what)
+{
+    if (!ok) throw std::runtime_error(std::string("Migrated order has the wrong ") + what);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    ProtoFile writer = ProtoParser(kWriterProto).ParseFile();
+    ProtoFile reader = ProtoParser(kReaderProto).ParseFile();
+    SchemaMigration::MigrationPlan plan = SchemaMigration::DiffMessages(writer, reader, "Order");
+    std::cout << plan.Describe();
+
+    // Orders without a type on the wire are limit orders; the prototype says so and the plan keeps it
+    TradeProto::Order prototype;
+    prototype.Type = TradeProto::OrderType::LIMIT;
+    SchemaMigration::WireDecoder<TradeProto::Order> decoder(plan, SchemaMigration::OrderBindings(), prototype);
+
+    std::string data = WriteOldOrder(7, "EURUSD", 1, 1.0875f, 250000, "entered by hand");
+    TradeProto::Order order;
+    decoder.Decode(data, order);
+    Expect(order.Id == 7, "id");
+    Expect(std::strcmp(order.Symbol, "EURUSD") == 0, "symbol");
+    Expect(order.Side == TradeProto::OrderSide::SELL, "side");
+    Expect(order.Type == TradeProto::OrderType::LIMIT, "type");
+    Expect(order.Price == static_cast<double>(1.0875f), "price");
+    Expect(order.Volume == 250000, "volume");
+    std::cout << "decoded order " << order.Id << " " << order.Symbol << " @ " << order.Price << " x " << order.Volume << std::endl;
+
+    double sum = 0;
+    double ms = TradeProto::SampleData::Milliseconds([&]() {
+        for (int i = 0; i < kDecodes; ++i)
+        {
+            decoder.Decode(data, order);
+            sum += order.Volume;
+        }
+    });
+    std::cout << kDecodes << " migrating decodes: " << ms << " ms (checksum " << sum << ")" << std::endl;
+    return 0;
+}
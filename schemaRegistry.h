@@ -0,0 +1,294 @@
+#ifndef SCHEMA_REGISTRY_H
+#define SCHEMA_REGISTRY_H
+
+/* In-process schema registry with read-copy-update semantics, so long-running services can pick
+up new schema versions without restarting and without putting a lock on the decode path.
+
+Every published version is an immutable SchemaSnapshot: a sorted list of SchemaEntry, each one
+holding the parsed .proto (ProtoFile), the FlatBuffers reflection schema (SchemaT) and the
+protobuf FileDescriptorProto of one named schema. Entries that a version does not touch are
+shared with the previous version.
+
+Reads: Reader::Snapshot() is a single acquire load of the current snapshot pointer. There is no
+reference count, no lock and no write to shared memory. The pointer stays valid until the same
+reader's next Quiescent() call.
+
+Writes: Publish()/Remove() copy the entry list, swap the new snapshot in with one atomic exchange
+and retire the old one. Writers are serialized among themselves, never with readers.
+
+Reclamation is quiescent-state based (QSBR). Every reader thread owns a slot and calls
+Quiescent() at points where it holds no snapshot, typically between requests, so the cost is
+paid once per batch rather than once per read. That call copies the global epoch into the slot. A
+snapshot retired at epoch E is freed once every online reader has announced an epoch >= E.
+A reader about to block (waiting on I/O, sleeping) goes Offline() so it does not hold up
+reclamation.
+
+Usage:
+    SchemaRegistry registry;
+    registry.Publish(SchemaEntry::FromProto("trade", proto_source, "Trade.flatbuf"));
+
+    // reader thread
+    SchemaRegistry::Reader reader(registry);
+    for (;;) {
+        const SchemaSnapshot& schemas = reader.Snapshot();
+        const SchemaEntry* trade = schemas.Find("trade");
+        ... decode ...
+        reader.Quiescent();
+    }
+*/
+
+#include "FlatbuffersToProtobuf"
+#include "protoParser.h"
+#include "protobufToFlatBuffers.h"
+#include "reflection_generated.h"
+
+#include <google/protobuf/descriptor.pb.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One named schema, in every form the converters produce. Immutable once built
+struct SchemaEntry {
+    std::string name;
+    ProtoFile proto;
+    std::unique_ptr<reflection::SchemaT> fbs;
+    google::protobuf::FileDescriptorProto descriptor;
+
+    // From .proto source (ProtoParser); name_space is the FlatBuffers namespace of the tables
+    static std::shared_ptr<const SchemaEntry> FromProto(std::string name, const std::string& source, const std::string& name_space) {
+        auto entry = std::make_shared<SchemaEntry>();
+        entry->name = std::move(name);
+        entry->proto = ProtoParser(source).ParseFile();
+        entry->fbs = ProtobufToFlatBuffers(entry->proto, name_space).ConvertSchema();
+        entry->descriptor = FlatBuffersToProtobuf(entry->fbs.get()).Convert();
+        return entry;
+    }
+
+    // From a FlatBuffers reflection schema (an unpacked .bfbs)
+    static std::shared_ptr<const SchemaEntry> FromSchema(std::string name, std::unique_ptr<reflection::SchemaT> schema) {
+        if (!schema)
+            throw std::runtime_error("Schema entry without a schema: " + name);
+        auto entry = std::make_shared<SchemaEntry>();
+        entry->name = std::move(name);
+        entry->fbs = std::move(schema);
+        entry->descriptor = FlatBuffersToProtobuf(entry->fbs.get()).Convert();
+        entry->proto = ProtobufToFlatBuffers::FromDescriptor(entry->descriptor);
+        return entry;
+    }
+
+    // bfbs usually comes from outside (a file, a schema service), so it is verified before unpacking
+    static std::shared_ptr<const SchemaEntry> FromBfbs(std::string name, const uint8_t* bfbs, size_t size) {
+        flatbuffers::Verifier verifier(bfbs, size);
+        if (!reflection::VerifySchemaBuffer(verifier))
+            throw std::runtime_error("Invalid .bfbs schema: " + name);
+        return FromSchema(std::move(name), reflection::UnPackSchema(bfbs));
+    }
+
+    const Message* FindMessage(const std::string& message) const {
+        for (const auto& m : proto.messages)
+            if (m.name == message) return &m;
+        return nullptr;
+    }
+
+    const reflection::ObjectT* FindObject(const std::string& object) const {
+        for (const auto& o : fbs->objects)
+            if (o->name == object) return o.get();
+        return nullptr;
+    }
+};
+
+// One published version of the registry
+class SchemaSnapshot {
+public:
+    uint64_t version() const { return version_; }
+    const std::vector<std::shared_ptr<const SchemaEntry>>& entries() const { return entries_; }
+
+    const SchemaEntry* Find(const std::string& name) const {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), name,
+            [](const std::shared_ptr<const SchemaEntry>& entry, const std::string& key) { return entry->name < key; });
+        return it != entries_.end() && (*it)->name == name ? it->get() : nullptr;
+    }
+
+private:
+    friend class SchemaRegistry;
+
+    uint64_t version_ = 0;
+    std::vector<std::shared_ptr<const SchemaEntry>> entries_;  // sorted by name
+};
+
+class SchemaRegistry {
+    // One per registered reader, on its own cache line so Quiescent() stores do not false share
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{ 0 };  // last epoch announced, 0 while offline
+    };
+
+public:
+    // Registers the calling thread as a reader, online. Snapshots it reads must not outlive it
+    class Reader {
+    public:
+        explicit Reader(SchemaRegistry& registry) : registry_(registry), slot_(registry.Register()) {}
+        ~Reader() { registry_.Unregister(slot_); }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        // Current snapshot, valid until this reader's next Quiescent() or Offline()
+        const SchemaSnapshot& Snapshot() const { return *registry_.current_.load(std::memory_order_acquire); }
+
+        // No snapshot pointer obtained before this call is used after it
+        void Quiescent() {
+            slot_->epoch.store(registry_.epoch_.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+        // Before blocking: reclamation stops waiting for this reader, which must not call
+        // Snapshot() again until Online()
+        void Offline() { slot_->epoch.store(0, std::memory_order_release); }
+
+        void Online() {
+            slot_->epoch.store(registry_.epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            // The slot store must be visible before the first Snapshot() load, or a writer scanning
+            // the slots could see this reader offline while it picks up the snapshot being retired
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+    private:
+        SchemaRegistry& registry_;
+        Slot* slot_;
+    };
+
+    SchemaRegistry() : current_(new SchemaSnapshot()) {}
+
+    // Readers must be gone by now
+    ~SchemaRegistry() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    SchemaRegistry(const SchemaRegistry&) = delete;
+    SchemaRegistry& operator=(const SchemaRegistry&) = delete;
+
+    // Adds or replaces (by name) entries in one new version. Returns its version number
+    uint64_t Publish(std::vector<std::shared_ptr<const SchemaEntry>> updates) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        const SchemaSnapshot* old = current_.load(std::memory_order_relaxed);
+        std::unique_ptr<SchemaSnapshot> next(new SchemaSnapshot());
+        next->entries_ = old->entries_;
+        for (auto& update : updates) {
+            if (!update)
+                throw std::runtime_error("Cannot publish a null schema entry");
+            auto it = std::lower_bound(next->entries_.begin(), next->entries_.end(), update->name,
+                [](const std::shared_ptr<const SchemaEntry>& entry, const std::string& key) { return entry->name < key; });
+            if (it != next->entries_.end() && (*it)->name == update->name)
+                *it = std::move(update);
+            else
+                next->entries_.insert(it, std::move(update));
+        }
+        return Swap(std::move(next));
+    }
+
+    uint64_t Publish(std::shared_ptr<const SchemaEntry> entry) {
+        std::vector<std::shared_ptr<const SchemaEntry>> updates;
+        updates.push_back(std::move(entry));
+        return Publish(std::move(updates));
+    }
+
+    // Publishes a version without the named entry (a no-op version if it is not there)
+    uint64_t Remove(const std::string& name) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        const SchemaSnapshot* old = current_.load(std::memory_order_relaxed);
+        std::unique_ptr<SchemaSnapshot> next(new SchemaSnapshot());
+        next->entries_.reserve(old->entries_.size());
+        for (const auto& entry : old->entries_)
+            if (entry->name != name) next->entries_.push_back(entry);
+        return Swap(std::move(next));
+    }
+
+    // Latest version, for writers and monitoring; readers use Reader::Snapshot()
+    uint64_t version() const { return current_.load(std::memory_order_acquire)->version(); }
+
+    // Frees retired snapshots every online reader has moved past. Never blocks on readers
+    size_t Reclaim() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return ReclaimLocked();
+    }
+
+    // Waits for a grace period and frees everything retired so far. Must not be called by a
+    // thread that is an online reader itself, it would wait for its own Quiescent()
+    void Synchronize() {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(writer_mutex_);
+                ReclaimLocked();
+                if (retired_.empty()) return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Snapshots retired but not freed yet
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return retired_.size();
+    }
+
+private:
+    struct Retired {
+        std::unique_ptr<const SchemaSnapshot> snapshot;
+        uint64_t epoch;  // freed once every online reader announced at least this epoch
+    };
+
+    std::atomic<const SchemaSnapshot*> current_;
+    std::atomic<uint64_t> epoch_{ 1 };  // 0 is reserved for offline slots
+
+    mutable std::mutex writer_mutex_;  // publishers, reclamation and reader (un)registration
+    uint64_t next_version_ = 1;
+    std::vector<Retired> retired_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+
+    uint64_t Swap(std::unique_ptr<SchemaSnapshot> next) {
+        uint64_t version = next->version_ = next_version_++;
+        const SchemaSnapshot* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        // Readers that announce this epoch loaded it after the exchange, so they can only see the new snapshot
+        uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        retired_.push_back({ std::unique_ptr<const SchemaSnapshot>(old), epoch });
+        ReclaimLocked();
+        return version;
+    }
+
+    size_t ReclaimLocked() {
+        if (retired_.empty()) return 0;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t oldest = epoch_.load(std::memory_order_acquire);
+        for (const auto& slot : slots_) {
+            uint64_t epoch = slot->epoch.load(std::memory_order_acquire);
+            if (epoch != 0) oldest = std::min(oldest, epoch);
+        }
+        size_t before = retired_.size();
+        retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+            [oldest](const Retired& retired) { return retired.epoch <= oldest; }), retired_.end());
+        return before - retired_.size();
+    }
+
+    Slot* Register() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        slots_.emplace_back(new Slot());
+        Slot* slot = slots_.back().get();
+        slot->epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return slot;
+    }
+
+    void Unregister(Slot* slot) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        slots_.erase(std::remove_if(slots_.begin(), slots_.end(),
+            [slot](const std::unique_ptr<Slot>& s) { return s.get() == slot; }), slots_.end());
+        ReclaimLocked();
+    }
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "schemaRegistry.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Read-side cost of the RCU registry against the usual alternatives, with a writer publishing a
+// new version every millisecond. Each read fetches the current snapshot and touches one entry
+namespace {
+
+const auto kDuration = std::chrono::milliseconds(500);
+const int kQuiescentEvery = 256;
+
+// Runs readers (each returning its read count) next to a writer until kDuration is up
+template <typename ReadLoop, typename WriteOnce>
+double ReadsPerSecond(int threads, ReadLoop read_loop, WriteOnce write_once)
+{
+    std::atomic<bool> stop{ false };
+    std::vector<uint64_t> counts(threads);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < threads; ++t)
+        readers.emplace_back([&, t]() { counts[t] = read_loop(stop); });
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < kDuration)
+    {
+        write_once();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stop.store(true);
+    for (auto& reader : readers)
+        reader.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t total = 0;
+    for (uint64_t count : counts)
+        total += count;
+    return total / seconds;
+}
+
+// Work done on the snapshot by every variant, kept tiny so the fetch dominates
+inline uint64_t Touch(const SchemaSnapshot& snapshot, uint64_t i)
+{
+    const auto& entries = snapshot.entries();
+    return snapshot.version() + entries[i % entries.size()]->proto.messages.size();
+}
+
+volatile uint64_t sink;
+
+}
+
+int main(int argc, char** argv)
+{
+    // The protobuf schema (defaults to the one in this repo)
+    std::ifstream in(argc > 1 ? argv[1] : "protobufSchema.proto");
+    if (!in)
+    {
+        std::cerr << "Cannot read " << (argc > 1 ? argv[1] : "protobufSchema.proto") << std::endl;
+        return 1;
+    }
+    std::stringstream source;
+    source << in.rdbuf();
+
+    SchemaRegistry registry;
+    std::vector<std::shared_ptr<const SchemaEntry>> entries;
+    for (int i = 0; i < 8; ++i)
+        entries.push_back(SchemaEntry::FromProto("trade" + std::to_string(i), source.str(), "Trade.flatbuf"));
+    registry.Publish(entries);
+    size_t next = 0;
+    auto publish = [&]() { registry.Publish(entries[next++ % entries.size()]); };
+
+    // The baselines guard a copy of the latest snapshot with a lock or a shared_ptr
+    std::mutex mutex;
+    std::shared_mutex shared_mutex;
+    std::shared_ptr<const SchemaSnapshot> published;
+    auto copy_latest = [&]() {
+        SchemaRegistry::Reader reader(registry);
+        return std::make_shared<const SchemaSnapshot>(reader.Snapshot());
+    };
+    published = copy_latest();
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        std::cout << threads << " reader thread(s), million reads/s" << std::endl;
+
+        double rcu = ReadsPerSecond(threads,
+            [&](std::atomic<bool>& stop) {
+                SchemaRegistry::Reader reader(registry);
+                uint64_t reads = 0, sum = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (int i = 0; i < kQuiescentEvery; ++i, ++reads)
+                        sum += Touch(reader.Snapshot(), reads);
+                    reader.Quiescent();
+                }
+                sink = sum;
+                return reads;
+            },
+            publish);
+        std::cout << "  RCU Reader::Snapshot()       " << rcu / 1e6 << std::endl;
+
+        double atomic_shared = ReadsPerSecond(threads,
+            [&](std::atomic<bool>& stop) {
+                uint64_t reads = 0, sum = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                    for (int i = 0; i < kQuiescentEvery; ++i, ++reads)
+                        sum += Touch(*std::atomic_load(&published), reads);
+                sink = sum;
+                return reads;
+            },
+            [&]() { publish(); std::atomic_store(&published, copy_latest()); });
+        std::cout << "  std::atomic_load(shared_ptr) " << atomic_shared / 1e6 << std::endl;
+
+        double shared_lock = ReadsPerSecond(threads,
+            [&](std::atomic<bool>& stop) {
+                uint64_t reads = 0, sum = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                    for (int i = 0; i < kQuiescentEvery; ++i, ++reads)
+                    {
+                        std::shared_lock<std::shared_mutex> lock(shared_mutex);
+                        sum += Touch(*published, reads);
+                    }
+                sink = sum;
+                return reads;
+            },
+            [&]() {
+                publish();
+                auto latest = copy_latest();
+                std::unique_lock<std::shared_mutex> lock(shared_mutex);
+                published = std::move(latest);
+            });
+        std::cout << "  std::shared_mutex            " << shared_lock / 1e6 << std::endl;
+
+        double exclusive_lock = ReadsPerSecond(threads,
+            [&](std::atomic<bool>& stop) {
+                uint64_t reads = 0, sum = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                    for (int i = 0; i < kQuiescentEvery; ++i, ++reads)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        sum += Touch(*published, reads);
+                    }
+                sink = sum;
+                return reads;
+            },
+            [&]() {
+                publish();
+                auto latest = copy_latest();
+                std::lock_guard<std::mutex> lock(mutex);
+                published = std::move(latest);
+            });
+        std::cout << "  std::mutex                   " << exclusive_lock / 1e6 << std::endl;
+    }
+
+    registry.Synchronize();
+    std::cout << std::endl << "Published " << registry.version() << " versions, "
+              << registry.pending() << " retired snapshots still pending" << std::endl;
+
+    google::protobuf::ShutdownProtobufLibrary();
+
+    return 0;
+}
@@ -0,0 +1,553 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+/* Shared-memory ring for handing finished FlatBuffers to other processes on the same host
+without copying them.
+
+The ring lives in a shm_open() object (named, for unrelated processes) or a memfd (anonymous,
+passed to children or over a Unix socket). It is a fixed array of slots. A producer claims the
+next sequence number, builds its FlatBuffer straight into that slot through SlotAllocator, and
+publishes it. Every attached consumer sees every message (broadcast) and reads it in place,
+e.g. as a Trade::flatbuf::Account, until it releases it.
+
+    slot of sequence s = slots[s % slot_count]
+    slot.published == s + 1        message s is readable
+    consumer cursor c              c is the next sequence it will read, everything below is released
+    producer may reuse for s       s < min(active cursors) + slot_count and the slot's previous
+                                   lap (s - slot_count) is published, consumers or not
+
+Readers spin briefly and then sleep on a futex in the shared header, producers only make the
+wake syscall when someone sleeps, which keeps the hand-off in the low microseconds. Producers
+waiting for a full ring do the same on a second futex that consumers bump on Release() while a
+producer sleeps. Messages larger than a slot are rejected.
+
+Crashed processes:
+  - A consumer that dies without Detach() keeps its cursor and eventually stalls producers;
+    supervisors should call ShmRing::DetachConsumer() for it.
+  - A producer that dies between Begin() and Publish() leaves a hole every consumer stops at.
+    Each producer registers its pid in the header and records the sequence it claims before it
+    owns it. A consumer that waits longer than its publish timeout on a claimed sequence checks
+    the claimants; if all of them are dead (kill(pid, 0) fails with ESRCH) it publishes the
+    slot as abandoned and everyone moves on. A producer that is alive but slow is never
+    skipped, so a stopped (SIGSTOP) or stuck producer still stalls the ring. The check needs
+    producers and consumers in the same pid namespace. */
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/trade_generated.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+class ShmRing {
+public:
+    static constexpr uint32_t kMaxConsumers = 32;
+    static constexpr uint32_t kMaxProducers = 32;
+
+    // Creates a named ring (fails if the name exists); slot_count is rounded up to a power of two
+    static ShmRing Create(const std::string& name, uint32_t slot_count, uint32_t slot_size) {
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0) throw std::runtime_error("Cannot create shared memory " + name + ": " + std::strerror(errno));
+        return ShmRing(fd, true, slot_count, slot_size);
+    }
+
+    // Opens a named ring another process created
+    static ShmRing Open(const std::string& name) {
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (fd < 0) throw std::runtime_error("Cannot open shared memory " + name + ": " + std::strerror(errno));
+        return ShmRing(fd, false, 0, 0);
+    }
+
+    // Creates an anonymous ring; share it by passing fd() to a child or over SCM_RIGHTS
+    static ShmRing CreateAnonymous(uint32_t slot_count, uint32_t slot_size) {
+        int fd = ::memfd_create("trade-shm-ring", MFD_CLOEXEC);
+        if (fd < 0) throw std::runtime_error(std::string("Cannot create memfd: ") + std::strerror(errno));
+        return ShmRing(fd, true, slot_count, slot_size);
+    }
+
+    // Maps a ring from a received descriptor (takes ownership of fd)
+    static ShmRing FromFd(int fd) { return ShmRing(fd, false, 0, 0); }
+
+    static void Unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    ShmRing(ShmRing&& other) noexcept : fd_(other.fd_), base_(other.base_), length_(other.length_) {
+        other.fd_ = -1;
+        other.base_ = nullptr;
+    }
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+    ShmRing& operator=(ShmRing&&) = delete;
+
+    ~ShmRing() {
+        if (base_) ::munmap(base_, length_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    int fd() const { return fd_; }
+    uint32_t slot_count() const { return header()->slot_count; }
+    uint32_t slot_size() const { return header()->slot_size; }
+
+    // Frees a consumer slot left behind by a crashed process
+    void DetachConsumer(uint32_t index) {
+        header()->consumers[index].active.store(0, std::memory_order_seq_cst);
+        NotifySpace();
+    }
+
+private:
+    friend class ShmRingProducer;
+    friend class ShmRingConsumer;
+
+    static constexpr uint64_t kMagic = 0x324E495252444154ull;  // "TADRRIN2", v1 had no producer table
+    static constexpr size_t kLine = 64;
+    static constexpr uint64_t kPoisoning = 1ull << 63;        // in SlotHeader::published while a consumer skips a dead claim
+
+    struct alignas(kLine) Cursor {
+        std::atomic<uint64_t> next;      // next sequence this consumer reads
+        std::atomic<uint32_t> active;    // 0 free, 1 attaching, 2 attached
+    };
+
+    struct alignas(kLine) SlotHeader {
+        std::atomic<uint64_t> published; // sequence + 1 once readable
+        uint32_t offset;                 // of the finished buffer inside the slot data
+        uint32_t size;                   // 0 for an abandoned claim, consumers skip it
+    };
+
+    struct alignas(kLine) Producer {
+        std::atomic<uint64_t> claim;     // sequence + 1 this producer claims or is claiming, 0 none
+        std::atomic<uint32_t> pid;       // 0 free
+    };
+
+    struct Header {
+        std::atomic<uint64_t> magic;     // written last by the creator
+        uint32_t slot_count;
+        uint32_t slot_size;
+        alignas(kLine) std::atomic<uint64_t> head;     // next sequence producers claim
+        alignas(kLine) std::atomic<uint32_t> wakeups;  // futex word, bumped on publish
+        std::atomic<uint32_t> sleepers;
+        alignas(kLine) std::atomic<uint32_t> space;    // futex word, bumped on release while producers wait
+        std::atomic<uint32_t> space_waiters;
+        Cursor consumers[kMaxConsumers];
+        Producer producers[kMaxProducers];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "ring atomics must be address free to work across processes");
+
+    int fd_;
+    uint8_t* base_ = nullptr;
+    size_t length_ = 0;
+
+    ShmRing(int fd, bool create, uint32_t slot_count, uint32_t slot_size) : fd_(fd) {
+        try {
+            if (create) {
+                if (slot_count == 0 || slot_size == 0) throw std::invalid_argument("Ring needs at least one non-empty slot");
+                uint32_t count = 1;
+                while (count < slot_count) count <<= 1;
+                uint32_t size = static_cast<uint32_t>((slot_size + kLine - 1) / kLine * kLine);
+                length_ = Length(count, size);
+                if (::ftruncate(fd_, static_cast<off_t>(length_)) != 0) throw std::runtime_error("Cannot size shared memory");
+                Map();
+                // ftruncate zero-fills, so all atomics already start at 0
+                Header* h = header();
+                h->slot_count = count;
+                h->slot_size = size;
+                h->magic.store(kMagic, std::memory_order_release);
+            } else {
+                struct stat st;
+                if (::fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) throw std::runtime_error("Shared memory is not a ring");
+                length_ = static_cast<size_t>(st.st_size);
+                Map();
+                if (header()->magic.load(std::memory_order_acquire) != kMagic ||
+                    Length(header()->slot_count, header()->slot_size) != length_)
+                    throw std::runtime_error("Shared memory is not a ring");
+            }
+        } catch (...) {
+            if (base_) ::munmap(base_, length_);
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    static size_t Stride(uint32_t slot_size) { return sizeof(SlotHeader) + slot_size; }
+    static size_t HeaderLength() { return (sizeof(Header) + kLine - 1) / kLine * kLine; }
+    static size_t Length(uint32_t count, uint32_t size) { return HeaderLength() + static_cast<size_t>(count) * Stride(size); }
+
+    void Map() {
+        void* p = ::mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot map shared memory");
+        base_ = static_cast<uint8_t*>(p);
+    }
+
+    Header* header() const { return reinterpret_cast<Header*>(base_); }
+
+    SlotHeader* slot(uint64_t sequence) const {
+        size_t index = static_cast<size_t>(sequence & (header()->slot_count - 1));
+        return reinterpret_cast<SlotHeader*>(base_ + HeaderLength() + index * Stride(header()->slot_size));
+    }
+
+    uint8_t* slot_data(uint64_t sequence) const { return reinterpret_cast<uint8_t*>(slot(sequence)) + sizeof(SlotHeader); }
+
+    // Lowest cursor of all attached consumers, or limit when there are none
+    uint64_t MinCursor(uint64_t limit) const {
+        uint64_t min = limit;
+        for (const Cursor& c : header()->consumers)
+            if (c.active.load(std::memory_order_seq_cst) != 0) min = std::min(min, c.next.load(std::memory_order_acquire));
+        return min;
+    }
+
+    // The previous lap of sequence's slot is published (trivially so on the first lap)
+    bool LapPublished(uint64_t sequence) const {
+        uint32_t count = header()->slot_count;
+        return sequence < count || slot(sequence)->published.load(std::memory_order_acquire) == sequence - count + 1;
+    }
+
+    static long Futex(std::atomic<uint32_t>* word, int op, uint32_t value, const struct timespec* timeout = nullptr) {
+        return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+    }
+
+    static struct timespec Timespec(std::chrono::nanoseconds timeout) {
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        return ts;
+    }
+
+    static bool Alive(uint32_t pid) { return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH; }
+
+    static void Pause() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    void Notify() {
+        Header* h = header();
+        h->wakeups.fetch_add(1, std::memory_order_seq_cst);
+        if (h->sleepers.load(std::memory_order_seq_cst) != 0) Futex(&h->wakeups, FUTEX_WAKE, std::numeric_limits<int>::max());
+    }
+
+    // Wakes producers waiting for a full ring, after a cursor moved or went away
+    void NotifySpace() {
+        Header* h = header();
+        if (h->space_waiters.load(std::memory_order_seq_cst) == 0) return;
+        h->space.fetch_add(1, std::memory_order_seq_cst);
+        Futex(&h->space, FUTEX_WAKE, std::numeric_limits<int>::max());
+    }
+
+    // Takes a producer entry, reusing ones left by dead processes that hold no claim
+    Producer* RegisterProducer() {
+        uint32_t self = static_cast<uint32_t>(::getpid());
+        for (Producer& p : header()->producers) {
+            uint32_t pid = p.pid.load(std::memory_order_seq_cst);
+            if (pid != 0 && (p.claim.load(std::memory_order_seq_cst) != 0 || Alive(pid))) continue;
+            if (p.pid.compare_exchange_strong(pid, self, std::memory_order_seq_cst)) {
+                p.claim.store(0, std::memory_order_seq_cst);
+                return &p;
+            }
+        }
+        throw std::runtime_error("All ring producer entries are taken");
+    }
+
+    // Publishes sequence as abandoned if it is claimed and every claimant is dead. Returns whether
+    // the slot is now published, by this call or anyone else
+    bool ReclaimDeadClaim(uint64_t sequence) {
+        Header* h = header();
+        SlotHeader* s = slot(sequence);
+        uint64_t published = s->published.load(std::memory_order_acquire);
+        if (published == sequence + 1) return true;
+        if ((published & kPoisoning) || h->head.load(std::memory_order_seq_cst) <= sequence) return false;
+        // A slower consumer may still be reading the slot's previous lap; wait for it like a producer would
+        if (sequence >= MinCursor(sequence + 1) + h->slot_count || !LapPublished(sequence)) return false;
+        // The owner stored its claim before taking the sequence, so it is among these. Losers of
+        // the head race may show the same claim for a moment; if alive, we just try again later
+        bool dead = false;
+        for (Producer& p : h->producers) {
+            if (p.claim.load(std::memory_order_seq_cst) != sequence + 1) continue;
+            uint32_t pid = p.pid.load(std::memory_order_seq_cst);
+            if (pid != 0 && Alive(pid)) return false;
+            dead = true;
+        }
+        if (!dead) return s->published.load(std::memory_order_acquire) == sequence + 1;
+        // Only one consumer writes the slot header; a CAS failure means another one is on it
+        if (!s->published.compare_exchange_strong(published, (sequence + 1) | kPoisoning, std::memory_order_acq_rel)) return false;
+        s->offset = 0;
+        s->size = 0;
+        s->published.store(sequence + 1, std::memory_order_release);
+        for (Producer& p : h->producers) {
+            uint64_t claim = sequence + 1;
+            if (p.claim.compare_exchange_strong(claim, 0, std::memory_order_seq_cst)) p.pid.store(0, std::memory_order_seq_cst);
+        }
+        Notify();
+        NotifySpace();
+        return true;
+    }
+};
+
+// Hands the claimed slot to FlatBufferBuilder as its one and only buffer
+class SlotAllocator : public flatbuffers::Allocator {
+public:
+    void Reset(uint8_t* data, size_t size) {
+        data_ = data;
+        size_ = size;
+    }
+    uint8_t* allocate(size_t size) override {
+        if (size > size_) throw std::length_error("FlatBuffer does not fit in a ring slot");
+        return data_;
+    }
+    void deallocate(uint8_t*, size_t) override {}  // the ring owns the memory
+    uint8_t* reallocate_downward(uint8_t*, size_t, size_t, size_t, size_t) override {
+        throw std::length_error("FlatBuffer does not fit in a ring slot");
+    }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// One per producing thread; any number of producers may share a ring
+class ShmRingProducer {
+public:
+    // space_poll bounds each futex sleep on a full ring, so cursors freed by a supervisor are seen
+    explicit ShmRingProducer(ShmRing& ring, std::chrono::milliseconds space_poll = std::chrono::milliseconds(100))
+        : ring_(ring), entry_(ring.RegisterProducer()), poll_(ShmRing::Timespec(space_poll)) {}
+
+    ShmRingProducer(const ShmRingProducer&) = delete;
+    ShmRingProducer& operator=(const ShmRingProducer&) = delete;
+
+    ~ShmRingProducer() {
+        if (builder_) Abandon();
+        entry_->claim.store(0, std::memory_order_seq_cst);
+        entry_->pid.store(0, std::memory_order_seq_cst);
+    }
+
+    // Claims the next slot (waiting while consumers still hold it) and returns a builder writing into it
+    flatbuffers::FlatBufferBuilder& Begin() {
+        if (builder_) throw std::logic_error("Previous message was not published");
+        ShmRing::Header* h = ring_.header();
+        // Record the claim before owning the sequence, so a consumer finding it unpublished can
+        // always find its owner
+        uint64_t sequence = h->head.load(std::memory_order_seq_cst);
+        do
+            entry_->claim.store(sequence + 1, std::memory_order_seq_cst);
+        while (!h->head.compare_exchange_weak(sequence, sequence + 1, std::memory_order_seq_cst));
+        sequence_ = sequence;
+        WaitForSpace();
+        allocator_.Reset(ring_.slot_data(sequence_), h->slot_size);
+        builder_.emplace(h->slot_size, &allocator_, false, 8);
+        return *builder_;
+    }
+
+    // Makes the finished buffer visible to consumers, returns its sequence number
+    uint64_t Publish() {
+        if (!builder_) throw std::logic_error("Nothing to publish");
+        const uint8_t* data = ring_.slot_data(sequence_);
+        const uint8_t* buffer = builder_->GetBufferPointer();
+        if (buffer < data || buffer + builder_->GetSize() > data + ring_.slot_size()) throw std::logic_error("Builder left its ring slot");
+        Commit(static_cast<uint32_t>(buffer - data), builder_->GetSize());
+        return sequence_;
+    }
+
+    // Releases a claimed slot without a message (consumers skip it); the ring cannot have holes
+    void Abandon() {
+        if (builder_) Commit(0, 0);
+    }
+
+    // Begin, build(builder) which must Finish() it, Publish; the slot is abandoned if build throws
+    template <typename Build>
+    uint64_t Send(Build&& build) {
+        flatbuffers::FlatBufferBuilder& builder = Begin();
+        try {
+            build(builder);
+        } catch (...) {
+            Abandon();
+            throw;
+        }
+        return Publish();
+    }
+
+private:
+    ShmRing& ring_;
+    ShmRing::Producer* entry_;
+    struct timespec poll_;
+    SlotAllocator allocator_;
+    std::optional<flatbuffers::FlatBufferBuilder> builder_;
+    uint64_t sequence_ = 0;
+
+    // Every consumer is past the slot's previous lap, and that lap's producer has published it.
+    // The second half matters without consumers too: a producer a lap ahead must not build into
+    // the slot while the slow one is still writing it
+    bool HasSpace() const {
+        return sequence_ < ring_.MinCursor(sequence_ + 1) + ring_.header()->slot_count && ring_.LapPublished(sequence_);
+    }
+
+    // Ring full or previous lap unpublished: spin a little, then sleep until a consumer releases
+    // or a producer publishes. A previous lap whose producer died is skipped like consumers do
+    void WaitForSpace() {
+        ShmRing::Header* h = ring_.header();
+        for (unsigned spins = 0; !HasSpace(); ++spins) {
+            if (spins < 1000) {
+                ShmRing::Pause();
+                continue;
+            }
+            uint32_t seen = h->space.load(std::memory_order_seq_cst);
+            h->space_waiters.fetch_add(1, std::memory_order_seq_cst);
+            bool slept = !HasSpace() && ShmRing::Futex(&h->space, FUTEX_WAIT, seen, &poll_) != 0 && errno == ETIMEDOUT;
+            h->space_waiters.fetch_sub(1, std::memory_order_seq_cst);
+            if (slept && !ring_.LapPublished(sequence_)) ring_.ReclaimDeadClaim(sequence_ - h->slot_count);
+        }
+    }
+
+    void Commit(uint32_t offset, uint32_t size) {
+        ShmRing::SlotHeader* slot = ring_.slot(sequence_);
+        slot->offset = offset;
+        slot->size = size;
+        slot->published.store(sequence_ + 1, std::memory_order_release);
+        entry_->claim.store(0, std::memory_order_seq_cst);
+        builder_.reset();
+        ring_.Notify();
+        ring_.NotifySpace();  // a producer one lap ahead may wait for this slot
+    }
+};
+
+// One per reading thread. Attaching takes one of the ring's consumer cursors; the consumer then
+// sees every message published after that point
+class ShmRingConsumer {
+public:
+    struct Message {
+        const uint8_t* data = nullptr;
+        uint32_t size = 0;
+        uint64_t sequence = 0;
+
+        template <typename T>
+        const T* As() const { return flatbuffers::GetRoot<T>(data); }
+        const Trade::flatbuf::Account* Account() const { return Trade::flatbuf::GetAccount(data); }
+        // Cheap insurance when the producer is a different, less trusted process
+        bool VerifyAccount() const {
+            flatbuffers::Verifier verifier(data, size);
+            return Trade::flatbuf::VerifyAccountBuffer(verifier);
+        }
+    };
+
+    // A sequence claimed but unpublished for publish_timeout is checked for a dead producer
+    explicit ShmRingConsumer(ShmRing& ring, unsigned spin_iterations = 2000,
+                             std::chrono::milliseconds publish_timeout = std::chrono::milliseconds(100))
+        : ring_(ring), spins_(spin_iterations), timeout_(publish_timeout), poll_(ShmRing::Timespec(publish_timeout)) {
+        ShmRing::Header* h = ring_.header();
+        for (uint32_t i = 0; i < ShmRing::kMaxConsumers && !cursor_; ++i) {
+            uint32_t expected = 0;
+            if (h->consumers[i].active.compare_exchange_strong(expected, 1, std::memory_order_seq_cst)) {
+                index_ = i;
+                cursor_ = &h->consumers[i];
+            }
+        }
+        if (!cursor_) throw std::runtime_error("All ring consumer cursors are taken");
+        // Publish a conservative cursor first, then move it to the current head. Producers that
+        // see either value never overwrite anything at or after the final position
+        cursor_->next.store(h->head.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        cursor_->active.store(2, std::memory_order_seq_cst);
+        next_ = h->head.load(std::memory_order_seq_cst);
+        cursor_->next.store(next_, std::memory_order_seq_cst);
+    }
+
+    ShmRingConsumer(const ShmRingConsumer&) = delete;
+    ShmRingConsumer& operator=(const ShmRingConsumer&) = delete;
+
+    ~ShmRingConsumer() { Detach(); }
+
+    void Detach() {
+        if (!cursor_) return;
+        cursor_->active.store(0, std::memory_order_seq_cst);
+        cursor_ = nullptr;
+        ring_.NotifySpace();
+    }
+
+    uint32_t index() const { return index_; }
+
+    // Next message if one is ready. It stays valid, in place in the ring, until Release()
+    bool TryNext(Message& message) {
+        for (;;) {
+            ShmRing::SlotHeader* slot = ring_.slot(next_);
+            if (slot->published.load(std::memory_order_acquire) != next_ + 1) return false;
+            if (slot->size == 0) {  // abandoned claim
+                Advance();
+                continue;
+            }
+            message.data = ring_.slot_data(next_) + slot->offset;
+            message.size = slot->size;
+            message.sequence = next_;
+            ++next_;  // the cursor itself only moves on Release
+            return true;
+        }
+    }
+
+    // Blocking TryNext: spins for a while, then sleeps on the ring's futex. Wakes at least every
+    // publish timeout to skip a sequence whose producer died before publishing it
+    Message Next() {
+        Message message;
+        ShmRing::Header* h = ring_.header();
+        for (unsigned i = 0; i < spins_; ++i) {
+            if (TryNext(message)) return message;
+            ShmRing::Pause();
+        }
+        auto since = std::chrono::steady_clock::now();
+        uint64_t waiting = next_;
+        for (;;) {
+            uint32_t seen = h->wakeups.load(std::memory_order_seq_cst);
+            h->sleepers.fetch_add(1, std::memory_order_seq_cst);
+            bool ready = TryNext(message);
+            if (!ready) ShmRing::Futex(&h->wakeups, FUTEX_WAIT, seen, &poll_);
+            h->sleepers.fetch_sub(1, std::memory_order_seq_cst);
+            if (ready || TryNext(message)) return message;
+            auto now = std::chrono::steady_clock::now();
+            if (waiting != next_) {  // skipped abandoned slots meanwhile, the clock starts over
+                waiting = next_;
+                since = now;
+            } else if (now - since >= timeout_ && ring_.ReclaimDeadClaim(next_)) {
+                since = now;
+            }
+        }
+    }
+
+    // Gives every message returned so far back to the producers
+    void Release() {
+        if (!cursor_) return;  // detached
+        cursor_->next.store(next_, std::memory_order_seq_cst);
+        ring_.NotifySpace();
+    }
+
+private:
+    ShmRing& ring_;
+    unsigned spins_;
+    std::chrono::milliseconds timeout_;
+    struct timespec poll_;
+    ShmRing::Cursor* cursor_ = nullptr;
+    uint32_t index_ = 0;
+    uint64_t next_ = 0;
+
+    void Advance() {
+        ++next_;
+        if (cursor_ && cursor_->next.load(std::memory_order_relaxed) + 1 == next_) Release();  // nothing held, skip right away
+    }
+};
+
+#endif // SHM_RING_H
@@ -0,0 +1,111 @@
+#include "../proto/trade.h"
+#include "shmRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Producer-to-consumer latency of ShmRing between two processes: one producer publishing an
+// Account every few microseconds, one forked consumer timing each message from Publish() to its
+// return from Next(). Once with a consumer that spins and once with one that sleeps on the futex.
+// Both processes busy-wait, so the numbers only mean something with two otherwise idle cores
+namespace {
+
+const size_t kMessages = 200000;
+const auto kInterval = std::chrono::microseconds(20);
+
+struct Shared {
+    std::atomic<int> ready;
+    int64_t sent[kMessages];     // steady_clock ns at Publish, written before the message is published
+    int64_t latency[kMessages];  // ns, written by the consumer
+};
+
+int64_t Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Consume(ShmRing& ring, Shared& shared, unsigned spin_iterations)
+{
+    ShmRingConsumer consumer(ring, spin_iterations);
+    shared.ready.store(1);
+    for (size_t i = 0; i < kMessages; ++i)
+    {
+        ShmRingConsumer::Message message = consumer.Next();
+        shared.latency[message.sequence] = Now() - shared.sent[message.sequence];
+        consumer.Release();
+    }
+}
+
+// Returns the sorted latencies in ns
+std::vector<int64_t> Run(unsigned spin_iterations)
+{
+    void* memory = ::mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) throw std::runtime_error("Cannot map shared memory");
+    Shared& shared = *static_cast<Shared*>(memory);
+    ShmRing ring = ShmRing::CreateAnonymous(1024, 512);
+
+    pid_t child = ::fork();
+    if (child < 0) throw std::runtime_error("Cannot fork");
+    if (child == 0)
+    {
+        Consume(ring, shared, spin_iterations);
+        ::_exit(0);
+    }
+    while (shared.ready.load() == 0)
+        std::this_thread::yield();
+
+    // One producer on a fresh ring, so message i gets sequence i
+    TradeProto::Account account(1, "Account 1", "USD", 1000000);
+    account.Orders.emplace_back(1, "EURUSD", TradeProto::OrderSide::BUY, TradeProto::OrderType::LIMIT, 1.0875, 100000);
+    account.Orders.emplace_back(2, "GBPUSD", TradeProto::OrderSide::SELL, TradeProto::OrderType::MARKET, 1.2650, 50000);
+    ShmRingProducer producer(ring);
+    auto next = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kMessages; ++i)
+    {
+        next += kInterval;
+        while (std::chrono::steady_clock::now() < next)
+            ;
+        flatbuffers::FlatBufferBuilder& builder = producer.Begin();
+        builder.Finish(account.Serialize(builder));
+        shared.sent[i] = Now();
+        producer.Publish();
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) throw std::runtime_error("Consumer failed");
+
+    std::vector<int64_t> latencies(shared.latency, shared.latency + kMessages);
+    ::munmap(memory, sizeof(Shared));
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+void Print(const char* name, const std::vector<int64_t>& latencies)
+{
+    auto at = [&](double q) { return latencies[static_cast<size_t>(q * (latencies.size() - 1))] / 1000.0; };
+    std::cout << std::setw(18) << name << std::fixed << std::setprecision(2)
+              << std::setw(10) << at(0.5) << std::setw(10) << at(0.99) << std::setw(10) << at(0.999)
+              << std::setw(10) << latencies.back() / 1000.0 << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::cout << kMessages << " Accounts, one every " << kInterval.count() << " us, latency in us" << std::endl;
+    std::cout << std::setw(18) << "consumer" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(10) << "max" << std::endl;
+    Print("spinning", Run(1u << 30));
+    Print("futex (no spin)", Run(0));
+    Print("default (2000)", Run(2000));
+    return 0;
+}
@@ -0,0 +1,103 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/* Small fixed-size worker pool shared by the scan, ingest and conversion code.
+Tasks are std::function<void()> pulled from one queue; Submit() hands back a
+std::future so callers can wait on (and rethrow from) individual tasks. */
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool {
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0)
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+            workers_.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;  // workers drain the queue and then exit
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // Queue a callable, returns a future for its result (exceptions travel through the future)
+    template <typename F>
+    auto Submit(F&& fn) -> std::future<typename std::invoke_result<F>::type> {
+        using Result = typename std::invoke_result<F>::type;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([task] { (*task)(); });
+        }
+        wake_.notify_one();
+        return result;
+    }
+
+    // Runs fn(begin, end) over [0, count) split into roughly equal chunks, one per worker.
+    // Blocks until every chunk is done and rethrows the first failure.
+    template <typename F>
+    void ParallelFor(size_t count, F&& fn) {
+        if (count == 0) return;
+        size_t chunks = std::min(count, workers_.size());
+        size_t step = (count + chunks - 1) / chunks;
+        std::vector<std::future<void>> pending;
+        pending.reserve(chunks);
+        for (size_t begin = 0; begin < count; begin += step) {
+            size_t end = std::min(count, begin + step);
+            pending.push_back(Submit([&fn, begin, end] { fn(begin, end); }));
+        }
+        // Chunks hold references to fn and the caller's frame, so none may still be queued or
+        // running when a failure propagates
+        for (auto& p : pending)
+            p.wait();
+        for (auto& p : pending)
+            p.get();
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    void WorkerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return;  // stopping and nothing left to run
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+};
+
+#endif // THREAD_POOL_H
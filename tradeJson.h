@@ -0,0 +1,666 @@
+#ifndef TRADE_JSON_H
+#define TRADE_JSON_H
+
+/* Schema-specialized JSON for Account / Balance / Order, from and to TradeProto structs and
+Trade::flatbuf buffers, without going through protobuf reflection.
+
+Output is the same document google::protobuf::util::MessageToJsonString produces with default
+options: compact, proto3 JSON names, fields left out when they hold their default value, enums
+by name (taken from the flatc EnumNames tables), NaN / Infinity as strings. Doubles are written
+shortest round-trip with std::to_chars, so the digits can differ from protobuf's %.17g fallback
+but always parse back to the same value.
+
+The parser accepts what JsonStringToMessage accepts for this schema: any whitespace, fields in
+any order, null for a default, enums by name or number, numbers quoted or not. Strings and
+whitespace are scanned 16 bytes at a time with SSE2 where available. Unknown fields and
+malformed input throw std::runtime_error.
+
+Usage:
+    std::string json;
+    TradeJson::WriteAccount(account, json);               // appends
+    TradeProto::Account back;
+    TradeJson::ParseAccount(json, back);
+    auto root = TradeJson::ParseAccount(json, builder);   // straight into a FlatBuffer
+*/
+
+#include "../proto/trade.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/trade_generated.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRADE_JSON_SSE2 1
+#endif
+
+namespace TradeJson {
+
+namespace detail {
+
+    // Keys with their quotes and colon, written with one append each
+    constexpr std::string_view kId = "\"id\":";
+    constexpr std::string_view kName = "\"name\":";
+    constexpr std::string_view kWallet = "\"wallet\":";
+    constexpr std::string_view kOrders = "\"orders\":";
+    constexpr std::string_view kSymbol = "\"symbol\":";
+    constexpr std::string_view kSide = "\"side\":";
+    constexpr std::string_view kType = "\"type\":";
+    constexpr std::string_view kPrice = "\"price\":";
+    constexpr std::string_view kVolume = "\"volume\":";
+    constexpr std::string_view kCurrency = "\"currency\":";
+    constexpr std::string_view kAmount = "\"amount\":";
+
+    inline int CountTrailingZeros(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // First '"', '\\' or control character in [p, end), end if none
+    inline const char* FindStringSpecial(const char* p, const char* end) {
+#ifdef TRADE_JSON_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1f);
+        for (; end - p >= 16; p += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));  // unsigned v <= 0x1f
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+            if (mask) return p + CountTrailingZeros(mask);
+        }
+#endif
+        for (; p < end; ++p) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '"' || c == '\\' || c < 0x20) return p;
+        }
+        return end;
+    }
+
+    inline bool IsWhitespace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+    inline const char* SkipWhitespace(const char* p, const char* end) {
+        if (p < end && !IsWhitespace(*p)) return p;   // compact JSON: nothing to skip
+#ifdef TRADE_JSON_SSE2
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i cr = _mm_set1_epi8('\r');
+        const __m128i tab = _mm_set1_epi8('\t');
+        for (; end - p >= 16; p += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, newline)),
+                                      _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, tab)));
+            unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xffffu;
+            if (mask) return p + CountTrailingZeros(mask);
+        }
+#endif
+        while (p < end && IsWhitespace(*p)) ++p;
+        return p;
+    }
+
+    // Enum names from the flatc tables, quoted for writing and bare for matching
+    class EnumTable {
+    public:
+        explicit EnumTable(const char* const* names) {
+            for (; *names; ++names) {
+                names_.emplace_back(*names);
+                quoted_.push_back('"' + names_.back() + '"');
+            }
+        }
+
+        size_t size() const { return names_.size(); }
+        const std::string& Quoted(size_t value) const { return quoted_[value]; }
+
+        int Find(std::string_view name) const {
+            for (size_t i = 0; i < names_.size(); ++i)
+                if (names_[i] == name) return static_cast<int>(i);
+            return -1;
+        }
+
+    private:
+        std::vector<std::string> names_;
+        std::vector<std::string> quoted_;
+    };
+
+    inline const EnumTable& OrderSides() {
+        static const EnumTable table(Trade::flatbuf::EnumNamesOrderSide());
+        return table;
+    }
+
+    inline const EnumTable& OrderTypes() {
+        static const EnumTable table(Trade::flatbuf::EnumNamesOrderType());
+        return table;
+    }
+
+    // ------------------------- Writing -------------------------
+
+    class Writer {
+    public:
+        explicit Writer(std::string& out) : out_(out) {}
+
+        void Open() { out_.push_back('{'); first_ = true; }
+        void Close() { out_.push_back('}'); first_ = false; }
+
+        void Key(std::string_view key) {
+            if (!first_) out_.push_back(',');
+            first_ = false;
+            out_.append(key.data(), key.size());
+        }
+
+        void Int(std::string_view key, int32_t value) {
+            if (value == 0) return;
+            Key(key);
+            char buffer[16];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out_.append(buffer, result.ptr);
+        }
+
+        void Double(std::string_view key, double value) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            if (bits == 0) return;                        // -0.0 is not a default, like protobuf
+            Key(key);
+            if (std::isnan(value)) {
+                out_.append("\"NaN\"");
+            } else if (std::isinf(value)) {
+                out_.append(value > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+            } else {
+                char buffer[32];
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                out_.append(buffer, result.ptr);
+            }
+        }
+
+        void Enum(std::string_view key, int value, const EnumTable& table) {
+            if (value == 0) return;
+            Key(key);
+            if (value > 0 && static_cast<size_t>(value) < table.size()) {
+                out_.append(table.Quoted(value));
+            } else {                                      // unknown value: by number, like protobuf
+                char buffer[16];
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                out_.append(buffer, result.ptr);
+            }
+        }
+
+        void String(std::string_view key, const char* data, size_t size) {
+            if (size == 0) return;
+            Key(key);
+            Quoted(data, size);
+        }
+
+        void Quoted(const char* data, size_t size) {
+            const char* end = data + size;
+            out_.push_back('"');
+            for (;;) {
+                const char* special = FindStringSpecial(data, end);
+                out_.append(data, special);
+                if (special == end) break;
+                Escape(static_cast<unsigned char>(*special));
+                data = special + 1;
+            }
+            out_.push_back('"');
+        }
+
+        std::string& out() { return out_; }
+
+    private:
+        std::string& out_;
+        bool first_ = true;
+
+        void Escape(unsigned char c) {
+            switch (c) {
+            case '"': out_.append("\\\""); break;
+            case '\\': out_.append("\\\\"); break;
+            case '\b': out_.append("\\b"); break;
+            case '\f': out_.append("\\f"); break;
+            case '\n': out_.append("\\n"); break;
+            case '\r': out_.append("\\r"); break;
+            case '\t': out_.append("\\t"); break;
+            default: {
+                static const char hex[] = "0123456789abcdef";
+                char buffer[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+                out_.append(buffer, sizeof(buffer));
+            }
+            }
+        }
+    };
+
+    inline size_t BoundedLength(const char* text, size_t capacity) {
+        const void* zero = std::memchr(text, 0, capacity);
+        return zero ? static_cast<const char*>(zero) - text : capacity;
+    }
+
+} // namespace detail
+
+// ------------------------- Encoding -------------------------
+
+inline void WriteOrder(const TradeProto::Order& order, std::string& out) {
+    detail::Writer w(out);
+    w.Open();
+    w.Int(detail::kId, order.Id);
+    w.String(detail::kSymbol, order.Symbol, detail::BoundedLength(order.Symbol, sizeof(order.Symbol)));
+    w.Enum(detail::kSide, static_cast<int>(order.Side), detail::OrderSides());
+    w.Enum(detail::kType, static_cast<int>(order.Type), detail::OrderTypes());
+    w.Double(detail::kPrice, order.Price);
+    w.Double(detail::kVolume, order.Volume);
+    w.Close();
+}
+
+inline void WriteBalance(const TradeProto::Balance& balance, std::string& out) {
+    detail::Writer w(out);
+    w.Open();
+    w.String(detail::kCurrency, balance.Currency, detail::BoundedLength(balance.Currency, sizeof(balance.Currency)));
+    w.Double(detail::kAmount, balance.Amount);
+    w.Close();
+}
+
+// Appends the account to out
+inline void WriteAccount(const TradeProto::Account& account, std::string& out) {
+    out.reserve(out.size() + 64 + account.Orders.size() * 96);
+    detail::Writer w(out);
+    w.Open();
+    w.Int(detail::kId, account.Id);
+    w.String(detail::kName, account.Name.data(), account.Name.size());
+    w.Key(detail::kWallet);                           // a TradeProto wallet always exists
+    WriteBalance(account.Wallet, out);
+    if (!account.Orders.empty()) {
+        w.Key(detail::kOrders);
+        out.push_back('[');
+        for (size_t i = 0; i < account.Orders.size(); ++i) {
+            if (i) out.push_back(',');
+            WriteOrder(account.Orders[i], out);
+        }
+        out.push_back(']');
+    }
+    w.Close();
+}
+
+inline void WriteOrder(const Trade::flatbuf::Order& order, std::string& out) {
+    detail::Writer w(out);
+    w.Open();
+    w.Int(detail::kId, order.id());
+    if (auto symbol = order.symbol()) w.String(detail::kSymbol, symbol->c_str(), symbol->size());
+    w.Enum(detail::kSide, order.side(), detail::OrderSides());
+    w.Enum(detail::kType, order.type(), detail::OrderTypes());
+    w.Double(detail::kPrice, order.price());
+    w.Double(detail::kVolume, order.volume());
+    w.Close();
+}
+
+inline void WriteBalance(const Trade::flatbuf::Balance& balance, std::string& out) {
+    detail::Writer w(out);
+    w.Open();
+    if (auto currency = balance.currency()) w.String(detail::kCurrency, currency->c_str(), currency->size());
+    w.Double(detail::kAmount, balance.amount());
+    w.Close();
+}
+
+inline void WriteAccount(const Trade::flatbuf::Account& account, std::string& out) {
+    auto orders = account.orders();
+    out.reserve(out.size() + 64 + (orders ? orders->size() * 96 : 0));
+    detail::Writer w(out);
+    w.Open();
+    w.Int(detail::kId, account.id());
+    if (auto name = account.name()) w.String(detail::kName, name->c_str(), name->size());
+    if (auto wallet = account.wallet()) {
+        w.Key(detail::kWallet);
+        WriteBalance(*wallet, out);
+    }
+    if (orders && orders->size() > 0) {
+        w.Key(detail::kOrders);
+        out.push_back('[');
+        for (flatbuffers::uoffset_t i = 0; i < orders->size(); ++i) {
+            if (i) out.push_back(',');
+            WriteOrder(*orders->Get(i), out);
+        }
+        out.push_back(']');
+    }
+    w.Close();
+}
+
+template <typename T>
+std::string ToJson(const T& value) {
+    std::string out;
+    WriteAccount(value, out);
+    return out;
+}
+
+// ------------------------- Decoding -------------------------
+
+namespace detail {
+
+    class Reader {
+    public:
+        explicit Reader(std::string_view json) : begin_(json.data()), p_(json.data()), end_(json.data() + json.size()) {}
+
+        [[noreturn]] void Fail(const char* what) const {
+            throw std::runtime_error(std::string("Invalid Account JSON: ") + what + " at offset " + std::to_string(p_ - begin_));
+        }
+
+        void SkipWhitespace() { p_ = detail::SkipWhitespace(p_, end_); }
+
+        char Peek() {
+            SkipWhitespace();
+            return p_ < end_ ? *p_ : '\0';
+        }
+
+        void Expect(char c) {
+            if (Peek() != c) Fail("unexpected character");
+            ++p_;
+        }
+
+        void Finish() {
+            if (Peek() != '\0' || p_ != end_) Fail("trailing characters");
+        }
+
+        bool Null() {
+            if (Peek() == 'n' && end_ - p_ >= 4 && std::memcmp(p_, "null", 4) == 0) {
+                p_ += 4;
+                return true;
+            }
+            return false;
+        }
+
+        // Calls on_field(key) for each member; on_field must consume the value
+        template <typename OnField>
+        void Object(OnField&& on_field) {
+            Expect('{');
+            if (Peek() == '}') {
+                ++p_;
+                return;
+            }
+            for (;;) {
+                if (Peek() != '"') Fail("expected a field name");
+                std::string_view key = String(key_scratch_);
+                Expect(':');
+                on_field(key);
+                char c = Peek();
+                ++p_;
+                if (c == '}') return;
+                if (c != ',') Fail("expected ',' or '}'");
+            }
+        }
+
+        template <typename OnElement>
+        void Array(OnElement&& on_element) {
+            Expect('[');
+            if (Peek() == ']') {
+                ++p_;
+                return;
+            }
+            for (;;) {
+                on_element();
+                char c = Peek();
+                ++p_;
+                if (c == ']') return;
+                if (c != ',') Fail("expected ',' or ']'");
+            }
+        }
+
+        // A view into the input when there is nothing to unescape, otherwise into scratch
+        std::string_view String(std::string& scratch) {
+            Expect('"');
+            const char* start = p_;
+            const char* special = FindStringSpecial(p_, end_);
+            if (special < end_ && *special == '"') {
+                p_ = special + 1;
+                return std::string_view(start, special - start);
+            }
+            scratch.assign(start, special);
+            p_ = special;
+            for (;;) {
+                if (p_ >= end_) Fail("unterminated string");
+                char c = *p_;
+                if (c == '"') {
+                    ++p_;
+                    return scratch;
+                }
+                if (c != '\\') Fail("control character in string");
+                Unescape(scratch);
+                special = FindStringSpecial(p_, end_);
+                scratch.append(p_, special);
+                p_ = special;
+            }
+        }
+
+        int32_t Int32() {
+            bool quoted = Peek() == '"';
+            if (quoted) ++p_;
+            int32_t value = 0;
+            auto result = std::from_chars(p_, end_, value);
+            if (result.ec != std::errc()) Fail("expected an int32");
+            p_ = result.ptr;
+            if (quoted && (p_ >= end_ || *p_++ != '"')) Fail("unterminated number");
+            return value;
+        }
+
+        double Double() {
+            if (Peek() == '"') {
+                std::string_view text = String(value_scratch_);
+                if (text == "NaN") return std::numeric_limits<double>::quiet_NaN();
+                if (text == "Infinity") return std::numeric_limits<double>::infinity();
+                if (text == "-Infinity") return -std::numeric_limits<double>::infinity();
+                return ParseDouble(text.data(), text.data() + text.size(), true);
+            }
+            return ParseDouble(p_, end_, false);
+        }
+
+        int Enum(const EnumTable& table) {
+            if (Peek() != '"') return Int32();
+            int value = table.Find(String(value_scratch_));
+            if (value < 0) Fail("unknown enum name");
+            return value;
+        }
+
+        std::string& scratch() { return value_scratch_; }
+
+    private:
+        const char* begin_;
+        const char* p_;
+        const char* end_;
+        std::string key_scratch_;
+        std::string value_scratch_;
+
+        double ParseDouble(const char* first, const char* last, bool whole) {
+            if (first < last && *first != '-' && (*first < '0' || *first > '9')) Fail("expected a number");
+            double value = 0;
+            auto result = std::from_chars(first, last, value);
+            if (result.ec != std::errc() || (whole && result.ptr != last)) Fail("expected a number");
+            if (!whole) p_ = result.ptr;
+            return value;
+        }
+
+        unsigned Hex4() {
+            if (end_ - p_ < 4) Fail("truncated \\u escape");
+            unsigned value = 0;
+            for (int i = 0; i < 4; ++i) {
+                char c = *p_++;
+                value <<= 4;
+                if (c >= '0' && c <= '9') value |= c - '0';
+                else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+                else Fail("bad \\u escape");
+            }
+            return value;
+        }
+
+        void Unescape(std::string& out) {
+            if (end_ - p_ < 2) Fail("truncated escape");
+            char c = p_[1];
+            p_ += 2;
+            switch (c) {
+            case '"': out.push_back('"'); return;
+            case '\\': out.push_back('\\'); return;
+            case '/': out.push_back('/'); return;
+            case 'b': out.push_back('\b'); return;
+            case 'f': out.push_back('\f'); return;
+            case 'n': out.push_back('\n'); return;
+            case 'r': out.push_back('\r'); return;
+            case 't': out.push_back('\t'); return;
+            case 'u': break;
+            default: Fail("bad escape");
+            }
+            unsigned code = Hex4();
+            if (code >= 0xd800 && code < 0xdc00) {           // surrogate pair
+                if (end_ - p_ < 6 || p_[0] != '\\' || p_[1] != 'u') Fail("lone surrogate");
+                p_ += 2;
+                unsigned low = Hex4();
+                if (low < 0xdc00 || low >= 0xe000) Fail("lone surrogate");
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+            }
+            if (code < 0x80) {
+                out.push_back(static_cast<char>(code));
+            } else if (code < 0x800) {
+                out.push_back(static_cast<char>(0xc0 | (code >> 6)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            } else if (code < 0x10000) {
+                out.push_back(static_cast<char>(0xe0 | (code >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            } else {
+                out.push_back(static_cast<char>(0xf0 | (code >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            }
+        }
+    };
+
+    // Copies into a fixed TradeProto char array, always terminated
+    template <size_t N>
+    void CopyBounded(char (&target)[N], std::string_view value) {
+        size_t size = value.size() < N - 1 ? value.size() : N - 1;
+        std::memcpy(target, value.data(), size);
+        target[size] = '\0';
+    }
+
+    // Order / Balance fields, shared by both decoders
+    struct OrderFields {
+        int32_t id = 0;
+        std::string symbol;
+        int side = 0;
+        int type = 0;
+        double price = 0.0;
+        double volume = 0.0;
+    };
+
+    inline void ParseOrder(Reader& r, OrderFields& order) {
+        order = OrderFields();
+        r.Object([&](std::string_view key) {
+            if (r.Null()) return;
+            if (key == "id") order.id = r.Int32();
+            else if (key == "symbol") order.symbol = r.String(r.scratch());
+            else if (key == "side") order.side = r.Enum(OrderSides());
+            else if (key == "type") order.type = r.Enum(OrderTypes());
+            else if (key == "price") order.price = r.Double();
+            else if (key == "volume") order.volume = r.Double();
+            else r.Fail("unknown Order field");
+        });
+    }
+
+    inline void ParseBalance(Reader& r, std::string& currency, double& amount) {
+        currency.clear();
+        amount = 0.0;
+        r.Object([&](std::string_view key) {
+            if (r.Null()) return;
+            if (key == "currency") currency = r.String(r.scratch());
+            else if (key == "amount") amount = r.Double();
+            else r.Fail("unknown Balance field");
+        });
+    }
+
+} // namespace detail
+
+// Replaces the account with the JSON document. Symbol / Currency are cut to the TradeProto arrays.
+inline void ParseAccount(std::string_view json, TradeProto::Account& account) {
+    detail::Reader r(json);
+    detail::OrderFields order;
+    std::string currency;
+    account.Id = 0;
+    account.Name.clear();
+    account.Wallet = TradeProto::Balance("", 0.0);
+    account.Orders.clear();
+    r.Object([&](std::string_view key) {
+        if (r.Null()) return;
+        if (key == "id") {
+            account.Id = r.Int32();
+        } else if (key == "name") {
+            std::string_view name = r.String(r.scratch());
+            account.Name.assign(name.data(), name.size());
+        } else if (key == "wallet") {
+            detail::ParseBalance(r, currency, account.Wallet.Amount);
+            detail::CopyBounded(account.Wallet.Currency, currency);
+        } else if (key == "orders") {
+            r.Array([&]() {
+                detail::ParseOrder(r, order);
+                account.Orders.emplace_back();
+                TradeProto::Order& o = account.Orders.back();
+                o.Id = order.id;
+                detail::CopyBounded(o.Symbol, order.symbol);
+                o.Side = static_cast<TradeProto::OrderSide>(order.side);
+                o.Type = static_cast<TradeProto::OrderType>(order.type);
+                o.Price = order.price;
+                o.Volume = order.volume;
+            });
+        } else {
+            r.Fail("unknown Account field");
+        }
+    });
+    r.Finish();
+}
+
+// Builds the account into builder (not finished); strings keep their full length, including any
+// decoded \u0000
+inline flatbuffers::Offset<Trade::flatbuf::Account> ParseAccount(std::string_view json, flatbuffers::FlatBufferBuilder& builder) {
+    detail::Reader r(json);
+    detail::OrderFields order;
+    std::string name, currency;
+    int32_t id = 0;
+    flatbuffers::Offset<Trade::flatbuf::Balance> wallet = 0;
+    std::vector<flatbuffers::Offset<Trade::flatbuf::Order>> orders;
+    r.Object([&](std::string_view key) {
+        if (r.Null()) return;
+        if (key == "id") {
+            id = r.Int32();
+        } else if (key == "name") {
+            name = r.String(r.scratch());
+        } else if (key == "wallet") {
+            double amount;
+            detail::ParseBalance(r, currency, amount);
+            auto currency_offset = builder.CreateString(currency.data(), currency.size());
+            wallet = Trade::flatbuf::CreateBalance(builder, currency_offset, amount);
+        } else if (key == "orders") {
+            r.Array([&]() {
+                detail::ParseOrder(r, order);
+                auto symbol = builder.CreateString(order.symbol.data(), order.symbol.size());
+                orders.push_back(Trade::flatbuf::CreateOrder(builder, order.id, symbol,
+                    static_cast<Trade::flatbuf::OrderSide>(order.side), static_cast<Trade::flatbuf::OrderType>(order.type),
+                    order.price, order.volume));
+            });
+        } else {
+            r.Fail("unknown Account field");
+        }
+    });
+    r.Finish();
+    auto name_offset = builder.CreateString(name.data(), name.size());
+    auto orders_offset = builder.CreateVector(orders);
+    return Trade::flatbuf::CreateAccount(builder, id, name_offset, wallet, orders_offset);
+}
+
+} // namespace TradeJson
+
+#endif // TRADE_JSON_H
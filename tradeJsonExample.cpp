@@ -0,0 +1,85 @@
+#include "tradeJson.h"
+#include "tradeSampleData.h"
+
+#include <google/protobuf/util/json_util.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// TradeJson against protobuf's reflection-based JSON, encoding and decoding the same accounts
+namespace {
+
+using namespace TradeProto::SampleData;
+
+const int kAccounts = 10000;
+const int kRounds = 10;
+
+void Report(const char* name, double seconds, size_t bytes)
+{
+    std::cout << "  " << name << ": " << static_cast<int>(kAccounts / seconds) << " accounts/s, "
+              << static_cast<int>(bytes / seconds / 1e6) << " MB/s" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<TradeProto::Account> accounts = MakeAccounts(kAccounts, 20);
+
+    std::vector<Trade::protobuf::Account> messages(accounts.size());
+    for (size_t i = 0; i < accounts.size(); ++i)
+        accounts[i].Serialize(messages[i]);
+
+    std::vector<std::string> documents(accounts.size());
+    size_t bytes = 0;
+
+    std::cout << "Encode" << std::endl;
+    double protobuf_encode = Seconds([&]() {
+        bytes = 0;
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            documents[i].clear();
+            google::protobuf::util::MessageToJsonString(messages[i], &documents[i]);
+            bytes += documents[i].size();
+        }
+    }, kRounds);
+    Report("MessageToJsonString ", protobuf_encode, bytes);
+
+    double json_encode = Seconds([&]() {
+        bytes = 0;
+        for (size_t i = 0; i < accounts.size(); ++i)
+        {
+            documents[i].clear();
+            TradeJson::WriteAccount(accounts[i], documents[i]);
+            bytes += documents[i].size();
+        }
+    }, kRounds);
+    Report("TradeJson::WriteAccount", json_encode, bytes);
+
+    std::cout << "Decode" << std::endl;
+    Trade::protobuf::Account message;
+    double protobuf_decode = Seconds([&]() {
+        for (const auto& document : documents)
+        {
+            message.Clear();
+            google::protobuf::util::JsonStringToMessage(document, &message);
+        }
+    }, kRounds);
+    Report("JsonStringToMessage  ", protobuf_decode, bytes);
+
+    TradeProto::Account account;
+    double json_decode = Seconds([&]() {
+        for (const auto& document : documents)
+            TradeJson::ParseAccount(document, account);
+    }, kRounds);
+    Report("TradeJson::ParseAccount", json_decode, bytes);
+
+    std::cout << std::endl << "Speedup: encode x" << protobuf_encode / json_encode
+              << ", decode x" << protobuf_decode / json_decode << std::endl;
+    std::cout << "Sample: " << documents[0].substr(0, 200) << "..." << std::endl;
+
+    google::protobuf::ShutdownProtobufLibrary();
+
+    return 0;
+}
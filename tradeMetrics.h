@@ -0,0 +1,355 @@
+#ifndef TRADE_METRICS_H
+#define TRADE_METRICS_H
+
+/* Hot-path instrumentation for the TradeProto serialize/deserialize paths.
+
+Per (message, format, operation) it keeps call and byte counters, decode errors, allocations and
+an HDR-style latency histogram. Every thread owns its own counters, the hot path does plain
+relaxed load+store on them (no locked instructions, no sharing), and a dumper thread folds all
+threads together and writes the interval's numbers and percentiles to a file or a Unix socket.
+
+Everything is behind TRADE_METRICS_ENABLED. Without it the macros below expand to nothing and
+their arguments are not evaluated, so instrumented code compiles exactly as if they were not
+there.
+
+    TRADE_METRICS_SCOPE(t, Account, FlatBuffer, Deserialize);  // times until end of scope
+    TRADE_METRICS_BYTES(t, size, 0);                           // bytes in / bytes out of that call
+    TRADE_METRICS_ERROR(Account, Protobuf, Parse);
+    TRADE_METRICS_ALLOC(Account, FlatBuffer, Serialize, bytes);
+
+TradeProto::Account's Serialize and Deserialize (generatedfbsCode.cpp, protobufGeneratedCode.cpp) and
+the record decoders (recordPipeline.h) are instrumented. Builder allocations are counted by passing
+a TradeMetrics::CountingAllocator to the FlatBufferBuilder; it also keeps plain local counts, so it
+works with metrics compiled out. */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace TradeMetrics {
+
+enum class Message : uint8_t { Order, Balance, Account, Count };
+enum class Format : uint8_t { FlatBuffer, Protobuf, ProtobufC, Count };
+enum class Op : uint8_t { Serialize, Deserialize, Parse, Verify, Count };
+
+} // namespace TradeMetrics
+
+#ifdef TRADE_METRICS_ENABLED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace TradeMetrics {
+
+inline const char* Name(Message m) { static const char* n[] = { "Order", "Balance", "Account" }; return n[static_cast<int>(m)]; }
+inline const char* Name(Format f) { static const char* n[] = { "flatbuffer", "protobuf", "protobuf-c" }; return n[static_cast<int>(f)]; }
+inline const char* Name(Op o) { static const char* n[] = { "serialize", "deserialize", "parse", "verify" }; return n[static_cast<int>(o)]; }
+
+constexpr size_t kCells = static_cast<size_t>(Message::Count) * static_cast<size_t>(Format::Count) * static_cast<size_t>(Op::Count);
+
+inline size_t CellIndex(Message m, Format f, Op o) {
+    return (static_cast<size_t>(m) * static_cast<size_t>(Format::Count) + static_cast<size_t>(f)) * static_cast<size_t>(Op::Count) + static_cast<size_t>(o);
+}
+
+// Log-linear buckets: 8 linear sub-buckets per power of two, so any value is within 12.5%.
+// Values below 8ns are exact, everything from 2^41ns (~37 min) up lands in the last bucket
+namespace Buckets {
+    constexpr unsigned kSubBits = 3;
+    constexpr unsigned kSub = 1u << kSubBits;
+    constexpr unsigned kMaxMsb = 40;
+    constexpr size_t kCount = (kMaxMsb - kSubBits + 2) * kSub;
+
+    inline size_t Index(uint64_t v) {
+        if (v < kSub) return static_cast<size_t>(v);
+        unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        if (msb > kMaxMsb) return kCount - 1;
+        unsigned shift = msb - kSubBits;
+        return (shift + 1) * kSub + static_cast<size_t>(v >> shift) - kSub;
+    }
+
+    // Largest value that maps to the bucket
+    inline uint64_t UpperBound(size_t index) {
+        if (index < kSub) return index;
+        uint64_t shift = index / kSub - 1;
+        uint64_t sub = index % kSub + kSub;
+        return ((sub + 1) << shift) - 1;
+    }
+}
+
+// Single-writer counter: only the owning thread adds, the dumper only reads
+struct Counter {
+    std::atomic<uint64_t> value{ 0 };
+    void Add(uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    uint64_t Load() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct Cell {
+    Counter calls, bytes_in, bytes_out, errors, allocations, allocated_bytes;
+    Counter latency[Buckets::kCount];
+};
+
+// Plain copy of the cells, what the dumper works with
+struct Snapshot {
+    struct Values {
+        uint64_t calls = 0, bytes_in = 0, bytes_out = 0, errors = 0, allocations = 0, allocated_bytes = 0;
+        uint64_t latency[Buckets::kCount] = {};
+    };
+    std::vector<Values> cells = std::vector<Values>(kCells);
+
+    void Add(const Cell* source) {
+        for (size_t i = 0; i < kCells; ++i) {
+            const Cell& c = source[i];
+            if (c.calls.Load() == 0 && c.errors.Load() == 0 && c.allocations.Load() == 0) continue;
+            Values& v = cells[i];
+            v.calls += c.calls.Load();
+            v.bytes_in += c.bytes_in.Load();
+            v.bytes_out += c.bytes_out.Load();
+            v.errors += c.errors.Load();
+            v.allocations += c.allocations.Load();
+            v.allocated_bytes += c.allocated_bytes.Load();
+            for (size_t b = 0; b < Buckets::kCount; ++b) v.latency[b] += c.latency[b].Load();
+        }
+    }
+
+    // Value at quantile q (0..1) of a latency histogram, as its bucket's upper bound
+    static uint64_t Percentile(const uint64_t* latency, uint64_t total, double q) {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1, seen = 0;
+        for (size_t b = 0; b < Buckets::kCount; ++b)
+            if ((seen += latency[b]) >= rank) return Buckets::UpperBound(b);
+        return Buckets::UpperBound(Buckets::kCount - 1);
+    }
+};
+
+// All threads' cells. Threads register on first use and hand their cells back on exit
+class Registry {
+public:
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    Cell* Local() {
+        thread_local Holder holder(*this);
+        return holder.cells.get();
+    }
+
+    // Cumulative totals since start, live and exited threads alike
+    Snapshot Collect() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Snapshot s = retired_;
+        for (const auto& cells : live_) s.Add(cells.get());
+        return s;
+    }
+
+private:
+    struct Holder {
+        Registry& registry;
+        std::shared_ptr<Cell> cells;
+        explicit Holder(Registry& r) : registry(r), cells(new Cell[kCells], std::default_delete<Cell[]>()) {
+            std::lock_guard<std::mutex> lock(registry.mutex_);
+            registry.live_.push_back(cells);
+        }
+        ~Holder() {
+            std::lock_guard<std::mutex> lock(registry.mutex_);
+            registry.retired_.Add(cells.get());  // the exiting thread's numbers stay in the totals
+            for (auto it = registry.live_.begin(); it != registry.live_.end(); ++it)
+                if (*it == cells) { registry.live_.erase(it); break; }
+        }
+    };
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Cell>> live_;
+    Snapshot retired_;
+};
+
+inline Cell& LocalCell(Message m, Format f, Op o) { return Registry::Instance().Local()[CellIndex(m, f, o)]; }
+
+inline void RecordError(Message m, Format f, Op o) { LocalCell(m, f, o).errors.Add(1); }
+
+inline void RecordAllocation(Message m, Format f, Op o, uint64_t bytes) {
+    Cell& c = LocalCell(m, f, o);
+    c.allocations.Add(1);
+    c.allocated_bytes.Add(bytes);
+}
+
+// Times one call, records it when it goes out of scope
+class ScopedTimer {
+public:
+    ScopedTimer(Message m, Format f, Op o) : cell_(LocalCell(m, f, o)), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+        cell_.calls.Add(1);
+        cell_.bytes_in.Add(bytes_in_);
+        cell_.bytes_out.Add(bytes_out_);
+        cell_.latency[Buckets::Index(ns)].Add(1);
+    }
+    void Bytes(uint64_t in, uint64_t out) { bytes_in_ += in; bytes_out_ += out; }
+
+private:
+    Cell& cell_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t bytes_in_ = 0, bytes_out_ = 0;
+};
+
+// Periodically writes what happened since the previous dump, one line per active cell:
+//   <unix ms> <message> <format> <op> calls= bytes_in= bytes_out= errors= allocs= alloc_bytes= p50= p90= p99= p999= (ns)
+// target is a file path (appended to) or "unix:<path>" for a datagram Unix socket. Socket writes
+// never block; if nobody listens the interval is dropped
+class Dumper {
+public:
+    Dumper(const std::string& target, std::chrono::milliseconds interval) : interval_(interval) {
+        if (target.compare(0, 5, "unix:") == 0) {
+            fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            std::memset(&address_, 0, sizeof(address_));
+            address_.sun_family = AF_UNIX;
+            std::string path = target.substr(5);
+            if (path.size() >= sizeof(address_.sun_path)) throw std::runtime_error("Unix socket path too long: " + path);
+            std::memcpy(address_.sun_path, path.c_str(), path.size() + 1);
+            socket_ = true;
+        } else {
+            fd_ = ::open(target.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        }
+        if (fd_ < 0) throw std::runtime_error("Cannot open metrics target: " + target);
+        previous_ = Registry::Instance().Collect();
+        thread_ = std::thread([this] { Run(); });
+    }
+
+    ~Dumper() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+        Dump();  // last partial interval
+        ::close(fd_);
+    }
+
+    Dumper(const Dumper&) = delete;
+    Dumper& operator=(const Dumper&) = delete;
+
+    // Called by the dumper thread and by anyone who wants the numbers now
+    void Dump() {
+        std::lock_guard<std::mutex> lock(dump_mutex_);  // previous_ and the target are shared
+        Snapshot now = Registry::Instance().Collect();
+        uint64_t ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        std::string text;
+        uint64_t latency[Buckets::kCount];
+        char line[512];
+        for (size_t i = 0; i < kCells; ++i) {
+            const Snapshot::Values& a = now.cells[i];
+            const Snapshot::Values& b = previous_.cells[i];
+            uint64_t calls = a.calls - b.calls, errors = a.errors - b.errors, allocs = a.allocations - b.allocations;
+            if (calls == 0 && errors == 0 && allocs == 0) continue;
+            for (size_t k = 0; k < Buckets::kCount; ++k) latency[k] = a.latency[k] - b.latency[k];
+            size_t o = i % static_cast<size_t>(Op::Count), f = i / static_cast<size_t>(Op::Count) % static_cast<size_t>(Format::Count);
+            size_t m = i / (static_cast<size_t>(Op::Count) * static_cast<size_t>(Format::Count));
+            int n = std::snprintf(line, sizeof(line),
+                "%llu %s %s %s calls=%llu bytes_in=%llu bytes_out=%llu errors=%llu allocs=%llu alloc_bytes=%llu p50=%llu p90=%llu p99=%llu p999=%llu\n",
+                (unsigned long long)ms, Name(static_cast<Message>(m)), Name(static_cast<Format>(f)), Name(static_cast<Op>(o)),
+                (unsigned long long)calls, (unsigned long long)(a.bytes_in - b.bytes_in), (unsigned long long)(a.bytes_out - b.bytes_out),
+                (unsigned long long)errors, (unsigned long long)allocs, (unsigned long long)(a.allocated_bytes - b.allocated_bytes),
+                (unsigned long long)Snapshot::Percentile(latency, calls, 0.50), (unsigned long long)Snapshot::Percentile(latency, calls, 0.90),
+                (unsigned long long)Snapshot::Percentile(latency, calls, 0.99), (unsigned long long)Snapshot::Percentile(latency, calls, 0.999));
+            if (n > 0) text.append(line, std::min(static_cast<size_t>(n), sizeof(line) - 1));
+        }
+        previous_ = std::move(now);
+        if (text.empty()) return;
+        if (socket_)
+            ::sendto(fd_, text.data(), text.size(), MSG_DONTWAIT, reinterpret_cast<const sockaddr*>(&address_), sizeof(address_));
+        else if (::write(fd_, text.data(), text.size()) < 0)
+            return;  // metrics must never take the process down
+    }
+
+private:
+    std::chrono::milliseconds interval_;
+    int fd_ = -1;
+    bool socket_ = false;
+    sockaddr_un address_;
+    std::mutex dump_mutex_;
+    Snapshot previous_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread thread_;
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, interval_, [this] { return stop_; })) {
+            lock.unlock();
+            Dump();
+            lock.lock();
+        }
+    }
+};
+
+} // namespace TradeMetrics
+
+#define TRADE_METRICS_SCOPE(name, message, format, op) \
+    ::TradeMetrics::ScopedTimer name(::TradeMetrics::Message::message, ::TradeMetrics::Format::format, ::TradeMetrics::Op::op)
+#define TRADE_METRICS_BYTES(name, in, out) name.Bytes((in), (out))
+#define TRADE_METRICS_ERROR(message, format, op) \
+    ::TradeMetrics::RecordError(::TradeMetrics::Message::message, ::TradeMetrics::Format::format, ::TradeMetrics::Op::op)
+#define TRADE_METRICS_ALLOC(message, format, op, bytes) \
+    ::TradeMetrics::RecordAllocation(::TradeMetrics::Message::message, ::TradeMetrics::Format::format, ::TradeMetrics::Op::op, (bytes))
+
+#else
+
+#define TRADE_METRICS_SCOPE(name, message, format, op) static_assert(true, "")
+#define TRADE_METRICS_BYTES(name, in, out) ((void)0)
+#define TRADE_METRICS_ERROR(message, format, op) ((void)0)
+#define TRADE_METRICS_ALLOC(message, format, op, bytes) ((void)0)
+
+#endif // TRADE_METRICS_ENABLED
+
+namespace TradeMetrics {
+
+// FlatBufferBuilder allocator that counts its allocations, growth included (the default
+// reallocate_downward() allocates the bigger buffer through allocate()). With metrics enabled
+// they are also reported against Account / flatbuffer / serialize, the builders' root type
+class CountingAllocator : public flatbuffers::Allocator {
+public:
+    size_t allocations = 0;
+    size_t reallocations = 0;   // growth only
+    size_t allocated_bytes = 0;
+
+    uint8_t* allocate(size_t size) override {
+        ++allocations;
+        allocated_bytes += size;
+        TRADE_METRICS_ALLOC(Account, FlatBuffer, Serialize, size);
+        return base_.allocate(size);
+    }
+    void deallocate(uint8_t* p, size_t size) override { base_.deallocate(p, size); }
+    uint8_t* reallocate_downward(uint8_t* old_p, size_t old_size, size_t new_size,
+                                 size_t in_use_back, size_t in_use_front) override {
+        ++reallocations;
+        return flatbuffers::Allocator::reallocate_downward(old_p, old_size, new_size, in_use_back, in_use_front);
+    }
+
+    void Reset() { allocations = reallocations = allocated_bytes = 0; }
+
+private:
+    flatbuffers::DefaultAllocator base_;
+};
+
+} // namespace TradeMetrics
+
+#endif // TRADE_METRICS_H
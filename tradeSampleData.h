@@ -0,0 +1,90 @@
+#ifndef TRADE_SAMPLE_DATA_H
+#define TRADE_SAMPLE_DATA_H
+
+/* Sample accounts and timers shared by the *Example.cpp benchmarks, so they all measure the
+same data the same way.
+
+MakeAccounts() and MakeAccount() are deterministic (mt19937_64 seeded with 42): account i has
+id i + 1, a USD wallet and orders over five currency pairs with random side, type, price and
+volume. */
+
+#include "../proto/trade.h"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TradeProto {
+namespace SampleData {
+
+// Appends count orders with ids 1..count to account, drawn from rng
+inline void AddRandomOrders(Account& account, int count, std::mt19937_64& rng) {
+    static const char* const symbols[] = { "EURUSD", "GBPUSD", "USDJPY", "AUDUSD", "USDCHF" };
+    std::uniform_real_distribution<double> price(0.5, 150.0);
+    for (int j = 0; j < count; ++j)
+        account.Orders.emplace_back(j + 1, symbols[rng() % 5],
+            (rng() & 1) ? OrderSide::SELL : OrderSide::BUY,
+            static_cast<OrderType>(rng() % 3), price(rng), static_cast<double>(1 + rng() % 100) * 1000);
+}
+
+// count accounts with 1..max_orders orders each. With large_every > 0, every large_every-th
+// account (starting with the first) gets 2000..4999 orders instead
+inline std::vector<Account> MakeAccounts(int count, int max_orders = 40, int large_every = 0) {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> price(0.5, 150.0);
+    std::vector<Account> accounts;
+    accounts.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        accounts.emplace_back(i + 1, ("Account " + std::to_string(i)).c_str(), "USD", price(rng) * 1000);
+        int orders = (large_every > 0 && i % large_every == 0) ? 2000 + static_cast<int>(rng() % 3000)
+                                                               : 1 + static_cast<int>(rng() % max_orders);
+        AddRandomOrders(accounts.back(), orders, rng);
+    }
+    return accounts;
+}
+
+// One account with id 1 and exactly `orders` orders, drawn the same way
+inline Account MakeAccount(int orders) {
+    std::mt19937_64 rng(42);
+    Account account(1, "Account 0", "USD", 1000000);
+    AddRandomOrders(account, orders, rng);
+    return account;
+}
+
+// The same accounts as finished Trade::flatbuf::Account buffers
+inline std::vector<std::vector<uint8_t>> MakeAccountBuffers(int count, int max_orders = 40) {
+    std::vector<std::vector<uint8_t>> buffers;
+    buffers.reserve(count);
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<Account> accounts = MakeAccounts(count, max_orders);
+    for (Account& account : accounts) {
+        builder.Clear();
+        builder.Finish(account.Serialize(builder));
+        buffers.emplace_back(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+    }
+    return buffers;
+}
+
+// Wall time of one call of f
+template <typename F>
+double Milliseconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Average wall time of rounds calls of f
+template <typename F>
+double Seconds(F&& f, int rounds = 1) {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+        f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+} // namespace SampleData
+} // namespace TradeProto
+
+#endif // TRADE_SAMPLE_DATA_H
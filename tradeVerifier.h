@@ -0,0 +1,247 @@
+#ifndef TRADE_VERIFIER_H
+#define TRADE_VERIFIER_H
+
+/* Verifier for Trade::flatbuf::Account buffers (fbsSchema.fbs), specialized to the schema.
+
+flatbuffers::Verifier walks the buffer through generic Table::Verify calls, re-checking each
+table's vtable from scratch and going through the depth/complexity bookkeeping for every order.
+AccountVerifier accepts exactly the same buffers as Trade::flatbuf::VerifyAccountBuffer (same
+alignment, bounds, offset sign, string terminator and table count rules). It gets there in one
+straight pass:
+
+  - the vtable slots are the VT_ constants of trade_generated.h, known at compile time;
+  - the Account's wallet and orders are checked inline, no recursion;
+  - the builder deduplicates vtables, so orders usually all point at the same one. An order
+    whose vtable is the one the previous order used skips the vtable checks and reuses the
+    field offsets read from it; what is left per order is the table bounds, the present
+    fields and the symbol string.
+
+VerifyAccountBatch() verifies many buffers at once over a ThreadPool, for ingest paths that
+receive records in batches.
+
+Usage:
+    if (TradeProto::VerifyAccountBuffer(data, size) != TradeProto::VerifyError::None) reject();
+    const Trade::flatbuf::Account* account = Trade::flatbuf::GetAccount(data);
+*/
+
+#include "flatbuffers/trade_generated.h"
+#include "recordFile.h"
+#include "threadPool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TradeProto {
+
+enum class VerifyError : uint8_t {
+    None,
+    BufferSize,     // too small for a root offset, or over the 2 GB FlatBuffers limit
+    Offset,         // misaligned, zero, negative or out of bounds offset
+    Table,          // table or vtable out of bounds or misaligned
+    Field,          // scalar field out of bounds or misaligned
+    String,         // string out of bounds or not zero terminated
+    Vector,         // orders vector out of bounds
+    TooManyTables,  // over flatbuffers::Verifier's default max_tables
+    Format          // not a FlatBuffer record (batch mode over RecordRefs)
+};
+
+inline const char* VerifyErrorName(VerifyError error) {
+    static const char* const names[] = { "none", "buffer size", "offset", "table", "field", "string", "vector", "too many tables", "format" };
+    return names[static_cast<size_t>(error)];
+}
+
+class AccountVerifier {
+public:
+    static constexpr uint64_t kMaxBufferSize = 0x7FFFFFFF;  // FLATBUFFERS_MAX_BUFFER_SIZE
+    static constexpr uint64_t kMaxTables = 1000000;         // flatbuffers::Verifier default
+
+    AccountVerifier(const uint8_t* data, size_t size) : buf_(data), size_(size) {}
+
+    VerifyError Verify() {
+        if (size_ >= kMaxBufferSize) return VerifyError::BufferSize;
+        uint64_t root;
+        if (!In(0, sizeof(uint32_t))) return VerifyError::BufferSize;
+        if (!Offset(0, root)) return VerifyError::Offset;
+        return Account(root);
+    }
+
+private:
+    using A = Trade::flatbuf::Account;
+    using B = Trade::flatbuf::Balance;
+    using O = Trade::flatbuf::Order;
+
+    struct VTable {
+        uint64_t at = ~uint64_t(0);
+        uint16_t size = 0;
+    };
+
+    // Field offsets of one Order vtable, indexed by (VT_ - 4) / 2
+    struct OrderLayout {
+        uint64_t vtable = ~uint64_t(0);
+        uint16_t field[6] = {};
+    };
+
+    const uint8_t* buf_;
+    uint64_t size_;
+    uint64_t tables_ = 0;
+
+    template <typename T>
+    T Read(uint64_t at) const { return flatbuffers::ReadScalar<T>(buf_ + at); }
+
+    // Verifier::Verify(elem, len): note the strict len < size
+    bool In(uint64_t elem, uint64_t len) const { return len < size_ && elem <= size_ - len; }
+    static bool Aligned(uint64_t elem, uint64_t align) { return (elem & (align - 1)) == 0; }
+
+    // Verifier::VerifyOffset
+    bool Offset(uint64_t at, uint64_t& target) const {
+        if (!Aligned(at, sizeof(uint32_t)) || !In(at, sizeof(uint32_t))) return false;
+        uint32_t o = Read<uint32_t>(at);
+        if (o == 0 || static_cast<int32_t>(o) < 0 || !In(at + o, 1)) return false;
+        target = at + o;
+        return true;
+    }
+
+    // Table::VerifyTableStart
+    VerifyError TableStart(uint64_t table, VTable& vtable) {
+        if (!Aligned(table, sizeof(int32_t)) || !In(table, sizeof(int32_t))) return VerifyError::Table;
+        if (++tables_ > kMaxTables) return VerifyError::TooManyTables;
+        int64_t at = static_cast<int64_t>(table) - Read<int32_t>(table);
+        if (at < 0) return VerifyError::Table;
+        return VTableAt(static_cast<uint64_t>(at), vtable);
+    }
+
+    VerifyError VTableAt(uint64_t at, VTable& vtable) const {
+        if (!Aligned(at, sizeof(uint16_t)) || !In(at, sizeof(uint16_t))) return VerifyError::Table;
+        uint16_t size = Read<uint16_t>(at);
+        if (!Aligned(size, sizeof(uint16_t)) || !In(at, size)) return VerifyError::Table;
+        vtable.at = at;
+        vtable.size = size;
+        return VerifyError::None;
+    }
+
+    uint16_t FieldOffset(const VTable& vtable, uint16_t field) const {
+        return field < vtable.size ? Read<uint16_t>(vtable.at + field) : 0;
+    }
+
+    bool Scalar(uint64_t table, uint16_t offset, uint64_t size) const {
+        return offset == 0 || (Aligned(table + offset, size) && In(table + offset, size));
+    }
+
+    // Verifier::VerifyString; an absent string (offset 0) is fine
+    VerifyError String(uint64_t table, uint16_t offset) const {
+        if (offset == 0) return VerifyError::None;
+        uint64_t at;
+        if (!Offset(table + offset, at)) return VerifyError::Offset;
+        if (!Aligned(at, sizeof(uint32_t)) || !In(at, sizeof(uint32_t))) return VerifyError::String;
+        uint64_t length = Read<uint32_t>(at);
+        if (length >= kMaxBufferSize) return VerifyError::String;
+        uint64_t end = at + sizeof(uint32_t) + length;
+        if (!In(at, sizeof(uint32_t) + length) || !In(end, 1) || buf_[end] != 0) return VerifyError::String;
+        return VerifyError::None;
+    }
+
+    VerifyError Balance(uint64_t table) {
+        VTable vtable;
+        VerifyError error = TableStart(table, vtable);
+        if (error != VerifyError::None) return error;
+        error = String(table, FieldOffset(vtable, B::VT_CURRENCY));
+        if (error != VerifyError::None) return error;
+        if (!Scalar(table, FieldOffset(vtable, B::VT_AMOUNT), sizeof(double))) return VerifyError::Field;
+        return VerifyError::None;
+    }
+
+    VerifyError Order(uint64_t table, OrderLayout& layout) {
+        if (!Aligned(table, sizeof(int32_t)) || !In(table, sizeof(int32_t))) return VerifyError::Table;
+        if (++tables_ > kMaxTables) return VerifyError::TooManyTables;
+        int64_t at = static_cast<int64_t>(table) - Read<int32_t>(table);
+        if (at < 0) return VerifyError::Table;
+        if (static_cast<uint64_t>(at) != layout.vtable) {
+            // A vtable not seen yet: validate it once and remember where the fields are
+            VTable vtable;
+            VerifyError error = VTableAt(static_cast<uint64_t>(at), vtable);
+            if (error != VerifyError::None) return error;
+            layout.vtable = vtable.at;
+            for (uint16_t i = 0; i < 6; ++i)
+                layout.field[i] = FieldOffset(vtable, static_cast<uint16_t>(O::VT_ID + 2 * i));
+        }
+        const uint16_t* field = layout.field;
+        if (!Scalar(table, field[(O::VT_ID - 4) / 2], sizeof(int32_t))) return VerifyError::Field;
+        VerifyError error = String(table, field[(O::VT_SYMBOL - 4) / 2]);
+        if (error != VerifyError::None) return error;
+        if (!Scalar(table, field[(O::VT_SIDE - 4) / 2], sizeof(int8_t)) || !Scalar(table, field[(O::VT_TYPE - 4) / 2], sizeof(int8_t))
+            || !Scalar(table, field[(O::VT_PRICE - 4) / 2], sizeof(double)) || !Scalar(table, field[(O::VT_VOLUME - 4) / 2], sizeof(double)))
+            return VerifyError::Field;
+        return VerifyError::None;
+    }
+
+    VerifyError Account(uint64_t table) {
+        VTable vtable;
+        VerifyError error = TableStart(table, vtable);
+        if (error != VerifyError::None) return error;
+        if (!Scalar(table, FieldOffset(vtable, A::VT_ID), sizeof(int32_t))) return VerifyError::Field;
+        error = String(table, FieldOffset(vtable, A::VT_NAME));
+        if (error != VerifyError::None) return error;
+
+        uint16_t wallet = FieldOffset(vtable, A::VT_WALLET);
+        if (wallet) {
+            uint64_t at;
+            if (!Offset(table + wallet, at)) return VerifyError::Offset;
+            error = Balance(at);
+            if (error != VerifyError::None) return error;
+        }
+
+        uint16_t orders = FieldOffset(vtable, A::VT_ORDERS);
+        if (!orders) return VerifyError::None;
+        uint64_t vector;
+        if (!Offset(table + orders, vector)) return VerifyError::Offset;
+        if (!Aligned(vector, sizeof(uint32_t)) || !In(vector, sizeof(uint32_t))) return VerifyError::Vector;
+        uint64_t count = Read<uint32_t>(vector);
+        if (count >= kMaxBufferSize / sizeof(uint32_t) || !In(vector, sizeof(uint32_t) + count * sizeof(uint32_t))) return VerifyError::Vector;
+        OrderLayout layout;
+        for (uint64_t i = 0, at = vector + sizeof(uint32_t); i < count; ++i, at += sizeof(uint32_t)) {
+            error = Order(at + Read<uint32_t>(at), layout);  // element offsets are followed unchecked, like Vector::Get()
+            if (error != VerifyError::None) return error;
+        }
+        return VerifyError::None;
+    }
+};
+
+// Drop-in for Trade::flatbuf::VerifyAccountBuffer(flatbuffers::Verifier(data, size))
+inline VerifyError VerifyAccountBuffer(const uint8_t* data, size_t size) {
+    return AccountVerifier(data, size).Verify();
+}
+
+// Verifies count buffers over pool; errors[i] is buffer i's result. Returns how many are valid
+inline size_t VerifyAccountBatch(const uint8_t* const* data, const size_t* sizes, size_t count,
+                                 VerifyError* errors, ThreadPool& pool) {
+    std::atomic<size_t> valid{ 0 };
+    pool.ParallelFor(count, [&](size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t i = begin; i < end; ++i)
+            local += (errors[i] = VerifyAccountBuffer(data[i], sizes[i])) == VerifyError::None;
+        valid.fetch_add(local, std::memory_order_relaxed);
+    });
+    return valid.load();
+}
+
+// Same over records of a record file; records of other formats get VerifyError::Format
+inline size_t VerifyAccountBatch(const std::vector<RecordRef>& records, std::vector<VerifyError>& errors, ThreadPool& pool) {
+    errors.resize(records.size());
+    std::atomic<size_t> valid{ 0 };
+    pool.ParallelFor(records.size(), [&](size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const RecordRef& record = records[i];
+            errors[i] = record.format == RecordFormat::FlatBuffer ? VerifyAccountBuffer(record.data, record.size) : VerifyError::Format;
+            local += errors[i] == VerifyError::None;
+        }
+        valid.fetch_add(local, std::memory_order_relaxed);
+    });
+    return valid.load();
+}
+
+}
+
+#endif
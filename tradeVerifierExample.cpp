@@ -0,0 +1,146 @@
+#include "../proto/trade.h"
+#include "tradeSampleData.h"
+#include "tradeVerifier.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cost of verifying FlatBuffers Accounts before use: the generic flatbuffers::Verifier against
+// TradeProto::AccountVerifier, both next to the cost of reading every field once, and batch
+// verification over a ThreadPool
+namespace {
+
+using namespace TradeProto::SampleData;
+
+const int kAccounts = 100000;
+const size_t kMutated = 200;  // buffers the differential check derives mutants from
+const int kCorruptions = 500; // corrupted copies per buffer, on top of every truncation
+
+// Both verifiers on one candidate buffer; true when they agree
+bool SameVerdict(const std::vector<uint8_t>& buffer)
+{
+    flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+    bool generic = Trade::flatbuf::VerifyAccountBuffer(verifier);
+    bool specialized = TradeProto::VerifyAccountBuffer(buffer.data(), buffer.size()) == TradeProto::VerifyError::None;
+    return generic == specialized;
+}
+
+// AccountVerifier claims to accept exactly what flatbuffers::Verifier accepts. Checks that on
+// mutants of the first kMutated buffers: every truncation, random byte changes, and random values
+// written over aligned 32 bit words (where offsets and lengths live). Returns the disagreements
+size_t DifferentialCheck(const std::vector<std::vector<uint8_t>>& buffers, size_t& mutants)
+{
+    std::mt19937_64 rng(7);
+    std::vector<uint8_t> mutant;
+    size_t disagreements = 0;
+    for (size_t b = 0; b < std::min(kMutated, buffers.size()); ++b)
+    {
+        const std::vector<uint8_t>& buffer = buffers[b];
+        for (size_t length = 0; length < buffer.size(); ++length)
+        {
+            mutant.assign(buffer.begin(), buffer.begin() + length);  // a copy, so reads past the end are caught
+            disagreements += !SameVerdict(mutant);
+            ++mutants;
+        }
+        if (buffer.size() < sizeof(uint32_t))
+            continue;
+        for (int i = 0; i < kCorruptions; ++i)
+        {
+            mutant = buffer;
+            if (i % 2 == 0)
+            {
+                for (int k = 1 + static_cast<int>(rng() % 3); k > 0; --k)
+                    mutant[rng() % mutant.size()] = static_cast<uint8_t>(rng());
+            }
+            else
+            {
+                // Small values land inside the buffer, the interesting case for offsets
+                uint32_t value = (rng() & 1) ? static_cast<uint32_t>(rng() % (mutant.size() + 16)) : static_cast<uint32_t>(rng());
+                size_t at = rng() % (mutant.size() / sizeof(uint32_t)) * sizeof(uint32_t);
+                std::memcpy(mutant.data() + at, &value, sizeof(value));
+            }
+            disagreements += !SameVerdict(mutant);
+            ++mutants;
+        }
+    }
+    return disagreements;
+}
+
+// Touches every field, the least any consumer of the buffer does after verifying it
+double ReadFields(const Trade::flatbuf::Account& account)
+{
+    double sum = account.id() + account.name()->size() + account.wallet()->currency()->size() + account.wallet()->amount();
+    for (const auto* order : *account.orders())
+        sum += order->id() + order->symbol()->size() + static_cast<int>(order->side()) + static_cast<int>(order->type())
+            + order->price() + order->volume();
+    return sum;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::vector<uint8_t>> buffers = MakeAccountBuffers(kAccounts);
+    size_t bytes = 0;
+    for (const auto& buffer : buffers)
+        bytes += buffer.size();
+
+    size_t valid = 0;
+    double generic = Milliseconds([&]() {
+        valid = 0;
+        for (const auto& buffer : buffers)
+        {
+            flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+            valid += Trade::flatbuf::VerifyAccountBuffer(verifier);
+        }
+    });
+    if (valid != buffers.size()) throw std::runtime_error("Generic verifier rejected a buffer");
+
+    double specialized = Milliseconds([&]() {
+        valid = 0;
+        for (const auto& buffer : buffers)
+            valid += TradeProto::VerifyAccountBuffer(buffer.data(), buffer.size()) == TradeProto::VerifyError::None;
+    });
+    if (valid != buffers.size()) throw std::runtime_error("AccountVerifier rejected a buffer");
+
+    size_t mutants = 0;
+    size_t disagreements = DifferentialCheck(buffers, mutants);
+    if (disagreements != 0)
+        throw std::runtime_error("AccountVerifier and flatbuffers::Verifier disagree on " + std::to_string(disagreements) + " mutants");
+
+    double sum = 0;
+    double read = Milliseconds([&]() {
+        for (const auto& buffer : buffers)
+            sum += ReadFields(*Trade::flatbuf::GetAccount(buffer.data()));
+    });
+
+    std::vector<const uint8_t*> data;
+    std::vector<size_t> sizes;
+    for (const auto& buffer : buffers)
+    {
+        data.push_back(buffer.data());
+        sizes.push_back(buffer.size());
+    }
+    std::vector<TradeProto::VerifyError> errors(buffers.size());
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    double batch = Milliseconds([&]() {
+        valid = TradeProto::VerifyAccountBatch(data.data(), sizes.data(), data.size(), errors.data(), pool);
+    });
+    if (valid != buffers.size()) throw std::runtime_error("Batch verification rejected a buffer");
+
+    std::cout << "Verifying " << kAccounts << " accounts, " << bytes / 1024 << " KB" << std::endl;
+    std::cout << "  flatbuffers::Verifier:     " << generic << " ms" << std::endl;
+    std::cout << "  AccountVerifier:           " << specialized << " ms (x" << generic / specialized << ")" << std::endl;
+    std::cout << "  Reading every field:       " << read << " ms (verify / read " << specialized / read << ")" << std::endl;
+    std::cout << "  VerifyAccountBatch (" << std::max(1u, std::thread::hardware_concurrency()) << " threads): "
+              << batch << " ms (x" << specialized / batch << ")" << std::endl;
+    std::cout << "  Differential check: " << mutants << " mutants, both verifiers agree on all" << std::endl;
+    std::cout << "  (checksum " << sum << ")" << std::endl;
+
+    return 0;
+}